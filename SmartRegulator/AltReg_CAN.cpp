@@ -29,6 +29,7 @@
 #include "Types.h"
 #include "Sensors.h"
 #include "Flash.h"
+#include "AltReg_Serial.h"
 
 
 
@@ -49,10 +50,10 @@ CCS canConfig = {
 
 
 uint8_t         batteryInstance;                                        // What is the CAN Battery Instance we are associated with?  
-float           CAN_RBM_amps;                                           // Remote instrumentation of the battery
+long            CAN_RBM_mAmps;                                          // Remote instrumentation of the battery, in mA as sent on the wire
 unsigned long   CAN_RBM_ampsRefreshed;                                  // Time (millis) when all the Remote Battery current was received.
-float           CAN_RBM_volts;
-float           CAN_RBM_voltsOffset;                                    // Snapshot copy of measuredAltVolts at the time the remote battery voltage was received.
+long            CAN_RBM_mVolts;                                         // .. and its voltage in mV
+long            CAN_RBM_mVoltsOffset;                                   // Remote battery voltage less measuredAltVolts at the time the remote battery voltage was received (mV).
 int             CAN_RBM_voPWMvalue;                                     // Snapshot of PWM value at time the remote voltage was received.  (Used to adjust the offset voltage based on changes in alternator output)
 uint16_t        CAN_RBM_dVdT;                                           // in mV/S
 unsigned long   CAN_RBM_voltsRefreshed;                                 // Time (millis) when all the Remote Battery Voltage was received.
@@ -66,8 +67,8 @@ float           CAN_RAT2000_amps;                                       // What
 int             CAN_RAT2000_temp;                                       // And temperature?
                                                                      
 
-float           CAN_RBM_desiredVolts;                                   // Master coordinated charge points we are to follow.
-float           CAN_RBM_desiredAmps;
+long            CAN_RBM_desired_mVolts;                                 // Master coordinated charge points we are to follow (mV and mA)
+long            CAN_RBM_desired_mAmps;
 tRVCBatChrgMode CAN_RBM_desiredChargeState;                             // What mode does the remote master want us to use?  If 'undefined', they are only sending status (Volts, amps, temp).
 uint8_t         CAN_RBM_sourceID;                                       // Who is it we think is our CAN Master?   Will = 0 if we are not currently linked to anyone valid.
 bool            CAN_weAreRBM     = false;                               // Is it us??
@@ -79,6 +80,8 @@ unsigned long  CAN_HPUUCS_lastReceived = 0UL;                           // And l
 int            average_EPC_utilization;                                 // Noted average utilization of all of equal priority charging sourced on the same battery
 
 uint8_t CAN_ASCII_source = 0;                                           // If we are receiving ASCII characters via the CAN, this is the ID of who sent them. (0 = No one is sending us anything)
+uint16_t CAN_ASCII_txDrops = 0;                                         // Count of characters lost because the CAN Terminal Tx buffer was full.
+uint16_t CAN_ASCII_rxOverruns = 0;                                      // .. and those lost because the Rx buffer was full.
                                                                          
 
 
@@ -90,25 +93,39 @@ uint8_t CAN_ASCII_source = 0;                                           // If we
  uint8_t       CAN_RBM_devicePriority;                                  // How 'smart' is the master we are linked with? (0 = not very, need to look for someone smarter)
  unsigned char SID;                                                     // SID to 'align' different NMEA messages.  Incremented each time N2kDCStatus_message() is sent out.
 
-#define SBSZ  32                                                                                                                // 32 byte 'bit' arrays 
-                                                                        // Two bit flag table to coordinate 'Charger Status' and 'Charger Status2' PGNs.
-uint8_t        chargerSBHP[SBSZ];                                       // Bit = 1 --> CAN address is on same DC_SOURCE as us, and Higher priority.
-uint8_t        chargerSBEP[SBSZ];                                       // Bit = 1 --> CAN address is on same DC_SOURCE as us, and Equal priority.
-uint8_t        chargerSBLP[SBSZ];                                       // Bit = 1 --> CAN address is on same DC_SOURCE as us, and Lower priority.
-                                                                        // Caution:  Make these three tables the SAME SIZE - see: reset_BIT_arrarys()
+#define SBSZ  ADDR_SET_BYTES                                                                                                    // 32 byte 'bit' arrays 
+                                                                        // Bit flag tables to coordinate 'Charger Status' and 'Charger Status2' PGNs.
+tAddrSet       chargerSBHP;                                             // Bit = 1 --> CAN address is on same DC_SOURCE as us, and Higher priority.
+tAddrSet       chargerSBEP;                                             // Bit = 1 --> CAN address is on same DC_SOURCE as us, and Equal priority.
+tAddrSet       chargerSBLP;                                             // Bit = 1 --> CAN address is on same DC_SOURCE as us, and Lower priority.
+                                                                        // (Each keeps a count of its members, so 'is anyone there?' needs no scan)
+uint8_t        chargerSeen[SBSZ];                                       // Bit = 1 --> Have had a Charger Status2 from this address since its byte was last aged.  If not, it is dropped from the tables above.
+uint8_t        chargerAgeIndex;                                         // Next byte of the tables age_BIT_arrays() will look at,
+unsigned long  chargerAgeLast;                                          //  and when it last looked at one.
                                                                         // (I HATE needing to use these table, but - RV-C spec has some holes where it does not provide clear linkage....)
                                                                         // (NMEA-2000 is much worst, and I am not going to try and fill them --  see forced_CAN_ID for one of the workarouds...)
                                                                         
 
 
     //-- Queues to hold the J1939 - TERMIANAL sending and receiving characters.
-#define cASCII_RX_BUFFER_SIZE  9                                        // Am using simple FiFo which has roaming 'unused' spot - trades off one byte of RAM for simpler code size.
+#define cASCII_RX_BUFFER_SIZE  64                                       // Room for the longest command (INBOUND_BUFF_SIZE) arriving between loop() passes.  Power of 2, indexes wrap by masking.
+                                                                        // Am using simple FiFo which has roaming 'unused' spot - trades off one byte of RAM for simpler code size.
+#define cASCII_XON              0x11                                    // Flow control characters sent back to the Terminal sender if CAN_ASCII_FLOW_CONTROL is defined.
+#define cASCII_XOFF             0x13
 #define cASCII_TX_BUFFER_SIZE  500                                      // Large enough to hold all status strings at one time..
+#define cASCII_TX_PERIOD        50                                      // RVCTerminal_message() is called every 50mS (see CANHandlers[]),
+#define cASCII_BUS_LOAD_MAX     10                                      //  and may use up to this % of the bus:
+#define cASCII_TX_FRAMES_MAX   ((cASCII_TX_PERIOD * 1000UL * cASCII_BUS_LOAD_MAX / 100) / CAN_FRAME_BUS_TIME)
+                                                                        //  9 8-character frames each time = 1440 chars/sec.
+#define cASCII_TX_FRAMES_RESERVE (2 * CAN_SEND_FRAME_BUDGET)            // Fewer if the NMEA2000 send buffer is filling, always leaving this much room in it for our other messages.
 
-uint8_t    _rx_buffer_head = 0;                                         //  We expect to only recevie (and have to deal with) 8 up to 8 characters at a time...
+uint8_t    _rx_buffer_head = 0;                                         //  Filled 8 characters at a time by RVCTerminal_handler(), drained by fill_ib_buffer().
 uint8_t    _rx_buffer_tail = 0;
+bool       _rx_xoff        = false;                                     // Have we asked the sender to pause?
 uint16_t   _tx_buffer_head = 0;                                         // Sending buffer however can be rather large, esp when user asked for all-status strings!
 uint16_t   _tx_buffer_tail = 0;
+uint8_t    _tx_dest        = 0;                                         // Who the characters in the Tx buffer are going to (CAN_ASCII_source is cleared once a reply is complete).
+uint8_t    _flow_dest      = 0;                                         // Who we asked to pause, so the XON goes back to them (the same way).
 
 char        _cASCII_rx_buffer[cASCII_RX_BUFFER_SIZE];
 char        _cASCII_tx_buffer[cASCII_TX_BUFFER_SIZE];
@@ -125,6 +142,7 @@ char        _cASCII_tx_buffer[cASCII_TX_BUFFER_SIZE];
         void         (*Transmitter)(void);
         unsigned int  transPeriod;                                                   // 'Normal' transmission time in mS between messages
         bool          sentThisPeriod;                                                // Has a message been sent this 'period' already, has it already had its turn? 
+        unsigned int  maxLatency;                                                    // Longest time (mS) this message has waited between falling due and being sent.
         } tCANHandlers;
 
     void N2kDCBatStatus_handler(const tN2kMsg &N2kMsg);
@@ -165,40 +183,47 @@ char        _cASCII_tx_buffer[cASCII_TX_BUFFER_SIZE];
             
     tCANHandlers CANHandlers[]={
         #ifdef SUPPORT_NMEA2000 
-        {127506L,NULL,                  &N2kDCStatus_message,      667,false},
-        {127508L,&N2kDCBatStatus_handler,&N2kDCBatStatus_message,  667,false},
-        {127513L,NULL,                  &N2kBatConf_message,         0,false},
+        {127506L,NULL,                  &N2kDCStatus_message,      667,false,0},
+        {127508L,&N2kDCBatStatus_handler,&N2kDCBatStatus_message,  667,false,0},
+        {127513L,NULL,                  &N2kBatConf_message,         0,false,0},
         #endif
         #ifdef SUPPORT_RVC                                        
-        {0x1FFFD,&RVCDCStatus1_handler, &RVCDCStatus1_message,     500,false},
-        {0x1FFFD, NULL,                 &RVCDCStatus1OA_message,   100,false},
-        {0x1FFFC,&RVCDCStatus2_handler, &RVCDCStatus2_message,     500,false},
-        {0x1FEC9,&RVCDCStatus4_handler, &RVCDCStatus4_message,    5000,false},
-        {0x1FEC8,&RVCDCStatus5_handler, &RVCDCStatus5_message,     500,false},
-        {0x1FEC8, NULL,                 &RVCDCStatus5OV_message,   100,false},         // Special instance, called every 100mS when over voltage.
-        {0x1FEC7,&RVCDCStatus6_handler,           NULL,              0,false},
-        {0x1FED0,&RVCDCDisconnectStatus_handler,  NULL,              0,false},
-        {0x1FECF,&RVCDCDisconnectCommand_handler, NULL,              0,false},
-        {0x1FFC7,&RVCChrgStat_handler,  &RVCChrgStat_message,     5000,false},
-        {0x1FF9D,&RVCChrgStat2_handler, &RVCChrgStat2_message,     500,false},         /*  PROPOSED!!!  USING TEMP PGN# */
-        {0x1FFC6,&sendNAK_handler,      &RVCChrgConfig_message,      0,false},         // For now we do not allow CPE configuration via the RVC protocol.
-        {0x1FF96,&sendNAK_handler,      &RVCChrgConfig2_message,     0,false},
-        {0x1FECC,&sendNAK_handler,      &RVCChrgConfig3_message,     0,false},
-        {0x1FEBF,&sendNAK_handler,      &RVCChrgConfig4_message,     0,false},
-        {0x1FF99, NULL,                 &RVCChrgEqualStat_message,5000,false},
-        {0x1FF98,&sendNAK_handler,      &RVCChrgEqualConfig_message, 0,false},
-        {0xFEEB,  NULL,                 &RVCProdId_message,          0,false},
-        {0x17E00,&RVCTerminal_handler,  &RVCTerminal_message,       50,false},        // Terminal handler called every 50mS to send out 'Next portion' of string.
+        {0x1FFFD,&RVCDCStatus1_handler, &RVCDCStatus1_message,     500,false,0},
+        {0x1FFFD, NULL,                 &RVCDCStatus1OA_message,   100,false,0},
+        {0x1FFFC,&RVCDCStatus2_handler, &RVCDCStatus2_message,     500,false,0},
+        {0x1FEC9,&RVCDCStatus4_handler, &RVCDCStatus4_message,    5000,false,0},
+        {0x1FEC8,&RVCDCStatus5_handler, &RVCDCStatus5_message,     500,false,0},
+        {0x1FEC8, NULL,                 &RVCDCStatus5OV_message,   100,false,0},       // Special instance, called every 100mS when over voltage.
+        {0x1FEC7,&RVCDCStatus6_handler,           NULL,              0,false,0},
+        {0x1FED0,&RVCDCDisconnectStatus_handler,  NULL,              0,false,0},
+        {0x1FECF,&RVCDCDisconnectCommand_handler, NULL,              0,false,0},
+        {0x1FFC7,&RVCChrgStat_handler,  &RVCChrgStat_message,     5000,false,0},
+        {0x1FF9D,&RVCChrgStat2_handler, &RVCChrgStat2_message,     500,false,0},       /*  PROPOSED!!!  USING TEMP PGN# */
+        {0x1FFC6,&sendNAK_handler,      &RVCChrgConfig_message,      0,false,0},       // For now we do not allow CPE configuration via the RVC protocol.
+        {0x1FF96,&sendNAK_handler,      &RVCChrgConfig2_message,     0,false,0},
+        {0x1FECC,&sendNAK_handler,      &RVCChrgConfig3_message,     0,false,0},
+        {0x1FEBF,&sendNAK_handler,      &RVCChrgConfig4_message,     0,false,0},
+        {0x1FF99, NULL,                 &RVCChrgEqualStat_message,5000,false,0},
+        {0x1FF98,&sendNAK_handler,      &RVCChrgEqualConfig_message, 0,false,0},
+        {0xFEEB,  NULL,                 &RVCProdId_message,          0,false,0},
+        {0x17E00,&RVCTerminal_handler,  &RVCTerminal_message,       50,false,0},      // Terminal handler called every 50mS to send out 'Next portion' of string.
         #endif
             // J1939 type messages we need to handle.
-        {0x1FECA, NULL,                 &ISODiagnostics_message,  5000,false},
-        {0x1FECA, NULL,                 &ISODiagnosticsER_message,1000,false},        // Special instance, sent out more often during fault condition.
+        {0x1FECA, NULL,                 &ISODiagnostics_message,  5000,false,0},
+        {0x1FECA, NULL,                 &ISODiagnosticsER_message,1000,false,0},      // Special instance, sent out more often during fault condition.
         
-        {0,NULL,NULL,0,false}                                                         // ----PGN of 0 indicates end of table----
+        {0,NULL,NULL,0,false,0}                                                       // ----PGN of 0 indicates end of table----
         };
-              // Note:  send_CAN() scans this table from the beginning each time looking for the next message who has timed out and is ready to be sent.
-              //        As such, this table becomes a priority order for CAN messages.  be careful placing a very low time period message early in the table
-              //        as that may cause that one message to dominate transmissions - preventing later entries from being serviced.
+              // Note:  send_CAN() scans this table from the beginning each time, sending every message who has timed out and is ready to be sent - up to
+              //        the CAN_SEND_FRAME_BUDGET / CAN_SEND_TIME_BUDGET limits.  As such, this table becomes a priority order for CAN messages when many fall
+              //        due at once.  Be careful placing a very low time period message early in the table as that may cause that one message to dominate
+              //        transmissions - preventing later entries from being serviced.
+
+
+unsigned long   CAN_framesSent     = 0UL;                                                     // Running count of CAN frames handed to the NMEA2000 lib by send_CAN_msg(),
+unsigned long   CAN_busTimeUsed    = 0UL;                                                     // .. and (estimated) bus time in uS they used.
+uint8_t         CAN_lastPassFrames = 0;                                                       // How many frames did the last send_CAN() pass send,
+unsigned int    CAN_lastPassTime   = 0;                                                       // .. and how long did it take (uS)?
 
 
 
@@ -206,6 +231,8 @@ char        _cASCII_tx_buffer[cASCII_TX_BUFFER_SIZE];
 
 //--  Internal prototypes (helper functions, etc)
 void reset_BIT_arrarys(void);
+void age_BIT_arrays(void);
+bool send_CAN_msg(const tN2kMsg &N2kMsg);
 
 
 
@@ -270,13 +297,13 @@ bool initialize_CAN(void) {
 //---- Helper function, this will 'clear out' the bit-array tables used to 'synchronize' RVC Charger Status and Charger Status2 messages.
 
 void reset_BIT_arrarys(void) {
-    int i;
     
-    for (i = 0; i < SBSZ; i++) {
-        chargerSBHP[i] = 0x00;
-        chargerSBEP[i] = 0x00;
-        chargerSBLP[i] = 0x00;
-    }
+    addr_set_clear(&chargerSBHP);
+    addr_set_clear(&chargerSBEP);
+    addr_set_clear(&chargerSBLP);
+    memset(chargerSeen, 0, SBSZ);
+    chargerAgeIndex = 0;
+    chargerAgeLast  = millis();
 
     average_EPC_utilization = 0;
 
@@ -284,34 +311,134 @@ void reset_BIT_arrarys(void) {
 
 
 
+//---- Helper function, ages out chargers we have not heard a Charger Status2 from in a while (they were turned off, or changed CAN address).
+//     Only one byte (8 addresses) is looked at per call, spread so that all 32 bytes are covered every 1/2 of REMOTE_CAN_CHARGER_TIMEOUT.
+//     A charger is kept if it was heard from since its byte was last looked at:  so it will be dropped somewhere between 1/2 and 1x the timeout
+//     after it went quiet.
+
+void age_BIT_arrays(void) {
+
+    if ((millis() - chargerAgeLast) < ((REMOTE_CAN_CHARGER_TIMEOUT / 2) / SBSZ))
+        return;
+    chargerAgeLast = millis();
+
+    addr_set_expire(&chargerSBHP, chargerAgeIndex, chargerSeen[chargerAgeIndex]);
+    addr_set_expire(&chargerSBEP, chargerAgeIndex, chargerSeen[chargerAgeIndex]);
+    addr_set_expire(&chargerSBLP, chargerAgeIndex, chargerSeen[chargerAgeIndex]);
+
+    chargerSeen[chargerAgeIndex] = 0x00;                                                        // Start a new period for this byte.
+
+    chargerAgeIndex = (chargerAgeIndex + 1) % SBSZ;
+}
+
+
+
 
 //------------------------------------------------------------------------------------------------------
 // Send CAN
 //
 //      This function dispatched CAN messages to the CAN bus.  Using the table CANHandlers, it will scan the table
-//      looking for a message who's time has come, and who has not been sent for awhile.
+//      looking for messages who's time has come, and who have not been sent for awhile.  All due messages are sent
+//      in one pass, up to CAN_SEND_FRAME_BUDGET frames or CAN_SEND_TIME_BUDGET uS - whatever is left will still
+//      be due (and at the front of the table scan) the next time through.
 //
 //
 //------------------------------------------------------------------------------------------------------
 
 void send_CAN(void){
 
-    int i;
-    for (i=0; CANHandlers[i].PGN!=0; i++) {                                                   // Scan the table, looking for someone who is ready to be sent out.
+    int           i;
+    uint8_t       frames = 0;
+    unsigned long now    = millis();
+    unsigned long start  = micros();
+    unsigned long sentBefore;
+    unsigned int  inPeriod;
+
+    for (i=0; CANHandlers[i].PGN!=0; i++) {                                                   // Scan the table, looking for everyone who is ready to be sent out.
         if (CANHandlers[i].transPeriod == 0)    continue;                                     // This table entry does not want to be sent (Send only on request).
         if (CANHandlers[i].Transmitter == NULL)   continue;                                   // Nor does it even have a message transmitting procedure assigned.
 
-        if ((millis() % CANHandlers[i].transPeriod) > (CANHandlers[i].transPeriod / 2)) {     // We are in the time period for this message to be sent.
+        inPeriod = now % CANHandlers[i].transPeriod;
+        if (inPeriod > (CANHandlers[i].transPeriod / 2)) {                                    // We are in the time period for this message to be sent.
             if (CANHandlers[i].sentThisPeriod == true)   continue;                            // However, if we have already sent it - look for one that is actually ready to be sent.
+
+            if ((frames >= CAN_SEND_FRAME_BUDGET) ||                                          // Used up our budget for this pass?  Leave the rest for next time, letting the
+                ((micros() - start) >= CAN_SEND_TIME_BUDGET))                                 // mainloop do some more processing and the hardware catch up.
+                break;
+
+            sentBefore = CAN_framesSent;
             CANHandlers[i].Transmitter();                                                     // Has not been sent.  And we have an actual handler!
             CANHandlers[i].sentThisPeriod = true;
-            return;                                                                           // Done for now.  Do some more processing in the mainloop - this will
-            }                                                                                 // space CAN messages out some - letting the hardware catch up.
+            frames += (uint8_t)(CAN_framesSent - sentBefore);                                 // Charge the frames it actually sent (none if disabled, several for a fast-packet or Terminal)
+
+            inPeriod -= CANHandlers[i].transPeriod / 2;                                       // How long has this one been waiting since it fell due?
+            if (inPeriod > CANHandlers[i].maxLatency)
+                CANHandlers[i].maxLatency = inPeriod;
+            }
         else
             CANHandlers[i].sentThisPeriod = false;                                            // In the back half of the time period - reset the 'transmitted' flag
     }
 
+    CAN_lastPassFrames = frames;
+    CAN_lastPassTime   = (unsigned int)(micros() - start);
+}
+
+
+
+
+//------------------------------------------------------------------------------------------------------
+// Send CAN Msg
+//
+//      All our CAN messages go out through here, so the frames used (and so bus time) can be counted.
+//      Returns the same as NMEA2000.SendMsg(); a message over 8 bytes goes as a fast-packet, 6 bytes in the
+//      1st frame and 7 in each one after.
+//
+//------------------------------------------------------------------------------------------------------
+
+bool send_CAN_msg(const tN2kMsg &N2kMsg) {
+    uint8_t frames;
+
+    if (!NMEA2000.SendMsg(N2kMsg))
+        return(false);
+
+    frames = (N2kMsg.DataLen <= 8) ? 1 : ((N2kMsg.DataLen - 6 - 1) / 7 + 2);
+    CAN_framesSent  += frames;
+    CAN_busTimeUsed += frames * CAN_FRAME_BUS_TIME;
+    return(true);
+}
+
 
+
+
+//------------------------------------------------------------------------------------------------------
+// Send CAN Debug
+//
+//      Follows the DBG; string when debug is enabled ($EDB:) with how the CAN is doing:
+//          CDB;, <frames sent>, <bus time used mS>, <last pass frames>, <last pass uS>, <worst latency mS>, <PGN it was for>,
+//                <Terminal chars dropped>, <Terminal chars overrun>
+//
+//------------------------------------------------------------------------------------------------------
+
+void send_CAN_debug(void) {
+    char charBuffer[CAN_DEBUG_BUFF_SIZE];
+    int  i;
+    int  worst = 0;
+
+    for (i=0; CANHandlers[i].PGN!=0; i++)                                                     // Which message has waited longest to go out?
+        if (CANHandlers[i].maxLatency > CANHandlers[worst].maxLatency)
+            worst = i;
+
+    snprintf_P(charBuffer,CAN_DEBUG_BUFF_SIZE, PSTR("CDB;,%lu,%lu,%d,%u,%u,%lX,%u,%u\r\n"),
+                  CAN_framesSent,
+                  CAN_busTimeUsed / 1000UL,
+                  CAN_lastPassFrames,
+                  CAN_lastPassTime,
+                  CANHandlers[worst].maxLatency,
+                  CANHandlers[worst].PGN,
+                  CAN_ASCII_txDrops,
+                  CAN_ASCII_rxOverruns);
+
+    Serial.write(charBuffer);
 }
 
 
@@ -346,7 +473,7 @@ void N2kDCStatus_message(void){
       SetN2kDCStatus(N2kMsg,SID,batteryInstance,N2kDCt_Alternator,
                      N2kUInt8NA,N2kUInt8NA,N2kDoubleNA,        // We do not know what % change, % health, nor Time remaining is.
                      N2kDoubleNA);                             // We do not know the DC Ripple
-      NMEA2000.SendMsg(N2kMsg);
+      send_CAN_msg(N2kMsg);
 }
 
 
@@ -421,7 +548,7 @@ void N2kBatConf_message(void){
     else                                 N2kBatNomVolt = N2kDCbnv_48v;                      // We do not support anything greater then a 48v system...
 
     SetN2kBatConf(N2kMsg,batteryInstance,N2kBatType,N2kBatEqSupport,N2kBatNomVolt,N2kBatChem,AhToCoulomb(500*systemAmpMult),workingParms.BAT_TEMP_1C_COMP,0,0);
-    NMEA2000.SendMsg(N2kMsg);
+    send_CAN_msg(N2kMsg);
  }
 
 
@@ -451,7 +578,7 @@ void N2kDCBatStatus_message(void){
 
 
     SetN2kDCBatStatus(N2kMsg,batteryInstance,(double)measuredBatVolts,(double)measuredBatAmps,batTempK,SID);
-    NMEA2000.SendMsg(N2kMsg);
+    send_CAN_msg(N2kMsg);
     
 }
 
@@ -492,7 +619,7 @@ void RVCDCStatus1_message(void){
                                     (uint16_t) (measuredBatVolts * 20.0),
                                     Adc);
                                     
-      NMEA2000.SendMsg(N2kMsg);
+      send_CAN_msg(N2kMsg);
     }
 
 }
@@ -538,7 +665,7 @@ void RVCDCStatus2_message(void){
         TR = N2kUInt16NA;                                         // Same to Time Remaining.
           
         SetRVCDCSourceStatus2  (N2kMsg, batteryInstance, canConfig.DEVICE_PRIORITY, tempSend, SOC, TR);
-        NMEA2000.SendMsg(N2kMsg);
+        send_CAN_msg(N2kMsg);
     }
 }
 
@@ -567,6 +694,7 @@ void RVCDCStatus4_message(void){
         switch (alternatorState) {
             case ramping:
             case determine_ALT_cap:
+            case auto_tune_V:
             case bulk_charge:           state = RVCDCbcm_Bulk;
                                         break;
                              
@@ -603,7 +731,7 @@ void RVCDCStatus4_message(void){
                                      (uint16_t) (targetBatVolts * 20.0),
                                      (uint16_t) (targetAltAmps  * 20.0) + 0x7D00,
                                      canConfig.BATTERY_TYPE);
-        NMEA2000.SendMsg(N2kMsg);            
+        send_CAN_msg(N2kMsg);            
     }
 
 }
@@ -628,7 +756,7 @@ void RVCDCStatus5_message(void){
                             (uint32_t) (measuredBatVolts * 1000.0),
                             N2kUInt16NA);                                                 //!  THIS NEEDS TO BE EDITED, SEND OUT THE dV/dT, NOW JUST PLACEHOLDER
 
-      NMEA2000.SendMsg(N2kMsg);
+      send_CAN_msg(N2kMsg);
     }
 }
 
@@ -637,7 +765,8 @@ void RVCDCStatus5OV_message(void){
     tN2kMsg N2kMsg;
 
     if ((CAN_weAreRBM)   &&   (canConfig.ENABLE_OSE)    &&                              // Are we the Master?   RV-C messages enabled?
-        (alternatorState >= ramping)  && (alternatorState <= equalize)     &&           //  .. charging?
+        (((alternatorState >= ramping) && (alternatorState <= equalize)) ||             //  .. charging?
+          (alternatorState == auto_tune_V))                                &&
         (measuredBatVolts > targetBatVolts))  {                                         //    .. and in an overvoltage situation?
 
         SetRVCDCSourceStatus5(N2kMsg, batteryInstance,
@@ -646,7 +775,7 @@ void RVCDCStatus5OV_message(void){
                             N2kUInt16NA);                                               //!  THIS NEEDS TO BE EDITED, SEND OUT THE dV/dT, NOW JUST PLACEHOLDER
 
         N2kMsg.Priority = 2;                                                            // Raise the priority for this special message.
-        NMEA2000.SendMsg(N2kMsg);
+        send_CAN_msg(N2kMsg);
        }
 }
 
@@ -689,6 +818,7 @@ void RVCChrgStat_message(void){
     switch (alternatorState) {
         case ramping:
         case determine_ALT_cap:
+        case auto_tune_V:
         case bulk_charge:           state = RVCDCbcm_Bulk;
                                     break;
                          
@@ -702,6 +832,7 @@ void RVCChrgStat_message(void){
                          
         
         case forced_float_charge:   forcedChrg = RVCDCfc_Float;
+                                    // fall through - forced Float is still Float
         case float_charge:          state      = RVCDCbcm_Float;
                                     break;
                          
@@ -738,7 +869,7 @@ void RVCChrgStat_message(void){
                           autoRechg,
                           forcedChrg);
 
-    NMEA2000.SendMsg(N2kMsg);
+    send_CAN_msg(N2kMsg);
 }
 
 
@@ -766,7 +897,7 @@ void RVCChrgStat2_message(void){
     if (canConfig.ENABLE_OSE == false)  return;                                             // User has disabled RV-C messages, perhaps due to conflict in the system.
     
         if ((alternatorState < ramping)       ||                                            // If we are not in a charging state
-            (alternatorState > RBM_CVCC)      || 
+           ((alternatorState > RBM_CVCC) && (alternatorState != auto_tune_V)) ||
             (fieldPWMvalue == FIELD_PWM_MIN)  ||                                            //  .. or the field it turned off
            ((fieldPWMvalue <= thresholdPWMvalue) && (tachMode)))                            //     (including if we are holding the Field a little high to keep the tach running)
            Adc = 0x7D00;                                                                    // tell the world that the Amps being delivered are 0 -- we are inactive at this point.
@@ -785,7 +916,7 @@ void RVCChrgStat2_message(void){
                                      Adc,
                                     (int8_t) measuredFETTemp);
                                       
-        NMEA2000.SendMsg(N2kMsg);
+        send_CAN_msg(N2kMsg);
 
         }
 
@@ -827,7 +958,7 @@ void RVCChrgConfig_message(void) {
                               (uint16_t) (500.0*systemAmpMult), 
                               maxAmps);
                                       
-    NMEA2000.SendMsg(N2kMsg);
+    send_CAN_msg(N2kMsg);
     
 }
 
@@ -854,7 +985,7 @@ void RVCChrgConfig2_message(void){
                                N2kUInt8NA, 
                                (uint8_t)  (BAT_TEMP_NOMINAL), 
                                (uint16_t) (workingParms.FLOAT_TO_BULK_VOLTS * systemVoltMult *  20.0));
-    NMEA2000.SendMsg(N2kMsg);
+    send_CAN_msg(N2kMsg);
 }
 
 
@@ -878,7 +1009,7 @@ void RVCChrgConfig3_message(void){
                                (uint16_t) (workingParms.ACPT_BAT_V_SETPOINT  * systemVoltMult *  20.0), 
                                (uint16_t) (workingParms.FLOAT_BAT_V_SETPOINT * systemVoltMult *  20.0), 
                                (uint8_t)   workingParms.BAT_TEMP_1C_COMP);
-    NMEA2000.SendMsg(N2kMsg);
+    send_CAN_msg(N2kMsg);
 }
 
 
@@ -901,7 +1032,7 @@ void RVCChrgConfig4_message(void){
                                (uint16_t) (workingParms.EXIT_ACPT_DURATION  / 1000), 
                                (uint16_t) (workingParms.EXIT_FLOAT_DURATION / 1000), 
                                (uint8_t)   workingParms.BAT_TEMP_1C_COMP);
-    NMEA2000.SendMsg(N2kMsg);
+    send_CAN_msg(N2kMsg);
 }
 
 
@@ -921,7 +1052,7 @@ void RVCChrgEqualStat_message(void){
                              (alternatorState == equalize) ? ((millis() - altModeChanged) / 1000) : 0, 
                              (alternatorState != equalize));
 
-    NMEA2000.SendMsg(N2kMsg);
+    send_CAN_msg(N2kMsg);
 }
 
 
@@ -941,7 +1072,7 @@ void RVCChrgEqualConfig_message(void){
     SetRVCChargerEqualConfigStatus(N2kMsg, RVCDCct_Engine, canConfig.DEVICE_INSTANCE, 
                                   (uint16_t) (workingParms.EQUAL_BAT_V_SETPOINT * systemVoltMult *  20.0), 
                                   (uint16_t) (workingParms.EXIT_EQUAL_DURATION / 1000));
-    NMEA2000.SendMsg(N2kMsg);
+    send_CAN_msg(N2kMsg);
 }
 
 
@@ -976,7 +1107,7 @@ void RVCProdId_message(void) {
         for (int i=0; i<cnt; i++)
               N2kMsg.AddByte(buff[i]);  
           
-        NMEA2000.SendMsg(N2kMsg);       
+        send_CAN_msg(N2kMsg);       
 
     } else {
 
@@ -1002,26 +1133,38 @@ void RVCProdId_message(void) {
 void RVCTerminal_message(void){
     tN2kMsg   N2kMsg;
     int count;
+    int frames;
+    int room;
+    uint16_t index;
     char buff[8];
   
     if (canConfig.ENABLE_OSE == false)  return;                                                 // User has disabled RV-C messages, perhaps due to conflict in the system.
 
     if (_tx_buffer_head == _tx_buffer_tail) {                                                   // Is there an ASCII string we need to push out in a CAN wrapper?
-        CAN_ASCII_source = 0;                                                                   // No, buffer is empty.  We have finished sending out any requested communications. 
-                                                                                                // Reset the requests ID to an 'idle' state.
+        if ((!ibBufFilling) && (CAN_ASCII_available() == 0))                                    // No, buffer is empty.  If their command is not still arriving (or waiting to be read)
+            CAN_ASCII_source = 0;                                                               //   we have finished sending out any requested communications.
+                                                                                                //   Reset the requests ID to an 'idle' state.
         }
     else {
+        room = (int)NMEA2000.GetCANSendFrameBufFree() - cASCII_TX_FRAMES_RESERVE;               // Send as much as there is room for in the CAN Tx queue,
+        if (room > (int)cASCII_TX_FRAMES_MAX)                                                   //  up to our share of the bus.
+            room = cASCII_TX_FRAMES_MAX;
+
+        for (frames = 0; (frames < room) && (_tx_buffer_head != _tx_buffer_tail); frames++) {
+
+            count = 0;
+            index = _tx_buffer_tail;
+            while ((_tx_buffer_head != index) && (count < 8)) {                                 // Pull up to 8 characters from the buffer to send.
+                buff[count] = _cASCII_tx_buffer[index];
+                count++;
+                index = (index + 1) % cASCII_TX_BUFFER_SIZE;
+                }
 
-        count = 0;
-        while ((_tx_buffer_head != _tx_buffer_tail) && (count < 8)) {                           // Pull up to 8 characters from the buffer to send.
-            buff[count]     = _cASCII_tx_buffer[_tx_buffer_tail];
-            count++;
-            _tx_buffer_tail = (_tx_buffer_tail + 1) % cASCII_TX_BUFFER_SIZE;
-            }
-
-
-        SetRVCPGNTerminal(N2kMsg, CAN_ASCII_source, count, buff);
-        NMEA2000.SendMsg(N2kMsg);
+            SetRVCPGNTerminal(N2kMsg, _tx_dest, count, buff);
+            if (!send_CAN_msg(N2kMsg))                                                      // CAN Tx queue full?  Leave the characters in our buffer
+                break;                                                                          // and try again next time.
+            _tx_buffer_tail = index;
+        }
     }
 
 }
@@ -1032,22 +1175,31 @@ void RVCTerminal_message(void){
 //----------------------------------------------------------------------------------------------------------
 //  CAN ASCII Write 
 // 
-//      Places the passed string into the CAN-Terminal queue.  Note there is no check for overruns, so if the head
-//      overtakes the tail, data will be overwritten.
+//      Places the passed string (or single character) into the CAN-Terminal queue.  If the queue is full the character 
+//      is dropped and counted in CAN_ASCII_txDrops.
 //
 //
-void CAN_ASCII_write(char *stng) {
-    int i;
+void CAN_ASCII_putc(char c) {
+    uint16_t next;
 
     if (CAN_ASCII_source == 0)  return;                                                         // No one sent us anything, so there is nothing to send back.
 
-    i = 0;
-    while (stng[i] != 0) {
-        _cASCII_tx_buffer[_tx_buffer_head] = stng[i];
-        i++;
-        _tx_buffer_head = (_tx_buffer_head + 1) % cASCII_TX_BUFFER_SIZE;
-        };
+    next = (_tx_buffer_head + 1) % cASCII_TX_BUFFER_SIZE;
+    if (next == _tx_buffer_tail) {                                                              // No room, do not overwrite what is still waiting to go out.
+        if (CAN_ASCII_txDrops != 0xFFFF) CAN_ASCII_txDrops++;
+        return;
+        }
 
+    _tx_dest = CAN_ASCII_source;
+    _cASCII_tx_buffer[_tx_buffer_head] = c;
+    _tx_buffer_head = next;
+}
+
+
+void CAN_ASCII_write(char *stng) {
+
+    while (*stng != 0) 
+        CAN_ASCII_putc(*(stng++));
 }
 
 
@@ -1097,7 +1249,7 @@ void ISODiagnostics_message(void){
                                 0xFF,                           // No extended DSA
                                 0x0F);                          // No Banks defined
                           
-    NMEA2000.SendMsg(N2kMsg);
+    send_CAN_msg(N2kMsg);
 }
 
 
@@ -1137,6 +1289,7 @@ void ISODiagnosticsER_message(void) {
 
 void check_CAN(void){
     NMEA2000.ParseMessages();
+    age_BIT_arrays();
 }
 
 
@@ -1193,7 +1346,7 @@ void sendNAK_handler(const tN2kMsg &msg){
     SetN2kPGNISOAcknowledgement(msgR,ISOat_NAK,0xff,msg.PGN);
     msgR.Destination  = msg.Source;                                                         // Direct the response to original requester.
     
-    NMEA2000.SendMsg(msgR); 
+    send_CAN_msg(msgR); 
     
 }
 
@@ -1219,7 +1372,7 @@ void N2kDCBatStatus_handler(const tN2kMsg &N2kMsg){
         (canConfig.ENABLE_NMEA2000_RAT == true)     &&					                    // Have we been configured to look to a NMEA-2000 device for Remote Amps and Temperature?
         (batteryInstance               ==  RATbatInstance)) { 				                // And let's also make sure they think we are talking about the same battery.
         
-        CAN_RAT2000_lastReceived = millis();                                                // Well then, lets note what time we got this information  (Will be used later in resolve_BAT_VoltAmpTemp();  )
+        CAN_RAT2000_lastReceived = N2kMsg.MsgTime;                                          // Well then, lets note what time we got this information  (Will be used later in resolve_BAT_VoltAmpTemp();  )
         CAN_RAT2000_amps         = RATbatAmps;                                              //  tuck away the reported battery current.  (Also used later in resolve_BAT_VoltAmpTemp();  )
         CAN_RAT2000_temp         = (int) (RATBatTempK + 273.15);                            // Convert battery temp to unit type we use.
         }
@@ -1315,8 +1468,8 @@ void RVCDCStatus1_handler(const tN2kMsg &N2kMsg){
         if ((validate_CAN(instance, devPri, N2kMsg.Source, FLAG_DC1)) &&                    // Is it from someone we should be listing to?
             (Adc != N2kUInt32NA)) {                                                         // And do they actually have a current value to tell us?
               
-             CAN_RBM_amps = (float)((int32_t)Adc - 0x77359400) * 0.001;                     // Yup - save this info, will be processed in resolve_BAT_VoltAmpTemp();
-             CAN_RBM_ampsRefreshed = millis();
+             CAN_RBM_mAmps = (int32_t)Adc - 0x77359400;                                     // Yup - save this info (already in mA), will be processed in resolve_BAT_VoltAmpTemp();
+             CAN_RBM_ampsRefreshed = N2kMsg.MsgTime;
         }
     }
 }
@@ -1336,8 +1489,8 @@ void RVCDCStatus2_handler(const tN2kMsg &N2kMsg){
         validate_CAN(instance, devPri, N2kMsg.Source, FLAG_DC2)) {                          // Is it from someone we should be listing to?
 
         if ((CAN_RBM_sourceID == N2kMsg.Source) &&  (sourceTemp != N2kInt16NA)) {           // Is this THE Remote Battery Master we are listing to?   And did they care to tell us the battery temperature?
-          CAN_RBM_temp = (int)((float)sourceTemp / 0.03125);                                // They did!
-          CAN_RBM_tempRefreshed = millis();
+          CAN_RBM_temp = (int)((long)sourceTemp * 32);                                      // They did!  (Same scaling as the old '/ 0.03125', without the float divide)
+          CAN_RBM_tempRefreshed = N2kMsg.MsgTime;
         }
         else
           CAN_RBM_temp = -99;                                                                // signal that nothing valid has come from a RBM
@@ -1361,7 +1514,8 @@ void RVCDCStatus4_handler(const tN2kMsg &N2kMsg) {
      if (ParseRVCDCSourceStatus4(N2kMsg, instance, devPri,  desCM, desVolt, desAmp, batType) &&   // Received a valid CAN message from someone
         validate_CAN(instance, devPri, N2kMsg.Source, FLAG_DC4)) {                          // Is it from someone we should be listing to?
 
-            if ((alternatorState >= bulk_charge) || (alternatorState == disabled)) {        // If alternator is ramping, faulted, or determining alt size - leave it alone.
+            if (((alternatorState >= bulk_charge) && (alternatorState != auto_tune_V)) ||    // If alternator is ramping, faulted, determining alt size, or auto-tuning - leave it alone.
+                 (alternatorState == disabled)) {
                 switch (desCM) {                                                            // But if is into the charging phases, take direction from the RBM
                         case RVCDCbcm_Bulk:             set_ALT_mode(bulk_charge);
                                                         break;
@@ -1391,8 +1545,8 @@ void RVCDCStatus4_handler(const tN2kMsg &N2kMsg) {
                         }   /* End of switch/case */
               }
 
-            CAN_RBM_desiredVolts       =  (float) desVolt * 0.050;
-            CAN_RBM_desiredAmps        =  (float)(desAmp - 0x7D00) * 0.050;
+            CAN_RBM_desired_mVolts     =  (long) desVolt * 50L;                               // 50mV / 50mA per bit
+            CAN_RBM_desired_mAmps      = ((long)desAmp - 0x7D00L) * 50L;
             CAN_RBM_desiredChargeState = desCM;                                             // We should take note if the desired mode is charging, or disable...
             canConfig.BATTERY_TYPE     = batType;
 
@@ -1413,11 +1567,11 @@ void RVCDCStatus5_handler(const tN2kMsg &N2kMsg){
     if (ParseRVCDCSourceStatus5(N2kMsg, instance, devPri,  Vdc,  dVdT) &&                   // Received a valid CAN message from someone
         validate_CAN(instance, devPri, N2kMsg.Source, FLAG_DC5)) {                          // Is it from someone we should be listing to?
 
-        CAN_RBM_volts = (float)Vdc * 0.001;                                                 // Yup - save this info, will be processed in resolve_BAT_VoltAmpTemp();
+        CAN_RBM_mVolts = (long)Vdc;                                                         // Yup - save this info (already in mV), will be processed in resolve_BAT_VoltAmpTemp();
         CAN_RBM_dVdT = dVdT;
-        CAN_RBM_voltsOffset = CAN_RBM_volts - measuredAltVolts;                             // Store away the offset snapshot at this moment.
+        CAN_RBM_mVoltsOffset = CAN_RBM_mVolts - scaleFloat(measuredAltVolts, 3);            // Store away the offset snapshot at this moment.
         CAN_RBM_voPWMvalue  = fieldPWMvalue;
-        CAN_RBM_voltsRefreshed = millis();
+        CAN_RBM_voltsRefreshed = N2kMsg.MsgTime;
         }
 
 }
@@ -1465,7 +1619,7 @@ void RVCDCStatus6_handler(const tN2kMsg &N2kMsg){
 //*****************************************************************************
 void RVCChrgStat_handler(const tN2kMsg &N2kMsg){                                                // Charger Real-time Status message #1
 
-     uint8_t perMax, chrgInst, flag;
+     uint8_t perMax, chrgInst;
      uint16_t volts, amps; 
      tRVCChrgType  chrgType;
      tRVCBatChrgMode state;
@@ -1473,19 +1627,19 @@ void RVCChrgStat_handler(const tN2kMsg &N2kMsg){
      bool    defPOS, autoRechg; 
 
     if (canConfig.ENABLE_OSE == false)  return;                                             // User has disabled RV-C messages, perhaps due to conflict in the system.  So we are not sure this is REALLY an RV-C message
+    if ((chargerSBHP.count == 0) && (chargerSBEP.count == 0) && (chargerSBLP.count == 0))
+        return;                                                                             // No other chargers known on our battery, nothing here can change what we do.
      
     if (ParseRVCChargerStatus(N2kMsg, chrgType, chrgInst, volts, amps, perMax, state, defPOS, autoRechg, forcedChrg)) { // Received a valid CAN message from someone?
         if (perMax != N2kUInt8NA) {                                                             // And do they choose to tell us their utilization?  (Critical to do prioritization)
             
-            flag = 0x01<<(N2kMsg.Source&0x07);
- 
-            if (((chargerSBHP[N2kMsg.Source>>3] & flag) != 0) && (perMax < 80))                 // Higher Priority charger on the same battery?  -- being under-utilized?
-                CAN_HPUUCS_lastReceived = millis();                                             // Yup - take note of this situation. 
+            if (addr_set_has(&chargerSBHP, N2kMsg.Source) && (perMax < 80))                 // Higher Priority charger on the same battery?  -- being under-utilized?
+                CAN_HPUUCS_lastReceived = N2kMsg.MsgTime;                                       // Yup - take note of this situation. 
 
 
 
-            if ((chargerSBEP[N2kMsg.Source>>3] & flag) != 0)  {                                 // Equal Priority charger on the same battery?
-                CAN_EPCS_lastReceived   = millis();                                             // Yup -- 
+            if (addr_set_has(&chargerSBEP, N2kMsg.Source))  {                                 // Equal Priority charger on the same battery?
+                CAN_EPCS_lastReceived   = N2kMsg.MsgTime;                                       // Yup -- 
                 
                 if (average_EPC_utilization == 0)                                               // And we also want to record average utilization of our peers.
                     average_EPC_utilization = perMax;                                           //  if 1st time in, use this as the 'starting point'.
@@ -1497,8 +1651,8 @@ void RVCChrgStat_handler(const tN2kMsg &N2kMsg){
 
 
             
-            if (((chargerSBLP[N2kMsg.Source>>3] & flag) != 0) && (perMax > 20))                 // Lower  Priority charger on the same battery?  -- is it contributing anything?
-                CAN_LPCS_lastReceived = millis();                                               // Yup - take note of this situation. 
+            if (addr_set_has(&chargerSBLP, N2kMsg.Source) && (perMax > 20))                 // Lower  Priority charger on the same battery?  -- is it contributing anything?
+                CAN_LPCS_lastReceived = N2kMsg.MsgTime;                                         // Yup - take note of this situation. 
         }
     }
 }
@@ -1510,7 +1664,7 @@ void RVCChrgStat_handler(const tN2kMsg &N2kMsg){
 
 //*****************************************************************************
 void RVCChrgStat2_handler(const tN2kMsg &N2kMsg){                                                    // Charger Real-time Status message #2
-    uint8_t  chrgInst, DCInst, flag;
+    uint8_t  chrgInst, DCInst;
     tRVCChrgType  chrgType;
     uint8_t  devPri;
     uint16_t Vdc;
@@ -1522,21 +1676,16 @@ void RVCChrgStat2_handler(const tN2kMsg &N2kMsg){
     if (ParseRVCChargerStatus2(N2kMsg, chrgType, chrgInst, DCInst, devPri, Vdc, Adc, temp)) {       // Received a valid CAN message from someone?
      
         if (DCInst == batteryInstance) {                                                             // Is this someone charging the same battery as us?
-            flag = 0x01<<(N2kMsg.Source & 0x07);                                                    // All we are going to do here is note the linkage between this charger and the battery instance.
- 
-            if (devPri  > canConfig.DEVICE_PRIORITY)    chargerSBHP[N2kMsg.Source>>3] |=  flag;     // Higher priority?  Yes, set bit-array for additional checking in RVCChrgStat_handler()
-            else                                        chargerSBHP[N2kMsg.Source>>3] &= ~flag;
-            
-            if (devPri == canConfig.DEVICE_PRIORITY)    chargerSBEP[N2kMsg.Source>>3] |=  flag;     // Equal priority?
-            else                                        chargerSBEP[N2kMsg.Source>>3] &= ~flag;
-            
-            if (devPri <= canConfig.DEVICE_PRIORITY)    chargerSBLP[N2kMsg.Source>>3] |=  flag;     // Lower priority?
-            else                                        chargerSBLP[N2kMsg.Source>>3] &= ~flag;
+                                                                                                    // All we are going to do here is note the linkage between this charger and the battery instance.
+            addr_set_put(&chargerSBHP, N2kMsg.Source, (devPri  > canConfig.DEVICE_PRIORITY));       // Higher priority?  Yes, set bit-array for additional checking in RVCChrgStat_handler()
+            addr_set_put(&chargerSBEP, N2kMsg.Source, (devPri == canConfig.DEVICE_PRIORITY));       // Equal priority?
+            addr_set_put(&chargerSBLP, N2kMsg.Source, (devPri <= canConfig.DEVICE_PRIORITY));       // Lower priority?
+            chargerSeen[N2kMsg.Source>>3] |= 0x01<<(N2kMsg.Source & 0x07);                          // And note it is still alive, see age_BIT_arrays()
         }
         else {
-            chargerSBHP[N2kMsg.Source>>3] &= ~flag;                                                 // Charger is not even on our same battery
-            chargerSBEP[N2kMsg.Source>>3] &= ~flag;
-            chargerSBLP[N2kMsg.Source>>3] &= ~flag;
+            addr_set_put(&chargerSBHP, N2kMsg.Source, false);                                       // Charger is not even on our same battery
+            addr_set_put(&chargerSBEP, N2kMsg.Source, false);
+            addr_set_put(&chargerSBLP, N2kMsg.Source, false);
         }  
     }
 }
@@ -1607,13 +1756,33 @@ void RVCDCDisconnectCommand_handler(const tN2kMsg &N2kMsg){
 //*****************************************************************************
 void RVCTerminal_handler(const tN2kMsg &N2kMsg){                                            // Someone is sending us an ASCII text string!
 
-    int count;
+    int     count;
+    int     i;
+    uint8_t next;
+    char    chars[8];
 
     if (canConfig.ENABLE_OSE == false)  return;                                             // User has disabled RV-C messages, perhaps due to conflict in the system.  So we are not sure this is REALLY an RV-C message
  
-    if (ParseRVCPGNTerminal(N2kMsg, CAN_ASCII_source, count, _cASCII_rx_buffer)) {           // We can only handle one-packet at a time, so go ahead directly copy the CAN message into out local Rx buffer
-        _rx_buffer_tail = 0;
-        _rx_buffer_head = count;
+    if (ParseRVCPGNTerminal(N2kMsg, CAN_ASCII_source, count, chars)) {                      // Several frames may arrive between loop() passes, so queue them up behind anything not yet read.
+        for (i = 0; i < count; i++) {
+            next = (_rx_buffer_head + 1) & (cASCII_RX_BUFFER_SIZE - 1);
+            if (next == _rx_buffer_tail) {                                                  // Full - count the lost character.
+                if (CAN_ASCII_rxOverruns != 0xFFFF) CAN_ASCII_rxOverruns++;
+                continue;
+                }
+            _cASCII_rx_buffer[_rx_buffer_head] = chars[i];
+            _rx_buffer_head = next;
+        }
+
+        #ifdef CAN_ASCII_FLOW_CONTROL
+        if ((!_rx_xoff) && (CAN_ASCII_available() > (cASCII_RX_BUFFER_SIZE - 1 - 16))) {   // Not room for 2 more frames?  Ask the sender to hold off.
+            char c = cASCII_XOFF;
+            tN2kMsg N2kReply;
+            SetRVCPGNTerminal(N2kReply, CAN_ASCII_source, 1, &c);
+            _rx_xoff   = send_CAN_msg(N2kReply);
+            _flow_dest = CAN_ASCII_source;
+            }
+        #endif
     } else {
         CAN_ASCII_source = 0;                                                               // If it was not a valid message, clear the flag that anyone is talking to us via ASCII
         }
@@ -1637,7 +1806,17 @@ int CAN_ASCII_read(void) {
     return -1;
   } else {
      char c = _cASCII_rx_buffer[_rx_buffer_tail];
-    _rx_buffer_tail = (_rx_buffer_tail + 1) % cASCII_RX_BUFFER_SIZE;
+    _rx_buffer_tail = (_rx_buffer_tail + 1) & (cASCII_RX_BUFFER_SIZE - 1);
+
+    #ifdef CAN_ASCII_FLOW_CONTROL
+    if (_rx_xoff && (CAN_ASCII_available() <= (cASCII_RX_BUFFER_SIZE / 4))) {       // Drained enough, let the sender resume.
+        char r = cASCII_XON;
+        tN2kMsg N2kReply;
+        SetRVCPGNTerminal(N2kReply, _flow_dest, 1, &r);
+        _rx_xoff = !send_CAN_msg(N2kReply);
+        }
+    #endif
+
     return c;
   }
 
@@ -1655,7 +1834,7 @@ int CAN_ASCII_read(void) {
 //
 int CAN_ASCII_available(void) {
 
- return ((unsigned int)(cASCII_RX_BUFFER_SIZE + _rx_buffer_head - _rx_buffer_tail)) % cASCII_RX_BUFFER_SIZE;
+ return (_rx_buffer_head - _rx_buffer_tail) & (cASCII_RX_BUFFER_SIZE - 1);
 
 }
 
@@ -31,6 +31,10 @@
                                                             //  However, if you only want the NMEA-2000, and some other NMEA-2000 devices are unable to handle the standard RV-C messages, 
                                                             //  you may disable them.  (or place the Regulator on an dedicated CAN network and use a bridge)
 
+#define CAN_ASCII_FLOW_CONTROL                              // Send XOFF / XON back to a CAN Terminal (DGN 17E00) sender when our receive buffer is nearly full / has drained.
+                                                            //  A sender honoring them, and sending no more than 2 frames between loop() passes, never loses a character.
+                                                            //  Only disable if the configuration tool cannot cope with them - it must then pace itself to 1 command per loop().
+
 
 #include "Config.h"
 
@@ -73,13 +77,20 @@ typedef struct CCS {                                            // CAN Configura
 
 #define REMOTE_CAN_LPCS_TIMEOUT      7500UL                             //  Likewise, if we do not hear from any Lower Priority Charging Sources . . figure WE are it.
 #define REMOTE_CAN_HPUUCS_TIMEOUT    7500UL                             // Charger Status 1 (which has utilization %) comes every 5000mS..
+#define REMOTE_CAN_CHARGER_TIMEOUT  20000UL                             // Forget a charger's priority / battery linkage if its Charger Status2 has not been heard for this long.
+                                                                        //  (Checked incrementally, so it will be forgotten between 1/2 and 1x this time)
+
+#define CAN_SEND_FRAME_BUDGET           6                               // send_CAN() will start no more CANHandlers[] messages once this many frames have been sent in one pass through loop(),
+#define CAN_SEND_TIME_BUDGET         1500UL                             // .. and stop once this many uS have been spent in the pass.  Anything still due is carried over to the next pass.
+#define CAN_FRAME_BUS_TIME            540UL                             // Approx bus time in uS of one 29-bit ID, 8-byte frame at 250Kbps (incl. typical bit-stuffing) - used to track bus loading.
+#define CAN_DEBUG_BUFF_SIZE            80                               // Room for the CDB; debug string.
 
 #define RBM_REMASTER_IDLE_PERIOD    2 * REMOTE_CAN_MASTER_STABILITY     // When looking to establish a new RMB, wait at least 2x the stability timeout period.  To give some time for network errors to clear
 #define RBM_REMASTER_IDLE_MULTI     50UL                                // Also, hold off a little longer based on your 'priority' level.  Let 'smarter' devices try 1st for king...
 
 
 #define MAX_SUPPORTED_SYSTEM_AMPS      2000                             // Upper limit of Amps we expect the battery to take in. 
-#define MAX_SUPPORTED_SYSTEM_VOFFSET  1.5                               // If the Voltage Offset is greater then 1.5v, something is wring on the wiring.
+#define MAX_SUPPORTED_SYSTEM_mVOFFSET  1500                             // If the Voltage Offset is greater then 1.5v (1500mV), something is wring on the wiring.
                                                                         // (Used to indicate a crazy remote CAN battery master who we will ignore) 
 
 
@@ -95,11 +106,13 @@ typedef struct CCS {                                            // CAN Configura
 bool initialize_CAN(void);
 void send_CAN(void); 
 void check_CAN(void);
+void send_CAN_debug(void);
 void decide_if_CAN_RBM(void);
 void handle_CAN_Messages(const tN2kMsg &N2kMsg);
 bool handle_CAN_Requests(unsigned long RequestedPGN, unsigned char Requester, int DeviceIndex);
 
 void CAN_ASCII_write(char *stng);
+void CAN_ASCII_putc(char c);
 int  CAN_ASCII_read(void);
 int  CAN_ASCII_available(void);
 
@@ -113,10 +126,10 @@ uint8_t fetch_CAN_localID(void);
  
     
 extern CCS              canConfig;
-extern float            CAN_RBM_amps;      
+extern long             CAN_RBM_mAmps;      
 extern unsigned long    CAN_RBM_ampsRefreshed;
-extern float            CAN_RBM_volts;
-extern float            CAN_RBM_voltsOffset; 
+extern long             CAN_RBM_mVolts;
+extern long             CAN_RBM_mVoltsOffset; 
 extern int              CAN_RBM_voPWMvalue; 
 extern uint16_t         CAN_RBM_dVdT;               
 extern unsigned long    CAN_RBM_voltsRefreshed;
@@ -124,13 +137,18 @@ extern int              CAN_RBM_temp;
 extern unsigned long    CAN_RBM_tempRefreshed; 
 extern bool             ignoringRBM;
 
+extern unsigned long    CAN_framesSent;
+extern unsigned long    CAN_busTimeUsed;
+extern uint8_t          CAN_lastPassFrames;
+extern unsigned int     CAN_lastPassTime;
+
 extern unsigned long    CAN_RAT2000_lastReceived; 
 extern float            CAN_RAT2000_amps;
 extern int              CAN_RAT2000_temp; 
 
 extern uint8_t          batteryInstance;
-extern float            CAN_RBM_desiredVolts;                                
-extern float            CAN_RBM_desiredAmps;
+extern long             CAN_RBM_desired_mVolts;                                
+extern long             CAN_RBM_desired_mAmps;
 extern tRVCBatChrgMode  CAN_RBM_desiredChargeState;
 extern uint8_t          CAN_RBM_sourceID; 
 extern unsigned long    CAN_RBM_lastReceived;
@@ -144,6 +162,8 @@ extern unsigned long    CAN_HPUUCS_lastReceived;
 extern int              average_EPC_utilization;
 
 extern uint8_t          CAN_ASCII_source;
+extern uint16_t         CAN_ASCII_txDrops;
+extern uint16_t         CAN_ASCII_rxOverruns;
 
 
 
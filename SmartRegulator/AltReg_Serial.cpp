@@ -36,19 +36,37 @@ bool    ibBufFilling = false;                                           // Stati
                                                                         // a new command 'string' are working to get the rest of it.
                                                                         // During this time period, all normal 'status updates' outputs from the regulator will be suspended.
                                                                         // This is to make a more direct linkage between a command that asks for a response and the actual response.
-uint8_t  UMCounter         = 0;                                         // Update Monitor - Use this to moderate the number of times we send the non-critical information via Serial
+tTokens ibTokens;                                                       // Fields (and their numbers) found in ibBuf as it was filled.
+uint8_t  UMCounter         = 0;                                         // Update Monitor - Use this to take turns checking the non-critical information for changes  (0..NUM_STATUS_STRINGS-2)
+uint16_t statusHash;                                                    // Hash of a status string - used to see if its contents have changed since last sent
 
 
 
 
 //---- Local only helper function prototypes for Check_inbound() & Send_outbound()
-bool getInt(char *buffer, int *dest, int LLim, int HLim);
-bool getByte(char *buffer, uint8_t *dest, uint8_t LLim, uint8_t HLim);
-bool getDuration(char *buffer, unsigned long *dest,  int HLim);
-bool getFloat(char *buffer, float *dest, float LLim, float HLim);
-bool getBool(char *buffer, bool *dest);
+bool getInt(uint8_t field, int *dest, int LLim, int HLim);
+bool getByte(uint8_t field, uint8_t *dest, uint8_t LLim, uint8_t HLim);
+bool getDuration(uint8_t field, unsigned long *dest,  int HLim);
+bool getFloat(uint8_t field, float *dest, float LLim, float HLim);
+bool getBool(uint8_t field, bool *dest);
+char *getString(uint8_t field);
 void append_string(char *dest, const char *src, int n);
 void send_AOK(void);
+void prep_status(uint8_t i, tPutChar put);
+void put_hash(char c);
+void prep_AST_slow(tPutChar put);
+
+void cmd_RBT(void);                                                     // Command handlers, called from check_inbound()
+void cmd_RCP(void);
+void cmd_RAS(void);
+void cmd_CP(void);
+void cmd_SC(void);
+void cmd_CC(void);
+void cmd_PG(void);
+void cmd_EBA(void);
+void cmd_EDB(void);
+void cmd_MSR(void);
+void cmd_FRM(void);
 
 
 
@@ -65,6 +83,9 @@ void send_AOK(void);
 //
 //      If this is a CAN enabled target, the CAN terminal buffer will also be looked at. 
 //
+//      As each character after the ':' is stored it is also passed through the tokenizer, which notes where
+//      each comma separated field starts and works out its number right then.  (See token_add() in Types.cpp)
+//
 //      
 // 
 //------------------------------------------------------------------------------------------------------
@@ -88,6 +109,7 @@ bool fill_ib_buffer(){
             ibIndex          = 0;                                       //   Yes!  Initialize ibIndex variable
             ibBufFilling     = true;                                    //   And start storing the remaining characters into the buffer. 
             ibBufFillStarted = millis();
+            token_reset(&ibTokens);
             break;                                                      //   (The '$' character is not saved in the buffer...)
             }
 
@@ -107,6 +129,10 @@ bool fill_ib_buffer(){
                 return (true);                                          // Return that we have a valid command string!
                 }
             else{
+                if ((ibIndex == 5) && (ibBuf[0] == 'C') && (ibBuf[1] == 'P'))
+                    c = ',';                                            // $CPx:n takes any one character after the index digit as its separator ("$CPA:7 14.2,..." as well as "$CPA:7,14.2,...")
+                if (ibIndex > 3)                                        // Past the "xxx:", so this is part of the arguments.
+                    c = token_add(&ibTokens, ibIndex, c);               //   Let the tokenizer see it (commas come back as NULLs, to end each field)
                 ibBuf[ibIndex++] = c;                                   // Just a plane character, put it into the buffer
                 ibBuf[ibIndex]   = 0;                                   // And add a null terminate just-in-case
                 }
@@ -142,26 +168,63 @@ bool fill_ib_buffer(){
 //      an attached Debug terminal.  It is used not only during debug, but also during operation to allow for
 //      simple user configuration of the device (ala adjusting custom charging profiles - to be stored in FLASH)
 //
-// 
+//      Commands are looked up by their 3 letter mnemonic in the PROGMEM table inboundCommands[] below, which
+//      is kept sorted so a binary search can be used.  Each command's handler then works on the arguments
+//      remaining in ibBuf.
+//
+//
 //------------------------------------------------------------------------------------------------------
 
-void check_inbound()  {
+typedef void (*tCmdHandler)(void);                                      // Handlers for each command, they will find their arguments in ibBuf.
 
-    union{
-        SCS SC;                                                         // Working buffer to hold the read values from the EEPROM
-        CPS CP;                                                         // Note how I am using a 'union' to overlap working buffers and save of Stack RAM space...
-#ifdef SYSTEMCAN  
-        CCS CC;
-#endif
-        } buff;
+typedef struct {
+    char        cmd[4];                                                 // 3 letter mnemonic (plus NULL), ala "CPA"
+    tCmdHandler handler;
+    } tInboundCommand;
+
+
+                                                                        // Note:  The table MUST be kept sorted by mnemonic (ASCII order).
+const tInboundCommand inboundCommands[] PROGMEM = {
+    #ifdef SYSTEMCAN
+    {"CCN", cmd_CC},                                                    // CAN Configuration
+    {"CCR", cmd_CC},
+    #endif
+    {"CPA", cmd_CP},                                                    // Charge Profile changes
+    {"CPB", cmd_CP},
+    {"CPE", cmd_CP},
+    {"CPF", cmd_CP},
+    {"CPO", cmd_CP},
+    {"CPP", cmd_CP},
+    {"CPR", cmd_CP},
+    {"EBA", cmd_EBA},                                                   // External Battery Amps
+    {"EDB", cmd_EDB},                                                   // Enable DeBug
+    {"FRM", cmd_FRM},                                                   // Force Regulator Mode
+    {"MSR", cmd_MSR},                                                   // Master System Restore
+    {"PGA", cmd_PG},                                                    // PID Gains changes
+    {"PGL", cmd_PG},
+    {"PGR", cmd_PG},
+    {"PGT", cmd_PG},
+    {"PGV", cmd_PG},
+    {"PGW", cmd_PG},
+    {"RAS", cmd_RAS},                                                   // Request All Status
+    {"RBT", cmd_RBT},                                                   // ReBooT
+    {"RCP", cmd_RCP},                                                   // Request Charge Profile
+    {"SCA", cmd_SC},                                                    // System Configuration changes
+    {"SCN", cmd_SC},
+    {"SCO", cmd_SC},
+    {"SCR", cmd_SC},
+    {"SCT", cmd_SC}
+    };
+
+#define NUM_INBOUND_COMMANDS    (sizeof(inboundCommands) / sizeof(tInboundCommand))
 
-    char     charBuffer[OUTBOUND_BUFF_SIZE+1];                          // Work buffer to assemble strings before sending to the serial port. (for commands that send back responses)
-    char*    cp;
-    int8_t   index;
-    int      j;
 
 
 
+void check_inbound()  {
+    tInboundCommand entry;
+    int8_t   low, high, mid;
+    int      i;
 
 
 
@@ -174,53 +237,72 @@ void check_inbound()  {
         if (ibBuf[3] != ':')    return;                                 // ALL valid commands have a ":" in the 4th position.
 
 
-        if (alternatorState == pending_R)           
+        if (alternatorState == pending_R)
             set_ALT_mode(pending_R);                                    // User is trying to bench-conf the regulator, let them do all they need to do before we
                                                                         // move on and start ramping.
 
-        if (ibBuf[0] == 'R') {                                          // They are 'Requesting' something to be sent back to them...
+        low  = 0;                                                       // Binary search the command table for the mnemonic.
+        high = NUM_INBOUND_COMMANDS - 1;
+
+        while (low <= high) {
+            mid = (low + high) / 2;
+            memcpy_P(&entry, &inboundCommands[mid], sizeof(entry));     // Bring just this one entry in from FLASH
+
+            i = strncmp(ibBuf, entry.cmd, 3);
+            if (i == 0) {
+                entry.handler();                                        // Found it!
+                return;
+                }
+
+            if (i < 0)  high = mid - 1;
+            else        low  = mid + 1;
+            }
+        }                                                               // Not something we understand, just ignore it.
+
+}
 
-          if ((ibBuf[1] == 'B') && (ibBuf[2] == 'T')) {                 // $RBT:  ReBooT?  Yea, they are 'requesting' a reboot!
-               if (systemConfig.CONFIG_LOCKOUT != 0)   return;          // If system is locked-out, do not allow
-               reboot();                                                //  Else just reboot (will not return from there...)
-               }
 
 
-          if ((ibBuf[1] == 'C') && (ibBuf[2] == 'P')) {                 //   They want a copy of one of the Charge Profile Entries
 
-            index = ibBuf[4] - '1';                                     //   Which one?  There SHOULD be a number following, go get it.
+                //------  They are 'Requesting' something to be sent back to them...
+
+void cmd_RBT(void) {                                                    // $RBT:  ReBooT?  Yea, they are 'requesting' a reboot!
+    if (systemConfig.CONFIG_LOCKOUT != 0)   return;                     // If system is locked-out, do not allow
+    reboot();                                                           //  Else just reboot (will not return from there...)
+}
+
+
+
+void cmd_RCP(void) {                                                    //   They want a copy of one of the Charge Profile Entries
+    CPS      cp;
+    int8_t   index;
+
+    index = ibBuf[4] - '1';                                             //   Which one?  There SHOULD be a number following, go get it.
                                                                         //     adjusting for "0-origin" of Arrays.
-            if (index == -1)       
-                index = cpIndex;                                        //   If user sent '0' (i will contain -1), this means they want the 'current' one.
+    if (index == -1)
+        index = cpIndex;                                                //   If user sent '0' (i will contain -1), this means they want the 'current' one.
 
-            if ((index >= MAX_CPES) || (index < 0))
-                return;                                                 //   And make sure it is in bounds of the array (This will also trap-out any non-numeric character following the ':')
-                
+    if ((index >= MAX_CPES) || (index < 0))
+        return;                                                         //   And make sure it is in bounds of the array (This will also trap-out any non-numeric character following the ':')
 
 
-            if (read_CPS_EEPROM(index, &buff.CP) != true)               //   See if there is a valid user modified CPE in EEPROM we should be using.
-                transfer_default_CPS(index, &buff.CP);                  //   No, so get the correct entry from the values in the FLASH (PROGMEM) store.
 
-            prep_CPE(charBuffer, &buff.CP, index);                      //   And Finally,  assemble the string to send out requested information. 
-            Serial.write(charBuffer);                                   //   Send it out via Serial port
+    if (read_CPS_EEPROM(index, &cp) != true)                            //   See if there is a valid user modified CPE in EEPROM we should be using.
+        transfer_default_CPS(index, &cp);                               //   No, so get the correct entry from the values in the FLASH (PROGMEM) store.
 
-            #ifdef SYSTEMCAN
-              CAN_ASCII_write(charBuffer);                              //  Send this vai a a CAN-wrapper as well (if someone from the CAN asked for it!)
-              CAN_ASCII_source = 0;                                     // And we are all done pushing things into the CAN buffer until we are asked for something more.
-              #endif  
+    prep_CPE(put_outbound, &cp, index);                                 //   And Finally, send out requested information via the Serial port (and CAN-wrapper if someone from the CAN asked for it!)
 
-            return;
-            }
+    #ifdef SYSTEMCAN
+      CAN_ASCII_source = 0;                                             // And we are all done pushing things into the CAN buffer until we are asked for something more.
+      #endif
+}
 
 
-          if ((ibBuf[1] == 'A') && (ibBuf[2] == 'S')) {                 //   They want a copy of all the status strings?
-               send_outbound(true);                                     //      Send them all!
-               send_AOK();                                              // Let user know all the strings have been pushed out.
 
-               return;
-               }
-               
-          } //-- End of 'R' tree.
+void cmd_RAS(void) {                                                    //   They want a copy of all the status strings?
+    send_outbound(true);                                                //      Send them all!
+    send_AOK();                                                         // Let user know all the strings have been pushed out.
+}
 
 
 
@@ -231,349 +313,407 @@ void check_inbound()  {
                 //        Note that I only allow changes to CPE #7 or 8 (index = 6 or 7), if you want to change any other ones you
                 //        will need to modify the source code.  This is to help prevent accidents.
 
-        if ((ibBuf[0] == 'C') && (ibBuf[1] == 'P')) {                   // Something to do with the Charge Profiles . . .
+void cmd_CP(void) {                                                     // Something to do with the Charge Profiles . . .
+    CPS      cp;
+    int8_t   index;
+    int      j;
 
-            index =  ibBuf[4] - '1';                                    //   Which one?  There SHOULD be a number following, go get it.
-            if ((index < (MAX_CPES - CUSTOM_CPES)) ||                   //   Make sure it is within range (7 or 8), abort if not..
-                (index >= MAX_CPES))                                    //   (Only the last two Charge Profiles are allowed to be modified)     
-                return;
-        
-            if (read_CPS_EEPROM(index, &buff.CP) != true)               // Go get requested index entry, and check to see if it is valid.
-                transfer_default_CPS(index, &buff.CP);                  //   Nope, not a good one in EEPROM, so fetch the default entry from FLASH
+    index =  ibBuf[4] - '1';                                            //   Which one?  There SHOULD be a number following, go get it.
+    if ((index < (MAX_CPES - CUSTOM_CPES)) ||                           //   Make sure it is within range (7 or 8), abort if not..
+        (index >= MAX_CPES))                                            //   (Only the last two Charge Profiles are allowed to be modified)
+        return;
 
+    if (read_CPS_EEPROM(index, &cp) != true)                            // Go get requested index entry, and check to see if it is valid.
+        transfer_default_CPS(index, &cp);                               //   Nope, not a good one in EEPROM, so fetch the default entry from FLASH
 
-           if (systemConfig.CONFIG_LOCKOUT != 0)        return;         // If system is locked-out, do not allow any changes...
+
+   if (systemConfig.CONFIG_LOCKOUT != 0)        return;                 // If system is locked-out, do not allow any changes...
 
 
 
                                                                         //  Now, let's move on and see what they wish to change...
 
-            switch (ibBuf[2]) {
-                case 'A':                                                       //   Change  ACCEPT parameters in CPE user entry n 
-                                                                                //   $CPA:n  <VBat Set Point>, <Exit Duration>, <Exit Amps>
-                        if (!getFloat   ((ibBuf + 5),   &buff.CP.ACPT_BAT_V_SETPOINT,  0.0, 20.0)) return;      //  20 volts MAX  - If any problems, just abort this command.
-                        if (!getDuration(NULL,          &buff.CP.EXIT_ACPT_DURATION,     (60*10))) return;      //  10 Hours MAX, converted into mS for use
-                        if (!getInt     (NULL,          &buff.CP.EXIT_ACPT_AMPS ,        -1, 200)) return;      // 200 Amps MAX
-                        if (!getInt     (NULL,          &j,                               0,   0)) return;      // Place holder for future dV/dt 
-                        break;                                                                                  // Got it all, drop down and finish storing it into EEPROM
+    switch (ibBuf[2]) {
+        case 'A':                                                       //   Change  ACCEPT parameters in CPE user entry n
+                                                                        //   $CPA:n  <VBat Set Point>, <Exit Duration>, <Exit Amps>, <Exit Amps/hour>
+                if (!getFloat   (1, &cp.ACPT_BAT_V_SETPOINT,  0.0, 20.0)) return;   //  20 volts MAX  - If any problems, just abort this command.
+                if (!getDuration(2, &cp.EXIT_ACPT_DURATION,     (60*10))) return;   //  10 Hours MAX, converted into mS for use
+                if (!getInt     (3, &cp.EXIT_ACPT_AMPS ,        -1, 200)) return;   // 200 Amps MAX
+                if (!getFloat   (4, &cp.EXIT_ACPT_DIDT,       0.0, 50.0)) return;   //  50 Amps/hour MAX
+                break;                                                                          // Got it all, drop down and finish storing it into EEPROM
 
 
 
 
-                case 'O':                                                       // Change OVERCHARGE  parameters in CPE user entry n 
-                                                                                //   $CPO:n    <Exit Amps>, <Exit Duration>, <Exit  VBat>       
+        case 'O':                                                       // Change OVERCHARGE  parameters in CPE user entry n
+                                                                        //   $CPO:n    <Exit Amps>, <Exit Duration>, <Exit  VBat>
 
-                        if (!getInt     ((ibBuf + 5),   &buff.CP.LIMIT_OC_AMPS,           0, 50)) return;       // 50 Amps MAX
-                        if (!getDuration(NULL,          &buff.CP.EXIT_OC_DURATION,      (60*10))) return;       // 10 Hours MAX, converted into mS for use
-                        if (!getFloat   (NULL,          &buff.CP.EXIT_OC_VOLTS,       0.0, 20.0)) return;       // 20 volts MAX
-                        if (!getInt     (NULL,          &j,                               0,  0)) return;       // Place holder for future dV/dt 
-                        break;                                                  
+                if (!getInt     (1, &cp.LIMIT_OC_AMPS,           0, 50)) return;    // 50 Amps MAX
+                if (!getDuration(2, &cp.EXIT_OC_DURATION,      (60*10))) return;    // 10 Hours MAX, converted into mS for use
+                if (!getFloat   (3, &cp.EXIT_OC_VOLTS,       0.0, 20.0)) return;    // 20 volts MAX
+                if (!getInt     (4, &j,                          0,  0)) return;    // Place holder for future dV/dt
+                break;
 
 
 
 
-                case 'F':                                                       // Change FLOAT  parameters in CPE user entry n 
-                                                                                //   $CPF:n    <VBat Set Point>, <Exit Duration>, <Revert Amps> , <Revert Volts>        
-                                                                        
-                        if (!getFloat   ((ibBuf + 5),   &buff.CP.FLOAT_BAT_V_SETPOINT, 0.0, 20.0)) return;      //  20 volts MAX
-                        if (!getInt     ( NULL,         &buff.CP.LIMIT_FLOAT_AMPS,        -1, 50)) return;
-                        if (!getDuration( NULL,         &buff.CP.EXIT_FLOAT_DURATION,   (60*500))) return;      // 500 Hours MAX, converted into mS for use
-                        if (!getInt     ( NULL,         &buff.CP.FLOAT_TO_BULK_AMPS,     -300, 0)) return;      // 300 Amps MAX
-                        if (!getInt     ( NULL,         &buff.CP.FLOAT_TO_BULK_AHS,      -250, 0)) return;
-                        if (!getFloat   ( NULL,         &buff.CP.FLOAT_TO_BULK_VOLTS,  0.0, 20.0)) return;      //  20 volts MAX
-                        break;                                                  
+        case 'F':                                                       // Change FLOAT  parameters in CPE user entry n
+                                                                        //   $CPF:n    <VBat Set Point>, <Exit Duration>, <Revert Amps> , <Revert Volts>
 
+                if (!getFloat   (1, &cp.FLOAT_BAT_V_SETPOINT, 0.0, 20.0)) return;   //  20 volts MAX
+                if (!getInt     (2, &cp.LIMIT_FLOAT_AMPS,        -1, 50)) return;
+                if (!getDuration(3, &cp.EXIT_FLOAT_DURATION,   (60*500))) return;   // 500 Hours MAX, converted into mS for use
+                if (!getInt     (4, &cp.FLOAT_TO_BULK_AMPS,     -300, 0)) return;   // 300 Amps MAX
+                if (!getInt     (5, &cp.FLOAT_TO_BULK_AHS,      -250, 0)) return;
+                if (!getFloat   (6, &cp.FLOAT_TO_BULK_VOLTS,  0.0, 20.0)) return;   //  20 volts MAX
+                break;
 
 
 
 
-                case 'P':                                                       // Change POST-FLOAT parameters in CPE user entry n
-                                                                                //   $CPP:n     <Exit Duration>, <Revert VBat>  
 
-                        if (!getDuration((ibBuf + 5),   &buff.CP.EXIT_PF_DURATION,      (60*500))) return;      // 500 Hours MAX, converted into mS for use
-                        if (!getFloat   ( NULL,         &buff.CP.PF_TO_BULK_VOLTS,     0.0, 20.0)) return;      //  20 volts MAX to trigger moving back to Bulk mode (via Ramp)
-                        if (!getInt     ( NULL,         &buff.CP.PF_TO_BULK_AHS,         -250, 0)) return;
-                        break;                                                  
+        case 'P':                                                       // Change POST-FLOAT parameters in CPE user entry n
+                                                                        //   $CPP:n     <Exit Duration>, <Revert VBat>
 
+                if (!getDuration(1, &cp.EXIT_PF_DURATION,      (60*500))) return;   // 500 Hours MAX, converted into mS for use
+                if (!getFloat   (2, &cp.PF_TO_BULK_VOLTS,     0.0, 20.0)) return;   //  20 volts MAX to trigger moving back to Bulk mode (via Ramp)
+                if (!getInt     (3, &cp.PF_TO_BULK_AHS,         -250, 0)) return;
+                break;
 
 
 
 
-                case 'E':                                                       // Change EQUALIZE  parameters in CPE user entry n 
-                                                                                //   $CPE:n     <VBat Set Point>, < Max Amps >, <Exit Duration>, <Exit Amps>
 
-                        if (!getFloat   ((ibBuf + 5),   &buff.CP.EQUAL_BAT_V_SETPOINT, 0.0, 25.0)) return;      //   25 volts MAX for Equalization.
-                        if (!getInt     ( NULL,         &buff.CP.LIMIT_EQUAL_AMPS,         0, 50)) return;      //  50A MAX while equalizing...
-                        if (!getDuration( NULL,         &buff.CP.EXIT_EQUAL_DURATION,        240)) return;      //  240 MINUTES MAX, converted into mS for use  
-                        if (!getInt     ( NULL,         &buff.CP.EXIT_EQUAL_AMPS,          0, 50)) return;      //   50 Amps MAX for Equalization
-                        break;
+        case 'E':                                                       // Change EQUALIZE  parameters in CPE user entry n
+                                                                        //   $CPE:n     <VBat Set Point>, < Max Amps >, <Exit Duration>, <Exit Amps>
 
+                if (!getFloat   (1, &cp.EQUAL_BAT_V_SETPOINT, 0.0, 25.0)) return;   //   25 volts MAX for Equalization.
+                if (!getInt     (2, &cp.LIMIT_EQUAL_AMPS,         0, 50)) return;   //  50A MAX while equalizing...
+                if (!getDuration(3, &cp.EXIT_EQUAL_DURATION,        240)) return;   //  240 MINUTES MAX, converted into mS for use
+                if (!getInt     (4, &cp.EXIT_EQUAL_AMPS,          0, 50)) return;   //   50 Amps MAX for Equalization
+                break;
 
 
 
 
 
-                case 'B':                                                       // Change BATTERY parameters in CPE user entry n 
-                                                                                //   $CPB:n     <VBat Comp per 1f>, < Min Comp Temp >, <Max Charge Temp>
 
-                        if (!getFloat((ibBuf + 5),      &buff.CP.BAT_TEMP_1C_COMP,      0.0, 0.1)) return;       //   0.1v / deg C MAX.  (Note, this is for a normalized 12v battery)
-                        if (!getInt  ( NULL,            &buff.CP.MIN_TEMP_COMP_LIMIT,   -30,  40)) return;       //  -30c to 40c range should be good???
-                        if (!getInt  ( NULL,            &buff.CP.BAT_MIN_CHARGE_TEMP,   -50,  10)) return;
-                        if (!getInt  ( NULL,            &buff.CP.BAT_MAX_CHARGE_TEMP,    20,  95)) return;       //  Cap at 95 to protect NTC sensor? (Esp Epoxy filling??)
-                        break;  
+        case 'B':                                                       // Change BATTERY parameters in CPE user entry n
+                                                                        //   $CPB:n     <VBat Comp per 1f>, < Min Comp Temp >, <Max Charge Temp>
 
+                if (!getFloat(1, &cp.BAT_TEMP_1C_COMP,      0.0, 0.1)) return;   //   0.1v / deg C MAX.  (Note, this is for a normalized 12v battery)
+                if (!getInt  (2, &cp.MIN_TEMP_COMP_LIMIT,   -30,  40)) return;   //  -30c to 40c range should be good???
+                if (!getInt  (3, &cp.BAT_MIN_CHARGE_TEMP,   -50,  10)) return;
+                if (!getInt  (4, &cp.BAT_MAX_CHARGE_TEMP,    20,  95)) return;   //  Cap at 95 to protect NTC sensor? (Esp Epoxy filling??)
+                break;
 
 
-                        
-                case 'R':                                                       // $CPR:n  RESTORES Charge Profile table entry 'n' to default 
-                        write_CPS_EEPROM(index, NULL);                          // Erase selected saved systemConfig structure in the EEPROM (if present)
-                        send_AOK();                                             // Let user know we understand.
-                        return;                                                 // All done.
-                        
 
 
-                default:        return;
-                }
+        case 'R':                                                       // $CPR:n  RESTORES Charge Profile table entry 'n' to default
+                write_CPS_EEPROM(index, NULL);                          // Erase selected saved systemConfig structure in the EEPROM (if present)
+                send_AOK();                                             // Let user know we understand.
+                return;                                                 // All done.
 
-                write_CPS_EEPROM(index, &buff.CP);                              // Save back the new entry
-                send_AOK();                                                     // Let user know we understand.
-                return;                                                         // And return to see if more commands are being sent.  User must issue $RBT command for changes
-                                                                                //   to be loaded into regulators working memory.
-             }
 
 
+        default:        return;
+        }
 
+    write_CPS_EEPROM(index, &cp);                                       // Save back the new entry
+    send_AOK();                                                         // Let user know we understand.
+                                                                        // User must issue $RBT command for changes to be loaded into regulators working memory.
+}
 
 
 
-        if ((ibBuf[0] == 'S') && (ibBuf[1] == 'C')) {                           // Something to do with the System Configuration . . .
-            if (systemConfig.CONFIG_LOCKOUT != 0)       return;                 // If system is locked-out, do not allow any changes...
 
 
-            if (read_SCS_EEPROM(&buff.SC) != true)                              // Prime the work buffer with anything already in FLASH
-                buff.SC = systemConfig;                                         //   (or the default values if FLASH is empty / invalid)
 
-            switch (ibBuf[2]) {
-                case 'A':                                                       // Changes ALTERNATOR parameters in System Configuration table
-                                                                                // $SCA: <32v?>, < Alt Target Temp >, <Alt Derate (norm) >,
-                                                                                //       <Alt Derate (small) >,<Alt Derate (half) >,<PBF>, 
-                                                                                //       <Alt Amp Cap.>, <System Watt Cap. >, <Amp Shunt Ratio>
-                        bool dummy;
-                        if (!getBool ((ibBuf + 4), &dummy                                 )) return;  // Was 'Favor32v' has been redacted, ignor it.
-                        if (!getByte (NULL, &buff.SC.ALT_TEMP_SETPOINT,            15, 120)) return;                                    
-                        if (!getFloat(NULL, &buff.SC.ALT_AMP_DERATE_NORMAL,       0.1, 1.0)) return;
-                        if (!getFloat(NULL, &buff.SC.ALT_AMP_DERATE_SMALL_MODE,   0.1, 1.0)) return;
-                        if (!getFloat(NULL, &buff.SC.ALT_AMP_DERATE_HALF_POWER,   0.1, 1.0)) return;
-                        if (!getInt  (NULL, &buff.SC.ALT_PULLBACK_FACTOR,        -1,    10)) return;
-                        if (!getInt  (NULL, &buff.SC.ALT_AMPS_LIMIT,             -1,   500)) return;
-                        if (!getInt  (NULL, &buff.SC.ALT_WATTS_LIMIT,            -1, 20000)) return;
-                        if (!getInt  (NULL, &buff.SC.AMP_SHUNT_RATIO,           500, 20000)) return;
-                        if (!getBool (NULL, &buff.SC.REVERSED_SHUNT                       )) return;
-                        if (!getInt  (NULL, &buff.SC.ALT_IDLE_RPM,                0,  1500)) buff.SC.ALT_IDLE_RPM = 0;
-                        break;                                                  
+void cmd_SC(void) {                                                     // Something to do with the System Configuration . . .
+    SCS      sc;
+    char*    cp;
 
-                        
-                        
+    if (systemConfig.CONFIG_LOCKOUT != 0)       return;                 // If system is locked-out, do not allow any changes...
+
+
+    if (read_SCS_EEPROM(&sc) != true)                                   // Prime the work buffer with anything already in FLASH
+        sc = systemConfig;                                              //   (or the default values if FLASH is empty / invalid)
+
+    switch (ibBuf[2]) {
+        case 'A':                                                       // Changes ALTERNATOR parameters in System Configuration table
+                                                                        // $SCA: <32v?>, < Alt Target Temp >, <Alt Derate (norm) >,
+                                                                        //       <Alt Derate (small) >,<Alt Derate (half) >,<PBF>,
+                                                                        //       <Alt Amp Cap.>, <System Watt Cap. >, <Amp Shunt Ratio>
+                bool dummy;
+                if (!getBool (0, &dummy                            )) return;  // Was 'Favor32v' has been redacted, ignor it.
+                if (!getByte (1, &sc.ALT_TEMP_SETPOINT,            15, 120)) return;
+                if (!getFloat(2, &sc.ALT_AMP_DERATE_NORMAL,       0.1, 1.0)) return;
+                if (!getFloat(3, &sc.ALT_AMP_DERATE_SMALL_MODE,   0.1, 1.0)) return;
+                if (!getFloat(4, &sc.ALT_AMP_DERATE_HALF_POWER,   0.1, 1.0)) return;
+                if (!getInt  (5, &sc.ALT_PULLBACK_FACTOR,        -1,    10)) return;
+                if (!getInt  (6, &sc.ALT_AMPS_LIMIT,             -1,   500)) return;
+                if (!getInt  (7, &sc.ALT_WATTS_LIMIT,            -1, 20000)) return;
+                if (!getInt  (8, &sc.AMP_SHUNT_RATIO,           500, 20000)) return;
+                if (!getBool (9, &sc.REVERSED_SHUNT                       )) return;
+                if (!getInt  (10, &sc.ALT_IDLE_RPM,                0,  1500)) sc.ALT_IDLE_RPM = 0;
+                break;
 
-                case 'T':                                                             // Changes TACHOMETER parameters in System Configuration table
-                                                                                      // $SCT: <Alt poles>, < Eng/Alt drive ratio >, <Field Tach Min>, <Forced TachMode>
 
-                        if (!getByte((ibBuf + 4), &buff.SC.ALTERNATOR_POLES ,        2,            25)) return;
-                        if (!getFloat(NULL,       &buff.SC.ENGINE_ALT_DRIVE_RATIO, 0.5,          20.0)) return;
-                        if (!getInt  (NULL,       &buff.SC.FIELD_TACH_PWM,          -1,            30)) return;
-                        if (!getBool (NULL,       &buff.SC.FORCED_TM                                 )) return;
-                        
-                        if (buff.SC.FIELD_TACH_PWM > 0)
-                                buff.SC.FIELD_TACH_PWM = min(((buff.SC.FIELD_TACH_PWM * FIELD_PWM_MAX)/100)   , MAX_TACH_PWM);
-                                                                                      // Convert any entered % of max field into a raw PWM number.
-                        break;  
 
-        
 
+        case 'T':                                                             // Changes TACHOMETER parameters in System Configuration table
+                                                                              // $SCT: <Alt poles>, < Eng/Alt drive ratio >, <Field Tach Min>, <Forced TachMode>
 
+                if (!getByte(0, &sc.ALTERNATOR_POLES ,        2,            25)) return;
+                if (!getFloat(1, &sc.ENGINE_ALT_DRIVE_RATIO, 0.5,          20.0)) return;
+                if (!getInt  (2, &sc.FIELD_TACH_PWM,          -1,            30)) return;
+                if (!getBool (3, &sc.FORCED_TM                                 )) return;
 
-                
-                case 'N':                                                               // Changes 'Name' (and Password) parameters in System Configuration table.  Used by Bluetooth and CAN to ID this regulator 
-                                                                                        //   $SCN: <Enable BT?>, <Name>, <Password>                     
-                        
-                        if (!getBool  ((ibBuf + 4),       &buff.SC.USE_BT)) return;     //   Enable the Bluetooth (via Software)?  1 = Yes, anything else = No.
+                if (sc.FIELD_TACH_PWM > 0)
+                        sc.FIELD_TACH_PWM = min(((sc.FIELD_TACH_PWM * FIELD_PWM_MAX)/100)   , MAX_TACH_PWM);
+                                                                              // Convert any entered % of max field into a raw PWM number.
+                break;
 
-                        cp = strtok(NULL, ",");                                         //   Get the regulators name / ID
-                        if ((cp == NULL) || (strlen(cp)> MAX_NAME_LEN)) return;  
-                        strcpy(buff.SC.REG_NAME, cp);
 
-                        cp = strtok(NULL, ",");                                         //   Get the password
-                        if ((cp == NULL) || (strlen(cp)> MAX_PIN_LEN)) return;   
-                        strcpy(buff.SC.REG_PSWD, cp);
 
 
-                        if ((measuredAltAmps < CLEAR_BT_LOCK_AMPS) && (readDipSwitch()== DIP_MASK)) {
-                                systemConfig.BT_CONFIG_CHANGED = true;                  // Clear the lock-flag, but only if we are not 'charging' and the DIPs are all on...
-                                buff.SC.BT_CONFIG_CHANGED      = true;                  // Note it also in the soon-to-be-written buffer as well, so that this will be preserved after rebooting.
-                                }                                             
 
-                        break;                                                  
+        case 'N':                                                               // Changes 'Name' (and Password) parameters in System Configuration table.  Used by Bluetooth and CAN to ID this regulator
+                                                                                //   $SCN: <Enable BT?>, <Name>, <Password>
 
+                if (!getBool  (0, &sc.USE_BT)) return;          //   Enable the Bluetooth (via Software)?  1 = Yes, anything else = No.
 
+                cp = getString(1);                                              //   Get the regulators name / ID
+                if ((cp == NULL) || (strlen(cp)> MAX_NAME_LEN)) return;
+                strcpy(sc.REG_NAME, cp);
 
+                cp = getString(2);                                              //   Get the password
+                if ((cp == NULL) || (strlen(cp)> MAX_PIN_LEN)) return;
+                strcpy(sc.REG_PSWD, cp);
 
 
-                case 'O':                                                             // OVERRIDE DIP Switch settings for CP_Index and BC_Index.
-                                                                                      // $SCO:  <CP_Index>, <BC_Index >, <SV_Override>, <Lockout>
- 
-                        if (!getByte    ((ibBuf + 4),   &buff.SC.CP_INDEX_OVERRIDE,   0,  8  )) return;
-                        if (!getFloat   ( NULL,         &buff.SC.BC_MULT_OVERRIDE,    0, 10.0)) return;
-                        if (!getFloat   ( NULL,         &buff.SC.SV_OVERRIDE,         0,  4.0)) return;
-                        if (!getByte    ( NULL,         &buff.SC.CONFIG_LOCKOUT,      0,  2  )) return;
-                
+                if ((measuredAltAmps < CLEAR_BT_LOCK_AMPS) && (readDipSwitch()== DIP_MASK)) {
+                        systemConfig.BT_CONFIG_CHANGED = true;                  // Clear the lock-flag, but only if we are not 'charging' and the DIPs are all on...
+                        sc.BT_CONFIG_CHANGED           = true;                  // Note it also in the soon-to-be-written buffer as well, so that this will be preserved after rebooting.
+                        }
 
-                        break;  
+                break;
 
-        
 
 
-                case 'R':                                                       // RESTORES System Configuration table to default
-                        write_SCS_EEPROM(NULL);                                 // Erase any saved systemConfig structure in the EEPROM
-                        send_AOK();                                             // Let user know we understand.
-                        return;                                                 // All done.
 
-                default:        return;
-                }
 
+        case 'O':                                                             // OVERRIDE DIP Switch settings for CP_Index and BC_Index.
+                                                                              // $SCO:  <CP_Index>, <BC_Index >, <SV_Override>, <Lockout>
 
-            write_SCS_EEPROM(&buff.SC);                                         // Save back the new Charge profile 
-            send_AOK();                                                         // Let user know we understand.
-            return;                                                             // And return to see if more commands are being sent.  User must issue $RBT command for changes
-                                                                                //   to be loaded into regulators working memory.
-            }
-        
+                if (!getByte    (0, &sc.CP_INDEX_OVERRIDE,   0,  8  )) return;
+                if (!getFloat   (1, &sc.BC_MULT_OVERRIDE,    0, 10.0)) return;
+                if (!getFloat   (2, &sc.SV_OVERRIDE,         0,  4.0)) return;
+                if (!getByte    (3, &sc.CONFIG_LOCKOUT,      0,  2  )) return;
 
 
+                break;
 
 
 
-        #ifdef SYSTEMCAN 
-        if ((ibBuf[0] == 'C') && (ibBuf[1] == 'C')) {                           // Something to do with the CAN Configuration . . .
-            if (systemConfig.CONFIG_LOCKOUT != 0)       return;                 // If system is locked-out, do not allow any changes...
 
+        case 'R':                                                       // RESTORES System Configuration table to default
+                write_SCS_EEPROM(NULL);                                 // Erase any saved systemConfig structure in the EEPROM
+                send_AOK();                                             // Let user know we understand.
+                return;                                                 // All done.
 
-            if (read_CCS_EEPROM(&buff.CC) != true)                              // Prime the work buffer with anything already in FLASH
-                 buff.CC = canConfig;                                           //   (or the default values if FLASH is empty / invalid)
+        default:        return;
+        }
 
 
-            switch (ibBuf[2]) {   
+    write_SCS_EEPROM(&sc);                                              // Save back the new Charge profile
+    send_AOK();                                                         // Let user know we understand.
+                                                                        // User must issue $RBT command for changes to be loaded into regulators working memory.
+}
 
 
-                case 'R':                                                       // RESTORES CAN Configuration table to default
-                        write_CCS_EEPROM(NULL);                                 // Erase any saved CANConfig structure in the EEPROM
-                        send_AOK();                                             // Let user know we understand.
-                        return;                                                 // All done.
-    
 
 
-               case 'N':                                                       // Can CoNfiguration       
-                                                                               //$CCN:    <Battery Instance Override>, <Device Instance >, <Device Priority>,
-                                                                               //         <AllowRMB?>, <ShuntAtBat?>,  <Enable-OSE?>, <Enable-NMEA2000?>, <Enable_NMEA2000_RAT?>
-                        if (!getByte    ((ibBuf + 4),   &buff.CC.BI_OVERRIDE,         0,  100  )) return;
-                        if (!getByte    ( NULL,         &buff.CC.DEVICE_INSTANCE,     1,   13  )) return;
-                        if (!getByte    ( NULL,         &buff.CC.DEVICE_PRIORITY,     1,  250  )) return;
-                        if (!getBool    ( NULL,         &buff.CC.CONSIDER_MASTER               )) return;
-                        if (!getBool    ( NULL,         &buff.CC.SHUNT_AT_BAT                  )) return;
-                        if (!getBool    ( NULL,         &buff.CC.ENABLE_OSE                    )) return;
-                        if (!getBool    ( NULL,         &buff.CC.ENABLE_NMEA2000               )) return;
-                        if (!getBool    ( NULL,         &buff.CC.ENABLE_NMEA2000_RAT           )) return;
-                        
-                        break;
-                        
-                        
-                default:        return;
-                }
 
 
-            write_CCS_EEPROM(&buff.CC);                                         // Save back the new CAN Configuration structure
-            send_AOK();                                                         // Let user know we understand.
-            return;                                                             // And return to see if more commands are being sent.  User must issue $RBT command for changes
-                                                                                //   to be loaded into regulators working memory.
-            }
-            #endif  // SYSTEMCAN
+void cmd_PG(void) {                                                     // Something to do with the PID Gains . . .
+    PIDS     pg;
 
+    if (systemConfig.CONFIG_LOCKOUT != 0)       return;                 // If system is locked-out, do not allow any changes...
 
+    pg = pidGains;                                                      // Start with the gains now in use (which are any saved in FLASH, or the defaults)
 
+    switch (ibBuf[2]) {
+        case 'V':                                                       // $PGV: <Kp>, <Ki>, <Kd>       Battery Voltage
+                if (!getFloat(0, &pg.KP_V,  0.0, 200.0)) return;
+                if (!getFloat(1, &pg.KI_V,  0.0, 200.0)) return;
+                if (!getFloat(2, &pg.KD_V,  0.0, 500.0)) return;
+                break;
 
+        case 'A':                                                       // $PGA: <Kp>, <Ki>, <Kd>       Alternator Amps
+                if (!getFloat(0, &pg.KP_A,  0.0,  20.0)) return;
+                if (!getFloat(1, &pg.KI_A,  0.0,  20.0)) return;
+                if (!getFloat(2, &pg.KD_A,  0.0,  20.0)) return;
+                break;
 
+        case 'W':                                                       // $PGW: <Kp>, <Ki>, <Kd>       Alternator Watts
+                if (!getFloat(0, &pg.KP_W,  0.0,   5.0)) return;
+                if (!getFloat(1, &pg.KI_W,  0.0,   5.0)) return;
+                if (!getFloat(2, &pg.KD_W,  0.0,   5.0)) return;
+                break;
 
+        case 'T':                                                       // $PGT: <Kp>, <Kd>             Alternator Temperature
+                if (!getFloat(0, &pg.KP_TA, 0.0,  20.0)) return;
+                if (!getFloat(1, &pg.KD_TA, 0.0,  20.0)) return;
+                break;
 
-                        //---   Finally, check for some of the other commands, ones that do not fit a good pattern to allow a CASE statement to be used.
-                        //
-                        //
+        case 'L':                                                       // $PGL: <I windup cap>, <PWM change rate (mS)>      Loop
+                if (!getFloat(0, &pg.I_WINDUP_CAP, 0.0, 10.0)) return;
+                if (!getInt  (1, &pg.CHANGE_RATE,  20,  1000)) return;
+                break;
 
+        case 'R':                                                       // RESTORES PID Gains to default
+                write_PID_EEPROM(NULL);                                 // Erase any saved pidGains structure in the EEPROM
+                send_AOK();                                             // Let user know we understand.
+                return;                                                 // All done.  (Defaults will be used after the next $RBT)
 
-        if ((ibBuf[0] == 'E') && (ibBuf[1] == 'B') && (ibBuf[2] == 'A')) {      // $EBA:  External Battery Amps?
-                if (systemConfig.CONFIG_LOCKOUT > 1)    return;                 // If system is locked-out, do not allow Override!
+        default:        return;
+        }
 
-                float proposedBatAmps;
-                
-                if (getFloat ((ibBuf + 4), &proposedBatAmps, -500.0,  500.0)) { // Get the externally supplied Battery Amps.
-                        EORLastReceived = millis();                             // Looks like we got a good one, note the time received.
-                        usingEXTAmps    = true;
-                        measuredBatAmps = proposedBatAmps;                      // Only change if a valid number is sent to us, else just leave the existing value alone.
-                        send_AOK();                                             // Let user know we understand.
-                        }                
-                return;
-                }
 
+    write_PID_EEPROM(&pg);                                              // Save the new gains,
+    pidGains = pg;                                                      //  and start using them on the next PWM adjustment - no need to $RBT.
+    scale_PID_gains();
+    send_AOK();                                                         // Let user know we understand.
+}
 
 
-        if ((ibBuf[0] == 'E') && (ibBuf[1] == 'D') && (ibBuf[2] == 'B')) {      // $EDB:  Enable DeBug ASCII string??
-                send_AOK();                                                     // Let user know we understand.
-  
-                SDMCounter      = SDM_SENSITIVITY;                              // Yes, set up the counters and turn on the switch!
-                sendDebugString = true;
-                }
 
 
 
-        if ((ibBuf[0] == 'M') && (ibBuf[1] == 'S') && (ibBuf[2] == 'R')) {      // $MSR:  Master System Restore?
-                if (systemConfig.CONFIG_LOCKOUT != 0)   return;                 // If system is locked-out, do not allow restore.
 
-                send_AOK();                                                     // Let user know we understand.
-                restore_all();                                                  // Yes.  Erase all the EEPROM and reset. (we will not come back from here)
-                }                                                               //  btw: doing individual character compares as done here uses about 25 bytes less
-                                                                                // code then using  -- strstr(ibBuf,"MSR") != NULL -- 
+#ifdef SYSTEMCAN
+void cmd_CC(void) {                                                     // Something to do with the CAN Configuration . . .
+    CCS      cc;
 
+    if (systemConfig.CONFIG_LOCKOUT != 0)       return;                 // If system is locked-out, do not allow any changes...
 
 
-        if ((ibBuf[0] == 'F') && (ibBuf[1] == 'R') && (ibBuf[2] == 'M')) {      // $FRM:  Force Regulator Mode ASCII string??
+    if (read_CCS_EEPROM(&cc) != true)                                   // Prime the work buffer with anything already in FLASH
+         cc = canConfig;                                                //   (or the default values if FLASH is empty / invalid)
 
-                switch (ibBuf[4]) {                                             // SHOULD be an ASCII character following the ':', if note, will hold NULL
-                        case 'B':       set_ALT_mode(bulk_charge);              //  B   = Force into BULK mode.
-                                        break;
 
-                        case 'A':       set_ALT_mode(acceptance_charge);        //  A   = Force into ACCEPTANCE mode.
-                                        break;
+    switch (ibBuf[2]) {
 
-                        case 'O':       set_ALT_mode(overcharge_charge);        //  O   = Force into OVER-CHARGE mode.
-                                        break;
 
-                        case 'F':       set_ALT_mode(float_charge);             //  F   = Force into FLOAT mode.
-                                        break;
+        case 'R':                                                       // RESTORES CAN Configuration table to default
+                write_CCS_EEPROM(NULL);                                 // Erase any saved CANConfig structure in the EEPROM
+                send_AOK();                                             // Let user know we understand.
+                return;                                                 // All done.
 
-                        case 'P':       set_ALT_mode(post_float);               //  P   = Force into POST-FLOAT mode.
-                                        break;
 
-                        case 'E':       set_ALT_mode(equalize);                 //  E   = Force into EQUALIZE mode.
-                                        break;
 
-                        default:        return;                                 // Not something we understand..
-                        }
+       case 'N':                                                       // Can CoNfiguration
+                                                                       //$CCN:    <Battery Instance Override>, <Device Instance >, <Device Priority>,
+                                                                       //         <AllowRMB?>, <ShuntAtBat?>,  <Enable-OSE?>, <Enable-NMEA2000?>, <Enable_NMEA2000_RAT?>
+                if (!getByte    (0, &cc.BI_OVERRIDE,         0,  100  )) return;
+                if (!getByte    (1, &cc.DEVICE_INSTANCE,     1,   13  )) return;
+                if (!getByte    (2, &cc.DEVICE_PRIORITY,     1,  250  )) return;
+                if (!getBool    (3, &cc.CONSIDER_MASTER               )) return;
+                if (!getBool    (4, &cc.SHUNT_AT_BAT                  )) return;
+                if (!getBool    (5, &cc.ENABLE_OSE                    )) return;
+                if (!getBool    (6, &cc.ENABLE_NMEA2000               )) return;
+                if (!getBool    (7, &cc.ENABLE_NMEA2000_RAT           )) return;
 
+                break;
 
-                send_AOK();                                                     // One got through!  Let user know we understand.
-                return;  
-                }
 
+        default:        return;
         }
 
+
+    write_CCS_EEPROM(&cc);                                              // Save back the new CAN Configuration structure
+    send_AOK();                                                         // Let user know we understand.
+                                                                        // User must issue $RBT command for changes to be loaded into regulators working memory.
+}
+#endif  // SYSTEMCAN
+
+
+
+
+
+
+
+                //---   And some of the other commands, ones that do not fit a good pattern.
+                //
+
+
+void cmd_EBA(void) {                                                    // $EBA:  External Battery Amps?
+    float proposedBatAmps;
+
+    if (systemConfig.CONFIG_LOCKOUT > 1)    return;                     // If system is locked-out, do not allow Override!
+
+    if (getFloat (0, &proposedBatAmps, -500.0,  500.0)) {     // Get the externally supplied Battery Amps.
+            EORLastReceived = millis();                                 // Looks like we got a good one, note the time received.
+            usingEXTAmps    = true;
+            measuredBatAmps = proposedBatAmps;                          // Only change if a valid number is sent to us, else just leave the existing value alone.
+            send_AOK();                                                 // Let user know we understand.
+            }
+}
+
+
+
+void cmd_EDB(void) {                                                    // $EDB:  Enable DeBug ASCII string??
+    send_AOK();                                                         // Let user know we understand.
+
+    SDMCounter      = SDM_SENSITIVITY;                                  // Yes, set up the counters and turn on the switch!
+    sendDebugString = true;
+}
+
+
+
+void cmd_MSR(void) {                                                    // $MSR:  Master System Restore?
+    if (systemConfig.CONFIG_LOCKOUT != 0)   return;                     // If system is locked-out, do not allow restore.
+
+    send_AOK();                                                         // Let user know we understand.
+    restore_all();                                                      // Yes.  Erase all the EEPROM and reset. (we will not come back from here)
+}
+
+
+
+void cmd_FRM(void) {                                                    // $FRM:  Force Regulator Mode ASCII string??
+
+    switch (ibBuf[4]) {                                                 // SHOULD be an ASCII character following the ':', if note, will hold NULL
+            case 'B':       set_ALT_mode(bulk_charge);                  //  B   = Force into BULK mode.
+                            break;
+
+            case 'A':       set_ALT_mode(acceptance_charge);            //  A   = Force into ACCEPTANCE mode.
+                            break;
+
+            case 'O':       set_ALT_mode(overcharge_charge);            //  O   = Force into OVER-CHARGE mode.
+                            break;
+
+            case 'F':       set_ALT_mode(float_charge);                 //  F   = Force into FLOAT mode.
+                            break;
+
+            case 'P':       set_ALT_mode(post_float);                   //  P   = Force into POST-FLOAT mode.
+                            break;
+
+            case 'E':       set_ALT_mode(equalize);                     //  E   = Force into EQUALIZE mode.
+                            break;
+
+            case 'T':       if ((systemConfig.CONFIG_LOCKOUT != 0) ||       //  T   = Auto-Tune the Voltage PID gains.  (It will change them, so not if locked-out,
+                                (systemConfig.BT_CONFIG_CHANGED == false))  //        nor while write_PID_EEPROM() would quietly not save what it found)
+                                    return;
+                            set_ALT_mode(auto_tune_V);
+                            break;
+
+            default:        return;                                     // Not something we understand..
+            }
+
+
+    send_AOK();                                                         // One got through!  Let user know we understand.
 }
 
 
@@ -584,49 +724,51 @@ void check_inbound()  {
 
 
 //---- Helper functions for Check_inbound()
-bool getInt(char *buffer, int *dest, int LLim, int HLim) {
-    char* cp;
-        cp = strtok(buffer, ",");
-        if (cp == NULL)  return(false); 
-        *dest = constrain(atoi(cp), LLim, HLim);        
+//      Each fetches the numbered field found by the tokenizer while ibBuf was being filled.  (Field 0 is the first one after the ':')
+bool getInt(uint8_t field, int *dest, int LLim, int HLim) {
+    long v;
+        if (!token_scaled(&ibTokens, field, 0, &v))  return(false); 
+        *dest = constrain(v, LLim, HLim);        
         return(true);
    }
 
-bool getByte(char *buffer, uint8_t *dest, uint8_t LLim, uint8_t HLim) {
-    char* cp;
-        cp = strtok(buffer, ",");
-        if (cp == NULL)  return(false); 
-        *dest = (uint8_t) constrain(atoi(cp), LLim, HLim);        
+bool getByte(uint8_t field, uint8_t *dest, uint8_t LLim, uint8_t HLim) {
+    long v;
+        if (!token_scaled(&ibTokens, field, 0, &v))  return(false); 
+        *dest = (uint8_t) constrain(v, LLim, HLim);        
         return(true);
    }
 
-bool getDuration(char *buffer, unsigned long *dest,  int HLim) {
-     char* cp;
-        cp = strtok(buffer, ",");
-        if (cp == NULL)  return(false); 
-        *dest = (unsigned long) (constrain(atoi(cp), 0, HLim)) * 60000UL;               // Noticed, EVERY duration has this 60000UL multiplier and 0 LLim, so no need to pass as separate parameter...
+bool getDuration(uint8_t field, unsigned long *dest,  int HLim) {
+    long v;
+        if (!token_scaled(&ibTokens, field, 0, &v))  return(false); 
+        *dest = (unsigned long) (constrain(v, 0, HLim)) * 60000UL;                      // Noticed, EVERY duration has this 60000UL multiplier and 0 LLim, so no need to pass as separate parameter...
         return(true);
    }
 
 
-bool getFloat(char *buffer, float *dest, float LLim, float HLim) {
-    char* cp;
-        cp = strtok(buffer, ",");
-        if (cp == NULL)  return(false); 
-        *dest = constrain(atof(cp), LLim, HLim);        
+bool getFloat(uint8_t field, float *dest, float LLim, float HLim) {
+    float v;
+        if (!token_float(&ibTokens, field, &v))  return(false); 
+        *dest = constrain(v, LLim, HLim);        
         return(true);
    }
 
 
-bool getBool(char *buffer, bool *dest) {
-    char* cp;
-        cp = strtok(buffer, ",");
-        if (cp == NULL)  return(false); 
-        *dest = (atoi(cp) == 1);        
+bool getBool(uint8_t field, bool *dest) {
+    long v;
+        if (!token_scaled(&ibTokens, field, 0, &v))  return(false); 
+        *dest = (v == 1);        
         return(true);
    }   
 
 
+char *getString(uint8_t field) {                                        // Text fields are left NULL terminated in ibBuf by the tokenizer.
+        if (field >= ibTokens.count)  return(NULL); 
+        return(ibBuf + ibTokens.start[field]);
+   }
+
+
 void send_AOK(void) {
     Serial.write("AOK;\r\n");                               
     
@@ -645,62 +787,120 @@ void send_AOK(void) {
 //      This function will send to the Serial Terminal the current system status.  It is used to send
 //      information primarily via the Bluetooth to an external HUI program.  
 //
-//      If pushAll is TRUE, no check will be made in timing or counters to pace the rate of data
+//      Rather then sending each status string on a fixed rotation, a string is sent when its contents 
+//      have changed, or it has become too old.  The Alternator Status is checked against a deadband of 
+//      its fast moving values (Volts, Amps, Field PWM and charge mode) every STATUS_CHECK_RATE, and sent
+//      at least every UPDATE_STATUS_RATE for the rest of its values.  The not-so-critical strings take turns being hashed to see if anything at all in them has changed.
+//      This keeps the 9600 baud Bluetooth link from being filled with repeats of unchanged information
+//      and lets changes go out quickly.
+//
+//      If pushAll is TRUE, no check will be made in timing or changes to pace the rate of data
 //      being sent and a copy of all status strings will be sent.  This is usefull in the case of FAULTED condition.
 //
 //      
 // 
 //------------------------------------------------------------------------------------------------------
 
+#define NUM_STATUS_STRINGS      7                                                               // AST, SST, CST, CPE, SCV, NPC, LST
+
+
+void prep_status(uint8_t i, tPutChar put) {                                                     // Helper function, send the i'th status string to put()
+    switch (i) {
+        case 0:  prep_AST(put);                          break;                                 // Alternator STatus
+        case 1:  prep_SST(put);                          break;                                 // System Status
+        case 2:  prep_CST(put);                          break;                                 // CAN Control Variables  (n/a on 1st gen regulator)
+        case 3:  prep_CPE(put, &workingParms, cpIndex);  break;                                 // Currently active charge profile
+        case 4:  prep_SCV(put);                          break;                                 // System Control Variables
+        case 5:  prep_NPC(put);                          break;                                 // Name/Password (was Bluetooth) Config. 
+        case 6:  prep_LST(put);                          break;                                 // Limiter STatus
+        }
+}
+
+
+void put_hash(char c) {                                                                         // put() function used to hash a status string, as opposed to sending it.
+    statusHash = ((statusHash << 5) + statusHash) ^ c;                                          // (16-bit version of Bernstein's hash)
+}
+
+
+
 
 void  send_outbound(bool pushAll) {
-    char    charBuffer[OUTBOUND_BUFF_SIZE+1];                                                       // Large working buffer to assemble strings before sending to the serial port.
-    uint8_t i, j;
-    unsigned long static lastStatusSent = 0U;                                                        // When was the Status last sent?
+    uint8_t  i, j;
+    bool     changed;
+    unsigned long static lastChecked = 0U;                                                      // When were the Status strings last looked at?
+    unsigned long static lastSent[NUM_STATUS_STRINGS];                                          // When was each string last sent?
+    uint16_t      static lastHash[NUM_STATUS_STRINGS];                                          // And what did the non-critical ones look like then?
+    float         static lastASTVolts = 0.0;                                                    // Fast moving AST values as last sent
+    float         static lastASTAmps  = 0.0;
+    int           static lastASTPWM   = 0;
+    tModes        static lastASTState = unknown;
+    float         static lastASTBatAmps  = 0.0;                                                 // Slower moving AST values as last sent
+    float         static lastASTAltVolts = 0.0;
+    int           static lastASTRPMs     = 0;
+    uint16_t      static lastASTSlowHash = 0;                                                   // (The rest of them, see ASTSlowFields)
 
 
 
  if (!pushAll)  {                                                                               // Check to see if we need to be pacing the strings out.
-    if ((millis() - lastStatusSent) < UPDATE_STATUS_RATE)     return;                           // Looks like it, Time to send Update packet?  No, not just yet.
+    if ((millis() - lastChecked) < STATUS_CHECK_RATE)         return;                           // Looks like it, Time to look at the Status?  No, not just yet.
     if( ibBufFilling == true)                                 return;                           // Suspend the sending of status updates while a new command is being assembled.
     }                                                                                           // This way there is no confusion over data received from the regulator as to if it
                                                                                                 // is a response to a request-for command, or just the 'normal' status data being pushed out.
-
+  lastChecked = millis();
 
 
                                 //----- Send status strings via the serial port. 
-                                //      Make sure to 'space them out', sending every once and a while - not all in one block...
+                                //      The AST is looked at each time, the non-critical strings take turns - so as to spread out the work of hashing them.
 
-  j = UMCounter % UPDATE_MAJOR_SENSITIVITY;
+  j = UMCounter + 1;                                                                            // Non-critical strings take turns, 1..NUM_STATUS_STRINGS-1
    
-  for (i=0; i <= 5; i++) {                                                                  // Loop through all strings, seeing which ones we should send this time.
-      charBuffer[0] = '\0';  
-      
-      if (i == 0)                                                                 prep_AST(charBuffer);                          // Alternator STatus goes each cycle through                                              
-      if((i == 1)  &&  ((j == ((1*UPDATE_MAJOR_SENSITIVITY/5)-1)) || (pushAll)))  prep_SST(charBuffer);                          // Send the System Status
-      if((i == 2)  &&  ((j == ((2*UPDATE_MAJOR_SENSITIVITY/5)-1)) || (pushAll)))  prep_CST(charBuffer);                          // Send the CAN Control Variables  (n/a on 1st gen regulator)
-      if((i == 3)  &&  ((j == ((3*UPDATE_MAJOR_SENSITIVITY/5)-1)) || (pushAll)))  prep_CPE(charBuffer, &workingParms, cpIndex);  // Send the currently active charge profile
-      if((i == 4)  &&  ((j == ((4*UPDATE_MAJOR_SENSITIVITY/5)-1)) || (pushAll)))  prep_SCV(charBuffer);                          // Send the System Control Variables (using this buffer as a work space)
-      if((i == 5)  &&  ((j == ((5*UPDATE_MAJOR_SENSITIVITY/5)-1)) || (pushAll)))  prep_NPC(charBuffer);                          // Send the Name/Password (was Bluetooth) Config. 
-
-
-
-      if (charBuffer[0] != '\0') {                                                           // Was a string prepared for us to send?
-          Serial.write(charBuffer); 
-
-          #ifdef SYSTEMCAN
-            CAN_ASCII_write(charBuffer);                                                      //  Send this vai a a CAN-wrapper as well (if someone from the CAN asked for it!)
-            #endif    
+  for (i=0; i < NUM_STATUS_STRINGS; i++) {                                                      // Loop through all strings, seeing which ones we should send this time.
+
+      if (i == 0) {
+          statusHash = 0;
+          prep_AST_slow(put_hash);                                                              // Temperatures, targets, .. that need no deadband
+          changed = ((abs(measuredBatVolts - lastASTVolts)    >= AST_VOLTS_DEADBAND) ||
+                     (abs(measuredAltAmps  - lastASTAmps)     >= AST_AMPS_DEADBAND)  ||
+                     (abs(fieldPWMvalue    - lastASTPWM)      >= AST_PWM_DEADBAND)   ||
+                     (alternatorState != lastASTState)                               ||
+                     (abs(measuredBatAmps  - lastASTBatAmps)  >= AST_AMPS_DEADBAND)  ||
+                     (abs(measuredAltVolts - lastASTAltVolts) >= AST_VOLTS_DEADBAND) ||
+                     (abs(measuredRPMs     - lastASTRPMs)     >= AST_RPM_DEADBAND)   ||
+                     (statusHash != lastASTSlowHash));
           }
 
-             
-   }
-   
-
-  lastStatusSent = millis();
-  UMCounter++;
+      else if ((i == j) || (pushAll)) {
+          statusHash = 0;
+          prep_status(i, put_hash);                                                             // Run the string through the hash to see if anything in it has changed.
+          changed = (statusHash != lastHash[i]);
+          }
+          
+      else 
+          continue;                                                                             // Not this strings turn to be looked at.
+
+
+      if ((!pushAll) && (!changed) &&
+          ((millis() - lastSent[i]) < ((i == 0) ? UPDATE_STATUS_RATE : UPDATE_MAJOR_RATE)))   continue;     // Nothing new to say, and not too old yet.
+
+      prep_status(i, put_outbound);                                                             // Stream it directly out the Serial port and CAN terminal.
+      lastSent[i] = millis();
+
+      if (i == 0) {                                                                             // Remember what we just told them.
+          lastASTVolts = measuredBatVolts;
+          lastASTAmps  = measuredAltAmps;
+          lastASTPWM   = fieldPWMvalue;
+          lastASTState = alternatorState;
+          lastASTBatAmps  = measuredBatAmps;
+          lastASTAltVolts = measuredAltVolts;
+          lastASTRPMs     = measuredRPMs;
+          lastASTSlowHash = statusHash;
+          }
+      else
+          lastHash[i]  = statusHash;
+      }
 
- 
+  if (++UMCounter >= (NUM_STATUS_STRINGS-1))                                                    // Wrapped here, rather then left to roll over as a uint8_t:  256 is not
+      UMCounter = 0;                                                                            //  a multiple of 6, and the turns would skip about at the roll over.
 }
 
 
@@ -713,179 +913,254 @@ void  send_outbound(bool pushAll) {
 //------------------------------------------------------------------------------------------------------
 // Prep Outbound strings 
 //
-//      These functions will assemble the outbound strings into the passed buffer.
-//      Note that the passed buffer MUST BE AT LEAST 'OUTBOUND_BUFF_SIZE' in size.
+//      These functions will stream the outbound strings one character at a time to the passed
+//      put() function, working from a PROGMEM table of field descriptors for each string.
+//      No working buffer is needed, nor the overhead of snprintf_P().
 //      
 // 
 //------------------------------------------------------------------------------------------------------
 
 
 
-void prep_AST(char *buffer) {                                                           // Assembled the Alternator Status ASCII string.  Pass in working buffer of BUFF_SIZE
-                                                                                        //  Alternator STatus - sent very often
-    snprintf_P(buffer,OUTBOUND_BUFF_SIZE, PSTR("AST;,%d.%02d, ,%s,%s,%s,%d, ,%s,%d,%d,%d, ,%d,%d, ,%d, ,%s,%d,%d,%d\r\n"),
-        (int)  (generatorLrRunTime / (3600UL * 1000UL)),                                // Runtime Hours
-        (int) ((generatorLrRunTime / (3600UL * 10UL  )) % 100),                         // Runtime 1/100th
+                                //----- Values that are not simply a variable are calculated by small helper functions referenced from the tables.
+static long calc_runtime(void)   { return(generatorLrRunTime / (3600UL * 10UL));  }                    // Runtime in 1/100th of an hour, sent as Hours.xx
+static long calc_altTemp(void)   { return(max(measuredAltTemp, measuredAlt2Temp)); }
+static long calc_fieldPWM(void)  { return((100*fieldPWMvalue) / FIELD_PWM_MAX);    }                    // Field drive in %
+static long calc_altState(void)  { return(alternatorState);                        }
+static long calc_cpIndex(void)   { return(cpIndex + 1);                            }                    // Convert from "0-origin" of array indexes for display
+static long calc_AHs(void)       { return((int)((accumulatedLrAH / 3600UL)  * (ACCUMULATE_SAMPLING_RATE / 1000UL))); }   // Convert into actual AHs
+static long calc_WHs(void)       { return((int)((accumulatedLrWH / 3600UL)  * (ACCUMULATE_SAMPLING_RATE / 1000UL))); }   // Convert into actual WHs
+static long calc_tachPWM(void)   { return((systemConfig.FIELD_TACH_PWM>0) ? ((100*systemConfig.FIELD_TACH_PWM)/FIELD_PWM_MAX) : systemConfig.FIELD_TACH_PWM); }
+#ifdef SYSTEMCAN
+static long calc_localID(void)   { return(fetch_CAN_localID());                    }
+#endif
 
-	floatString(measuredBatVolts, 2),
-	floatString(measuredAltAmps, 1),
-	floatString(measuredBatAmps, 1),
-        measuredAltWatts, 
 
-        
-	floatString(targetBatVolts, 2),
-        (int)    targetAltAmps,
-        targetAltWatts,
-        alternatorState,
 
-        measuredBatTemp,                                                               // In deg C
-        max(measuredAltTemp, measuredAlt2Temp),
+const tStatusField ASTFields[] PROGMEM = {                                              //  Alternator STatus - sent very often
+        SF_FUNC(",",   2, calc_runtime),
+        SF_VAR (", ,", SF_FLOAT, 2, measuredBatVolts),
+        SF_VAR (",",   SF_FLOAT, 1, measuredAltAmps),
+        SF_VAR (",",   SF_FLOAT, 1, measuredBatAmps),
+        SF_VAR (",",   SF_INT,   0, measuredAltWatts),
 
+        SF_VAR (", ,", SF_FLOAT, 2, targetBatVolts),
+        SF_VAR (",",   SF_FLOAT, 0, targetAltAmps),
+        SF_VAR (",",   SF_INT,   0, targetAltWatts),
+        SF_FUNC(",",   0, calc_altState),
 
-        measuredRPMs,
-        
-	floatString(measuredAltVolts, 2),
-        measuredFETTemp,
-        measuredFieldAmps,
-        ((100*fieldPWMvalue) / FIELD_PWM_MAX) );
-        }
+        SF_VAR (", ,", SF_INT,   0, measuredBatTemp),                                  // In deg C
+        SF_FUNC(",",   0, calc_altTemp),
 
+        SF_VAR (", ,", SF_INT,   0, measuredRPMs),
 
+        SF_VAR (", ,", SF_FLOAT, 2, measuredAltVolts),
+        SF_VAR (",",   SF_INT,   0, measuredFETTemp),
+        SF_VAR (",",   SF_INT,   0, measuredFieldAmps),
+        SF_FUNC(",",   0, calc_fieldPWM),
+        SF_EOL};
 
 
-void prep_CPE(char *buffer, CPS  *cpsPtr, int index) {                     
-   snprintf_P(buffer,OUTBOUND_BUFF_SIZE, PSTR("CPE;,%d,%s,%d,%d,%d, ,%d,%d,%s,%d, ,%s,%d,%d,%d,%d,%s, ,%d,%s,%d, ,%s,%d,%d,%d, ,%s,%d,%d,%d\r\n"),
-                        (index + 1),                                                                        // Convert from "0-origin" of array indexes for display
-			floatString(cpsPtr->ACPT_BAT_V_SETPOINT, 2),
-        (unsigned int)  (cpsPtr->EXIT_ACPT_DURATION/60000UL),                                               // Show time running in Minutes, as opposed to mS
-                         cpsPtr->EXIT_ACPT_AMPS,
-        (int)             0,                                                                                // Place holder for future dV/dT exit parameter, hard coded = 0 for now.
+const tStatusField ASTSlowFields[] PROGMEM = {                                          //  The AST values send_outbound() watches for any change in, rather then
+        SF_VAR (",",   SF_FLOAT, 2, targetBatVolts),                                    //   by a deadband.  (Hashed, never sent)
+        SF_VAR (",",   SF_FLOAT, 0, targetAltAmps),
+        SF_VAR (",",   SF_INT,   0, targetAltWatts),
+        SF_VAR (",",   SF_INT,   0, measuredBatTemp),
+        SF_FUNC(",",   0, calc_altTemp),
+        SF_VAR (",",   SF_INT,   0, measuredFETTemp),
+        SF_VAR (",",   SF_INT,   0, measuredFieldAmps),
+        SF_EOL};
 
-                         cpsPtr->LIMIT_OC_AMPS,
-        (unsigned int)  (cpsPtr->EXIT_OC_DURATION/60000UL),
-			floatString(cpsPtr->EXIT_OC_VOLTS, 2),
-        (int)            0,                                                                                 // Place holder for future dV/dT exit parameter, hard coded = 0 for now.
 
+const tStatusField CPEFields[] PROGMEM = {                                              //  Charge Profile Entry, offsets into the passed CPS structure.
+        SF_MEMBER(",",   SF_FLOAT,   2, CPS, ACPT_BAT_V_SETPOINT),
+        SF_MEMBER(",",   SF_MINUTES, 0, CPS, EXIT_ACPT_DURATION),                      // Show time running in Minutes, as opposed to mS
+        SF_MEMBER(",",   SF_INT,     0, CPS, EXIT_ACPT_AMPS),
+        SF_MEMBER(",",   SF_FLOAT,   1, CPS, EXIT_ACPT_DIDT),
+
+        SF_MEMBER(", ,", SF_INT,     0, CPS, LIMIT_OC_AMPS),
+        SF_MEMBER(",",   SF_MINUTES, 0, CPS, EXIT_OC_DURATION),
+        SF_MEMBER(",",   SF_FLOAT,   2, CPS, EXIT_OC_VOLTS),
+        SF_LIT   (",0"),                                                                // Place holder for future dV/dT exit parameter, hard coded = 0 for now.
 
-	floatString(cpsPtr->FLOAT_BAT_V_SETPOINT, 2),
-                         cpsPtr->LIMIT_FLOAT_AMPS,
-        (unsigned int)  (cpsPtr->EXIT_FLOAT_DURATION/60000UL),
-                         cpsPtr->FLOAT_TO_BULK_AMPS,
-                         cpsPtr->FLOAT_TO_BULK_AHS,
-			 floatString(cpsPtr->FLOAT_TO_BULK_VOLTS, 2),
-        
-        (unsigned int)   (cpsPtr->EXIT_PF_DURATION/60000UL),                                                //  Show in Minutes, as opposed to mS,
-        floatString(cpsPtr->PF_TO_BULK_VOLTS, 2),
-                          cpsPtr->PF_TO_BULK_AHS,
-
-			  floatString(cpsPtr->EQUAL_BAT_V_SETPOINT, 2),
-                          cpsPtr->LIMIT_EQUAL_AMPS,
-        (unsigned int)   (cpsPtr->EXIT_EQUAL_DURATION/60000UL),                                             //  Show in Minutes, as opposed to mS,
-                          cpsPtr->EXIT_EQUAL_AMPS ,
-
-        floatString(cpsPtr->BAT_TEMP_1C_COMP, 3),
-                          cpsPtr->MIN_TEMP_COMP_LIMIT,
-                          cpsPtr->BAT_MIN_CHARGE_TEMP,
-                          cpsPtr->BAT_MAX_CHARGE_TEMP);
-        }
+        SF_MEMBER(", ,", SF_FLOAT,   2, CPS, FLOAT_BAT_V_SETPOINT),
+        SF_MEMBER(",",   SF_INT,     0, CPS, LIMIT_FLOAT_AMPS),
+        SF_MEMBER(",",   SF_MINUTES, 0, CPS, EXIT_FLOAT_DURATION),
+        SF_MEMBER(",",   SF_INT,     0, CPS, FLOAT_TO_BULK_AMPS),
+        SF_MEMBER(",",   SF_INT,     0, CPS, FLOAT_TO_BULK_AHS),
+        SF_MEMBER(",",   SF_FLOAT,   2, CPS, FLOAT_TO_BULK_VOLTS),
 
+        SF_MEMBER(", ,", SF_MINUTES, 0, CPS, EXIT_PF_DURATION),                        //  Show in Minutes, as opposed to mS,
+        SF_MEMBER(",",   SF_FLOAT,   2, CPS, PF_TO_BULK_VOLTS),
+        SF_MEMBER(",",   SF_INT,     0, CPS, PF_TO_BULK_AHS),
 
+        SF_MEMBER(", ,", SF_FLOAT,   2, CPS, EQUAL_BAT_V_SETPOINT),
+        SF_MEMBER(",",   SF_INT,     0, CPS, LIMIT_EQUAL_AMPS),
+        SF_MEMBER(",",   SF_MINUTES, 0, CPS, EXIT_EQUAL_DURATION),                     //  Show in Minutes, as opposed to mS,
+        SF_MEMBER(",",   SF_INT,     0, CPS, EXIT_EQUAL_AMPS),
 
-void prep_SCV(char *buffer) {                                                                               // Prep the System Control Variables.  Pass in working buffer of OUTBOUND_BUFF_SIZE
-        snprintf_P(buffer, OUTBOUND_BUFF_SIZE, PSTR("SCV;,%1u,,%1u,%s,%s,%1u, ,%d,%s,%s,%s,%d, ,%d,%d, ,%d,%s,%d, ,%d,%d\r\n"),
-                  systemConfig.CONFIG_LOCKOUT,
-                  // REDACTED --> systemConfig.FAVOR_32V_redact,
-                  systemConfig.REVERSED_SHUNT,
-		  floatString(systemConfig.SV_OVERRIDE, 2),
-		  floatString(systemConfig.BC_MULT_OVERRIDE, 2),
-                  systemConfig.CP_INDEX_OVERRIDE,
+        SF_MEMBER(", ,", SF_FLOAT,   3, CPS, BAT_TEMP_1C_COMP),
+        SF_MEMBER(",",   SF_INT,     0, CPS, MIN_TEMP_COMP_LIMIT),
+        SF_MEMBER(",",   SF_INT,     0, CPS, BAT_MIN_CHARGE_TEMP),
+        SF_MEMBER(",",   SF_INT,     0, CPS, BAT_MAX_CHARGE_TEMP),
+        SF_EOL};
 
 
-                  systemConfig.ALT_TEMP_SETPOINT,
-		  floatString(systemConfig.ALT_AMP_DERATE_NORMAL, 2),
-		  floatString(systemConfig.ALT_AMP_DERATE_SMALL_MODE, 2),
-		  floatString(systemConfig.ALT_AMP_DERATE_HALF_POWER, 2),
-                  systemConfig.ALT_PULLBACK_FACTOR,
+const tStatusField SCVFields[] PROGMEM = {                                              //  System Control Variables
+        SF_VAR (",",   SF_UINT8, 0, systemConfig.CONFIG_LOCKOUT),
+                                                                                        // REDACTED --> systemConfig.FAVOR_32V_redact,
+        SF_VAR (",,",  SF_UINT8, 0, systemConfig.REVERSED_SHUNT),
+        SF_VAR (",",   SF_FLOAT, 2, systemConfig.SV_OVERRIDE),
+        SF_VAR (",",   SF_FLOAT, 2, systemConfig.BC_MULT_OVERRIDE),
+        SF_VAR (",",   SF_UINT8, 0, systemConfig.CP_INDEX_OVERRIDE),
 
-                  systemConfig.ALT_AMPS_LIMIT,
-                  systemConfig.ALT_WATTS_LIMIT,
+        SF_VAR (", ,", SF_UINT8, 0, systemConfig.ALT_TEMP_SETPOINT),
+        SF_VAR (",",   SF_FLOAT, 2, systemConfig.ALT_AMP_DERATE_NORMAL),
+        SF_VAR (",",   SF_FLOAT, 2, systemConfig.ALT_AMP_DERATE_SMALL_MODE),
+        SF_VAR (",",   SF_FLOAT, 2, systemConfig.ALT_AMP_DERATE_HALF_POWER),
+        SF_VAR (",",   SF_INT,   0, systemConfig.ALT_PULLBACK_FACTOR),
 
-                  systemConfig.ALTERNATOR_POLES,
-		  floatString(systemConfig.ENGINE_ALT_DRIVE_RATIO, 3),
-                  systemConfig.AMP_SHUNT_RATIO,
-                  
-                  systemConfig.ALT_IDLE_RPM,
-                  ((systemConfig.FIELD_TACH_PWM>0) ? ((100*systemConfig.FIELD_TACH_PWM)/FIELD_PWM_MAX) : systemConfig.FIELD_TACH_PWM));
-        }
+        SF_VAR (", ,", SF_INT,   0, systemConfig.ALT_AMPS_LIMIT),
+        SF_VAR (",",   SF_INT,   0, systemConfig.ALT_WATTS_LIMIT),
 
+        SF_VAR (", ,", SF_UINT8, 0, systemConfig.ALTERNATOR_POLES),
+        SF_VAR (",",   SF_FLOAT, 3, systemConfig.ENGINE_ALT_DRIVE_RATIO),
+        SF_VAR (",",   SF_INT,   0, systemConfig.AMP_SHUNT_RATIO),
 
+        SF_VAR (", ,", SF_INT,   0, systemConfig.ALT_IDLE_RPM),
+        SF_FUNC(",",   0, calc_tachPWM),
+        SF_EOL};
 
 
-void prep_NPC(char *buffer) {                                                                               // Prep the System Control Variable string.  Pass in working buffer of OUTBOUND_BUFF_SIZE
-        
-        snprintf_P(buffer, OUTBOUND_BUFF_SIZE-3, PSTR("NPC;,%1u,%s,%s\r\n"),                                // Prime things with the initial ASCII string..
-        systemConfig.USE_BT,
-        systemConfig.REG_NAME,
-        systemConfig.REG_PSWD);
+const tStatusField NPCFields[] PROGMEM = {                                              //  Name / Password Config
+        SF_VAR (",",   SF_UINT8, 0, systemConfig.USE_BT),
+        SF_VAR (",",   SF_STR,   0, systemConfig.REG_NAME),
+        SF_VAR (",",   SF_STR,   0, systemConfig.REG_PSWD),
+        SF_EOL};
+
+
+const tStatusField SSTFields[] PROGMEM = {                                              //  System Status
+        SF_VAR (",",   SF_STR,   0, firmwareVersion),
+
+        SF_VAR (", ,", SF_UINT8, 0, smallAltMode),
+        SF_VAR (",",   SF_UINT8, 0, tachMode),
+
+        SF_FUNC(", ,", 0, calc_cpIndex),
+        SF_VAR (",",   SF_FLOAT, 2, systemAmpMult),
+        SF_VAR (",",   SF_FLOAT, 2, systemVoltMult),
+
+        SF_VAR (", ,", SF_INT,   0, altCapAmps),
+        SF_VAR (",",   SF_INT,   0, altCapRPMs),
+
+        SF_FUNC(", ,", 0, calc_AHs),
+        SF_FUNC(",",   0, calc_WHs),
+
+        SF_VAR (", ,", SF_UINT8, 0, systemConfig.FORCED_TM),
+        SF_EOL};
+
+
+const tStatusField LSTFields[] PROGMEM = {                                              //  Limiter Status - who is holding back the Field now, and total minutes each has
+        SF_VAR (",",   SF_UINT8,   0, limiterInControl),                                //  done so while charging (see tLimiters)
+        SF_VAR (", ,", SF_MINUTES, 0, limiterTime[LIM_VOLTS]),
+        SF_VAR (",",   SF_MINUTES, 0, limiterTime[LIM_AMPS]),
+        SF_VAR (",",   SF_MINUTES, 0, limiterTime[LIM_WATTS]),
+        SF_VAR (",",   SF_MINUTES, 0, limiterTime[LIM_ALT_TEMP]),
+        SF_VAR (",",   SF_MINUTES, 0, limiterTime[LIM_RAMP]),
+        SF_VAR (",",   SF_MINUTES, 0, limiterTime[LIM_FIELD_MAX]),
+        SF_VAR (",",   SF_MINUTES, 0, limiterTime[LIM_DERATE]),
+        SF_VAR (",",   SF_MINUTES, 0, limiterTime[LIM_NONE]),
+        SF_EOL};
 
-        }
 
+#ifdef SYSTEMCAN
+const tStatusField CSTFields[] PROGMEM = {                                              //  CAN Control Variables
+        SF_VAR (",",    SF_UINT8, 0, batteryInstance),
+        SF_VAR (",",    SF_UINT8, 0, canConfig.BI_OVERRIDE),
+        SF_VAR (",",    SF_UINT8, 0, canConfig.DEVICE_INSTANCE),
+        SF_VAR (",",    SF_UINT8, 0, canConfig.DEVICE_PRIORITY),
+
+        SF_VAR (",  ,", SF_UINT8, 0, canConfig.ENABLE_NMEA2000),
+        SF_VAR (",",    SF_UINT8, 0, canConfig.ENABLE_OSE),
+
+        SF_VAR (",  ,", SF_UINT8, 0, canConfig.CONSIDER_MASTER),
+        SF_VAR (",",    SF_UINT8, 0, CAN_weAreRBM),
+        SF_VAR (",",    SF_UINT8, 0, canConfig.SHUNT_AT_BAT),
 
+        SF_VAR (", ,",  SF_UINT8, 0, CAN_RBM_sourceID),
+        SF_VAR (",",    SF_UINT8, 0, ignoringRBM),
+        SF_VAR (",",    SF_UINT8, 0, canConfig.ENABLE_NMEA2000_RAT),
 
+        SF_FUNC(",  ,", 0, calc_localID),
+        SF_EOL};
+#endif
 
 
 
-void prep_SST(char *buffer) { 
-        snprintf_P(buffer,OUTBOUND_BUFF_SIZE-3, PSTR("SST;,%s, ,%1u,%1u, ,%d,%s,%s, ,%d,%d, ,%d,%d, ,%1u\r\n"), //  System Status 
-                firmwareVersion,
 
-                smallAltMode,
-                tachMode,
+void prep_AST(tPutChar put) {                                                           // Alternator STatus - sent very often
+        stream_string_P(PSTR("AST;"), put);
+        stream_fields(ASTFields, NULL, put);
+        }
 
-                (int)   (cpIndex + 1),
-		floatString(systemAmpMult, 2),
-		floatString(systemVoltMult, 2),
 
-                altCapAmps,                                             
-                altCapRPMs,
+void prep_AST_slow(tPutChar put) {                                                      // Just the AST values that have no deadband, for send_outbound() to hash
+        stream_fields(ASTSlowFields, NULL, put);
+        }
 
-                (int)((accumulatedLrAH / 3600UL)  * (ACCUMULATE_SAMPLING_RATE / 1000UL)),               // Convert into actual AHs
-                (int)((accumulatedLrWH / 3600UL)  * (ACCUMULATE_SAMPLING_RATE / 1000UL)),               // Convert into actual WHs   
 
-                systemConfig.FORCED_TM                                           
-                );
+void prep_CPE(tPutChar put, CPS  *cpsPtr, int index) {
+        stream_string_P(PSTR("CPE;,"), put);
+        stream_fixed(index + 1, 0, put);                                                // Convert from "0-origin" of array indexes for display
+        stream_fields(CPEFields, cpsPtr, put);
+        }
 
+
+void prep_SCV(tPutChar put) {                                                           // Prep the System Control Variables.
+        stream_string_P(PSTR("SCV;"), put);
+        stream_fields(SCVFields, NULL, put);
         }
 
 
+void prep_NPC(tPutChar put) {                                                           // Prep the Name / Password (was Bluetooth) Config string.
+        stream_string_P(PSTR("NPC;"), put);
+        stream_fields(NPCFields, NULL, put);
+        }
 
-void prep_CST(char *buffer) { 
-     
-        #ifdef SYSTEMCAN                                                                                // Prep  the CAN Control Variable string. (Only on CAN enabled regulator)
-        snprintf_P(buffer, OUTBOUND_BUFF_SIZE, PSTR("CST;,%d,%d,%d,%d,  ,%1u,%1u,  ,%1u,%1u,%1u, ,%d,%1u,%1u,  ,%d\r\n"),
-                  batteryInstance,
-                  canConfig.BI_OVERRIDE,
-                  canConfig.DEVICE_INSTANCE,
-                  canConfig.DEVICE_PRIORITY,
 
-                  canConfig.ENABLE_NMEA2000,
-                  canConfig.ENABLE_OSE,
-                  
-                  canConfig.CONSIDER_MASTER,
-                  CAN_weAreRBM,
-                  canConfig.SHUNT_AT_BAT,
-    
-                  CAN_RBM_sourceID,
-                  ignoringRBM,
-                  canConfig.ENABLE_NMEA2000_RAT,
-                                    
-                  fetch_CAN_localID()); 
+void prep_SST(tPutChar put) {                                                           //  System Status
+        stream_string_P(PSTR("SST;"), put);
+        stream_fields(SSTFields, NULL, put);
+        }
+
+
+void prep_LST(tPutChar put) {                                                           //  Limiter Status
+        stream_string_P(PSTR("LST;"), put);
+        stream_fields(LSTFields, NULL, put);
+        }
+
+
+void prep_CST(tPutChar put) {
+        #ifdef SYSTEMCAN                                                                // Prep  the CAN Control Variable string. (Only on CAN enabled regulator)
+        stream_string_P(PSTR("CST;"), put);
+        stream_fields(CSTFields, NULL, put);
+        #else
+        (void) put;                                                                     // Nothing to send without the CAN.
         #endif
         }
 
 
 
 
+void put_outbound(char c) {                                                             // Sink for the streamed status strings; they go out both the Serial port
+        Serial.write(c);
+        #ifdef SYSTEMCAN
+          CAN_ASCII_putc(c);                                                            //  and via a CAN-wrapper (if someone from the CAN asked for it!)
+          #endif
+        }
+
+
+
+
 void  append_string(char *dest, const char *src, int n) {
     int i; 
     int offset;
@@ -27,6 +27,7 @@
 #include <Arduino.h>
 #include "Config.h"
 #include "CPE.h"    
+#include "Types.h"
 
 
 
@@ -34,8 +35,15 @@
 
                                 //----- External communications, Baud rate, buffer sizes, timeouts, etc..
                                 //
-#define UPDATE_STATUS_RATE         1000UL               // Send an update of the Status (via Bluetooth / Serial port) every 1 seconds.
-#define UPDATE_MAJOR_SENSITIVITY     60                 // Every 60 Update cycles, send the not-so-critical information.... (Max 126)
+#define STATUS_CHECK_RATE           250UL               // Look to see if any Status (via Bluetooth / Serial port) has changed enough to be sent this often.
+                                                        //  (This is also the fastest any one status string will be repeated)
+#define UPDATE_STATUS_RATE         5000UL               // Send the Alternator Status at least every 5 seconds, even if nothing has changed.  (Any change in
+                                                        //  its values sends it sooner:  see the deadbands below, and ASTSlowFields for the rest)
+#define UPDATE_MAJOR_RATE         60000UL               // And the not-so-critical information at least every 60 seconds.
+#define AST_VOLTS_DEADBAND         0.02                 // Alternator Status is sent early if Battery Volts have moved this much since last sent,
+#define AST_AMPS_DEADBAND          1.0                  //  or Alternator Amps have moved this much,
+#define AST_PWM_DEADBAND              3                 //  or the Field PWM has moved this many counts,  (or the charge mode has changed)
+#define AST_RPM_DEADBAND             50                 //  or the RPMs this many,  (Battery Amps and Alternator Volts use the Amps and Volts deadbands)
 #define INBOUND_BUFF_SIZE            60                 // Size of input command buffer (CAUTION:  250 -- 8-bit indexes are used)
 #define OUTBOUND_BUFF_SIZE          200                 // Large Outbound buffer, make sure we do not overrun (Primarily CPE;)(CAUTION:  250 -- 8-bit indexes are used)
 #define IB_BUFF_FILL_TIMEOUT     60000UL                // If a complete 'command' string is not received within 60 seconds, abort it.  Set = 0 to disable this feature.
@@ -46,16 +54,20 @@
 
 
 
+extern bool ibBufFilling;                               // A command is being assembled in ibBuf (from the Serial port or the CAN Terminal)
+
 void check_inbound(void);
 void send_outbound(bool pushAll);
 int  frac2int (float frac, int limit);
  
-void prep_AST(char *buffer);
-void prep_CPE(char *buffer, CPS  *cpsPtr, int Index);
-void prep_NPC(char *buffer);
-void prep_CST(char *buffer);
-void prep_SST(char *buffer);
-void prep_SCV(char *buffer);
+void prep_AST(tPutChar put);
+void prep_CPE(tPutChar put, CPS  *cpsPtr, int Index);
+void prep_NPC(tPutChar put);
+void prep_CST(tPutChar put);
+void prep_SST(tPutChar put);
+void prep_SCV(tPutChar put);
+void prep_LST(tPutChar put);
+void put_outbound(char c);
 
 
 
@@ -25,6 +25,7 @@
 #include "AltReg_Serial.h"
 #include "Types.h"
 #include "Sensors.h"
+#include "Flash.h"
 
 
 
@@ -41,6 +42,10 @@
 int     fieldPWMvalue     = FIELD_PWM_MIN;                              // How hard are we driving the Alternator Field?  Start not driving it.
 int     fieldPWMLimit     = FIELD_PWM_MAX;                              // The upper limit of PWM we should use, after adjusting for reduced power modes..  Note that during auto-sizing, this will be
                                                                         // reset to FIELD_PWM_MAX, as opposed to constrained values from user selected reduced power modes.
+uint8_t fieldPWMfraction  = 0;                                          // Any extra 1/FIELD_PWM_STEPS above fieldPWMvalue (see FIELD_PWM_FINE)
+#if defined(FIELD_PWM_FINE) && !defined(FIELD_PWM_OCR)
+uint8_t fieldPWMdither    = 0;                                          // Running total of fractions, used by set_ALT_PWM() to dither the 8-bit PWM.
+#endif
 int     thresholdPWMvalue = FIELD_PWM_MIN;                              // This contains the PWM level needed to provide for a Stator IRQ sufficient to produce a stable RPM measurement.
                                                                         // It may be pre-defined by the user (systemConfig.FIELD_TACH_PWM).  Or if the user has asked for auto-determination - 
                                                                         // while operating (typically during RAMP phase) once there is sufficient stability in the Stator IRQ signal to allow 
@@ -65,6 +70,10 @@ float         persistentBatVolts = 0.0;                                 // Used
 unsigned long enteredFloatLrAH   =   0;                                 // Snapshot of value in accumulatedLrAH when we 1st entered Float/Post Float mode.  Used to cacl AHs withdrawn from the battery to check
                                                                         // against AHs exits in the CPEs.
 
+uint8_t       limiterInControl   = LIM_NONE;                            // Who held back the Field at the last PWM adjustment  (tLimiters, see limiter_of()) ..
+unsigned long limiterTime[LIMITERS];                                    // .. and how long (in mS) each has been in control since power-up, while charging.
+uint8_t       limiterDerated     = 0;                                   // Which targets (and the Field cap) calculate_ALT_targets() has de-rated, (1 << tLimiters) bits.
+
 
 
 
@@ -146,6 +155,30 @@ SCS systemConfig = {
 
 
 
+                                //---   PID Gains, defaults are from Config.h and may be replaced by saved values from the EEPROM during startup.
+
+PIDS pidGains = {
+        KpPWM_V,                        // .KP_V
+        KiPWM_V,                        // .KI_V
+        KdPWM_V,                        // .KD_V
+        KpPWM_A,                        // .KP_A
+        KiPWM_A,                        // .KI_A
+        KdPWM_A,                        // .KD_A
+        KpPWM_W,                        // .KP_W
+        KiPWM_W,                        // .KI_W
+        KdPWM_W,                        // .KD_W
+        KpPWM_TA,                       // .KP_TA
+        KdPWM_TA,                       // .KD_TA
+        PID_I_WINDUP_CAP,               // .I_WINDUP_CAP
+        PWM_CHANGE_RATE };              // .CHANGE_RATE
+
+PIDS    pidScaled;                                                      // pidGains as manage_ALT() uses them:  the Volts and Watts gains already divided by systemVoltMult,
+float   pidScaledFor  = 0;                                              //  and the systemVoltMult that was.  (0 = not done yet, see scale_PID_gains())
+bool    pidGainsTuned = false;                                          // Set when auto_tune_V has worked out new Voltage gains, loop() saves them to the EEPROM.
+                                                                        //  (Writing the EEPROM takes too long to be done from within manage_ALT())
+
+
+
 CPS             workingParms;                                           // Charge Parameters we are currently working with, appropriate entry is copied from EEPROM or FLASH during startup();
 uint8_t         cpIndex       = 0;                                      // Which entry in the chargeParms structure should we be using for battery setpoints?  (Default = 1st one)
 
@@ -362,6 +395,7 @@ int     i;
         case ramping:
         case bulk_charge:
         case determine_ALT_cap:
+        case auto_tune_V:
         case acceptance_charge:
         case RBM_CVCC:
                 set_VAWL(workingParms.ACPT_BAT_V_SETPOINT);                                                     // Set the Volts/Amps/Watts limits (See helper function just below)
@@ -370,6 +404,8 @@ int     i;
 
         case overcharge_charge:
                 set_VAWL(workingParms.EXIT_OC_VOLTS);                                                           // Set the Volts taking into account comp factors (system voltage, bat temp..)
+                if ((workingParms.LIMIT_OC_AMPS * systemAmpMult) < targetAltAmps)
+                    limiterDerated &= ~((1 << LIM_AMPS) | (1 << LIM_WATTS));                                    // (If it is the OC limit holding the Amps, they are not de-rated)
                 targetAltAmps  = min(targetAltAmps, (workingParms.LIMIT_OC_AMPS * systemAmpMult));              // Need to override the default Amps / Watts calc, as we do things a bit different in OC mode.
                 targetAltWatts = min(targetAltWatts,(workingParms.EXIT_OC_VOLTS * systemVoltMult * targetAltAmps));
                 break;
@@ -381,6 +417,8 @@ int     i;
                 set_VAWL(workingParms.FLOAT_BAT_V_SETPOINT);                                                    // Set the Volts/Amps/Watts limits (See helper function just below)
 
                 if (workingParms.LIMIT_FLOAT_AMPS  != -1) {
+                    if ((workingParms.LIMIT_FLOAT_AMPS * systemAmpMult) < targetAltAmps)
+                        limiterDerated &= ~((1 << LIM_AMPS) | (1 << LIM_WATTS));
                     targetAltAmps  = min(targetAltAmps, (workingParms.LIMIT_FLOAT_AMPS     * systemAmpMult));   // If user wants to 'regulate' Amps during Float, need to override the default Amps / Watts calcs.
                     targetAltWatts = min(targetAltWatts,(workingParms.FLOAT_BAT_V_SETPOINT * systemVoltMult * targetAltAmps));
                     }
@@ -393,6 +431,8 @@ int     i;
                 set_VAWL(workingParms.EQUAL_BAT_V_SETPOINT);                                            // Set the Volts/Amps/Watts limits (See helper function just below)
 
                 if (workingParms.LIMIT_EQUAL_AMPS != 0) {
+                    if ((workingParms.LIMIT_EQUAL_AMPS * systemAmpMult) < targetAltAmps)
+                        limiterDerated &= ~((1 << LIM_AMPS) | (1 << LIM_WATTS));
                     targetAltAmps  = min(targetAltAmps, (workingParms.LIMIT_EQUAL_AMPS      * systemAmpMult));
                     targetAltWatts = min(targetAltWatts,(workingParms.EQUAL_BAT_V_SETPOINT  * systemVoltMult * targetAltAmps));
                 }
@@ -421,7 +461,7 @@ int     i;
    if ((CAN_RBM_sourceID != 0) && (ignoringRBM == false) &&
        (CAN_RBM_desiredChargeState != RVCDCbcm_Undefined)  && (CAN_RBM_desiredChargeState != RVCDCbcm_Unknown)) {
 
-        set_VAWL(CAN_RBM_desiredVolts / systemVoltMult);                                                // RBM is controlling us, we need to make some other checks and adjustments.
+        set_VAWL((CAN_RBM_desired_mVolts * 0.001) / systemVoltMult);                                    // RBM is controlling us, we need to make some other checks and adjustments.
                                                                                                         // 1st we will set the voltage goal to what the RBM is asking for.
                                                                                                         // Calling set_VAWL() again will also reset any CPE based Amp/Watts overrides above - as
                                                                                                         // we want the RBM to make those decisions, not the local regulator CPE entries.
@@ -430,26 +470,26 @@ int     i;
         //         e.g.: Is too much current is being delivered to the battery?  
         if ((millis() - CAN_LPCS_lastReceived) > REMOTE_CAN_LPCS_TIMEOUT) {                             // Are we the LPCS (Lower Priority Charging Source) who should be taking prioritization action??
         
-            if (CAN_RBM_amps > CAN_RBM_desiredAmps) {                                                   // Is the 'system' over-delivering Amps to the battery
+            if (CAN_RBM_mAmps > CAN_RBM_desired_mAmps) {                                                // Is the 'system' over-delivering Amps to the battery
                                                                                                         // Yes, we need to to something.
                 if (shuntAmpsMeasured) {                                                                // If we it seems we are able to measure alternator current output, use AMPS to set the 'high limit'                                
                     if ((millis() - CAN_EPCS_lastReceived) > REMOTE_CAN_LPCS_TIMEOUT)
-                         targetAltAmps = measuredAltAmps - (CAN_RBM_amps - CAN_RBM_desiredAmps)/2;      // If there someone of equal priority let's share the burden
-                    else targetAltAmps = measuredAltAmps - (CAN_RBM_amps - CAN_RBM_desiredAmps);        // Not sharing, looks like we are truly the LPCS, try to do all the backup ourselves.
+                         targetAltAmps = measuredAltAmps - (CAN_RBM_mAmps - CAN_RBM_desired_mAmps) * 0.0005;  // If there someone of equal priority let's share the burden
+                    else targetAltAmps = measuredAltAmps - (CAN_RBM_mAmps - CAN_RBM_desired_mAmps) * 0.001;   // Not sharing, looks like we are truly the LPCS, try to do all the backup ourselves.
                                                                                                         // (Note:   Shared burden:  At present, the back off is just a rough 50/50.  Need to see how this works in the
                                                                                                         //          case where there are more than 2x 'same priority' charging sources - think several small solar MPPT
                                                                                                         //          controllers.   It may be that we need to be smarter - maintain an actual count of 'same priority' charging
                                                                                                         //          sources.  Or perhaps only back off 10% each time, and let the world slowly settle...)
                 }
-                else                                                                                    // Well, we are not configured to measure AMPs (or the shunt broke).  Need to do something else..
-                    fieldPWMLimit = min(fieldPWMLimit, fieldPWMvalue) * ((CAN_RBM_amps - CAN_RBM_desiredAmps) / CAN_RBM_amps);
+                else if (CAN_RBM_mAmps > 0)                                                             // Well, we are not configured to measure AMPs (or the shunt broke).  Need to do something else..
+                    fieldPWMLimit = (int)((long)min(fieldPWMLimit, fieldPWMvalue) * ((CAN_RBM_mAmps - CAN_RBM_desired_mAmps) * 100L / CAN_RBM_mAmps) / 100L);
             }                                                                                           // Rather crude..  But if are x% over limit, pull back the field x% from its current value...
                                                                                                         //!! HEY !! THIS MAY NEED TO BE IMPROVED, AS IT MIGHT CAUSE A SLOW OSCULATION DUE TO OVER CORRECTION...
                                                                                                         
                                                                                                             
-            if (CAN_RBM_amps < CAN_RBM_desiredAmps) {                                                   // Is the 'system' under-delivering Amps to the battery?
+            if (CAN_RBM_mAmps < CAN_RBM_desired_mAmps) {                                                // Is the 'system' under-delivering Amps to the battery?
                if (shuntAmpsMeasured)                                                                   // If we it seems we are able to measure alternator current output, use AMPS to set the 'high limit'                                
-                         targetAltAmps = measuredAltAmps + (CAN_RBM_desiredAmps - CAN_RBM_amps);        // Bump up the AMPs we regulate to by the gap.
+                         targetAltAmps = measuredAltAmps + (CAN_RBM_desired_mAmps - CAN_RBM_mAmps) * 0.001;   // Bump up the AMPs we regulate to by the gap.
                                                                                                         // Note that if Amps are not being measured, we will not do anything in this case - just let the PID
                                                                                                         // engine raise the PWM the change-cap rate each cycle.  This WILL result in a little overshoot due to 
                                                                                                         // lag in receiving revised Amperage measurement from the RBM.
@@ -487,6 +527,7 @@ int     i;
         if (fieldPWMLimit < FIELD_PWM_MIN)   fieldPWMLimit = FIELD_PWM_MIN;                             // Negative value check.
         if (tachMode)                        fieldPWMLimit = max(fieldPWMLimit, thresholdPWMvalue);     // And do not pull down too much so that we lose the Tach sync.
         if (targetAltAmps < 0.0)             targetAltAmps = 0.0;
+        if (fieldPWMLimit < FIELD_PWM_MAX)   limiterDerated |= (1 << LIM_FIELD_MAX);                    // (Pulling back for the other charging sources counts as a de-rating too)
 
         
         
@@ -582,6 +623,15 @@ void set_VAWL(float passedV) {
                  targetAltWatts = 15000;                                                                // If we have NOT measured the capacity (or user has told us to disable watts capacity limits
                                                                                                         // for the System Wattage), set Watts to a LARGE number  (Ahem, see 1000A comment above  :-)
 
+
+                                // And take note of which of these limits have been de-rated, so that when one of them is holding back the Field
+                                //   it is put down to the de-rating rather then to the configured targets.  (See limiter_of())
+        limiterDerated = 0;
+        if ((altCapAmps != 0) && (targetAltAmps < altCapAmps))
+                limiterDerated |= (1 << LIM_AMPS) | ((systemConfig.ALT_WATTS_LIMIT == -1) ? (1 << LIM_WATTS) : 0);    // (Auto Watts come from the de-rated Amps)
+        if (fieldPWMLimit < FIELD_PWM_MAX)
+                limiterDerated |= (1 << LIM_FIELD_MAX);                                                 // Half power / Small Alt mode, idle RPM pull-back ..
+
 }
 
 
@@ -624,18 +674,31 @@ void set_ALT_mode(tModes settingMode)  {
 //
 //  Set Alternator PWM
 //              This function is used to change the Alternator PWM field.
+//              If FIELD_PWM_FINE is enabled, 'fraction' adds that many 1/FIELD_PWM_STEPS to the PWM value.
 //
 //
 //------------------------------------------------------------------------------------------------------
 
-void  set_ALT_PWM(int PWM) {
+void  set_ALT_PWM(int PWM, uint8_t fraction) {
 
-   lastPWMChanged = millis();
-   fieldPWMvalue  = PWM;
+   lastPWMChanged   = millis();
+   fieldPWMvalue    = PWM;
+   fieldPWMfraction = fraction;
 
 
    #ifndef SIMULATION                                                              // If simulating, do NOT drive the field PWM port at all!
-     analogWrite(FIELD_PWM_PORT,PWM);
+     #if   defined(FIELD_PWM_OCR)
+       FIELD_PWM_OCR = (PWM << FIELD_PWM_FRAC_BITS) + fraction;                    // Timer1 is in 10-bit mode, load the compare register directly.
+     #elif defined(FIELD_PWM_FINE)
+       fieldPWMdither += fraction;                                                 // No 10-bit timer, so dither:  every time the fractions add up to a full step,
+       if (fieldPWMdither >= FIELD_PWM_STEPS) {                                    //  send out one step higher.
+           fieldPWMdither -= FIELD_PWM_STEPS;
+           PWM = min(PWM + 1, FIELD_PWM_MAX);
+           }
+       analogWrite(FIELD_PWM_PORT,PWM);
+     #else
+       analogWrite(FIELD_PWM_PORT,PWM);
+     #endif
      #endif
 
 }
@@ -689,6 +752,31 @@ uint8_t ALT_Per_Util(void) {
 
 
 
+//------------------------------------------------------------------------------------------------------
+//
+//   Scale PID Gains
+//      This function copies pidGains into pidScaled, with the Volts and Watts gains divided by systemVoltMult, so manage_ALT()'s
+//      PID engine does no divides on each adjustment.  Call it whenever pidGains change.  manage_ALT() calls it itself when
+//      systemVoltMult is not what pidScaled was worked out for (as when startup() has just read the gains and sized the system).
+//
+//------------------------------------------------------------------------------------------------------
+
+void scale_PID_gains(void) {
+
+    pidScaled       = pidGains;
+    pidScaled.KP_V /= systemVoltMult;
+    pidScaled.KI_V /= systemVoltMult;
+    pidScaled.KD_V /= systemVoltMult;
+    pidScaled.KP_W /= systemVoltMult;
+    pidScaled.KI_W /= systemVoltMult;
+    pidScaled.KD_W /= systemVoltMult;
+    pidScaledFor    = systemVoltMult;
+}
+
+
+
+
+
 //------------------------------------------------------------------------------------------------------
 //
 //  Manage the Alternator.
@@ -711,9 +799,13 @@ void manage_ALT()  {
 
         //----   Working variable used each time through, to hold calcs for the PID engine.
   float  errorV;                                        // Calc the real-time delta error (P value of PID) Measured - target:  Note the order, over target will result in positive number!
+  float  LDerrorV;                                      // errorV used for the load-dump checks.  (With INA226_FAST_LOAD_DUMP, from the latest few fast readings)
   float  errorA;
   float  errorW;
   bool   atTargVoltage;                                 // Have we reached the target voltage?  Used when checking to see if we are ready to transation to the next Mode.
+  float  Kp, Kd;                                        // New Voltage gains from an auto-tune
+  float  ViPrior, AiPrior, WiPrior;                     // 'I' values going into this adjustment
+  bool   acptAmpsFlat;                                  // Have the Acceptance Amps leveled off?
 
 
   float VdErr;                                          //  Calculate 1st order derivative of VBat error  (Rate of Change, D value of PID)
@@ -728,6 +820,8 @@ void manage_ALT()  {
   int   PWMErrorTA;                                     // Alt Temp delta (Alternator limited)
 
   int   PWMError;                                                                                       // Holds final PWM modification value.
+  int   PWMApplied;                                                                                     // What the Field was actually moved by, after all the limits.  (For the anti-windup)
+  long  fineFieldPWM;                                                                                   // Field PWM in 1/FIELD_PWM_STEPS, the units the PID works in.
 
 
         //-----  Working variables that must RETAIN their values between calls for mange_alt().  Some are for the PID, others for load-dumps management and temperature pull-backs.
@@ -755,6 +849,32 @@ void manage_ALT()  {
   bool    static LD1Triggered    = false;                      // Has one of the Load Dump thresholds been triggered?  (This keeps us from over correcting)
   bool    static LD2Triggered    = false;
 
+#ifdef FIELD_FEED_FORWARD
+  tFFMap        static ffMap;                           // Learned Amps per Field PWM step, by RPMs
+  int           static ffRPMs      = 0;                 // RPMs and Amps when things were last steady
+  float         static ffAmps      = 0;
+  int           static ffPriorRPMs = 0;                 // RPMs and Field PWM at the last adjustment
+  int           static ffPriorPWM  = 0;
+  bool          ffSteady;
+  int           ffSeedPWM;
+  #endif
+
+  int32_t       static persistAmpsAcc  = 0;             // Fixed point working values behind persistentBatAmps and persistentBatVolts  (See persist_filter())
+  int32_t       static persistVoltsAcc = 0;
+
+  unsigned long static rampSlewAcc  = 0;                // Left over part of a Field step the ramp may rise by  (See slew_allow())
+  unsigned long static rampStarted  = 0;                // altModeChanged of the ramp rampSlewAcc is working on
+  int           rampAllow = PWM_CHANGE_CAP * FIELD_PWM_STEPS;   // How far the ramp may raise the Field this adjustment  (As far as anyone, when not ramping)
+
+  int           limiterAsked[LIM_RAMP + 1];             // PWM change each loop (and the Ramp) asked for, in tLimiters order  (See limiter_of())
+  unsigned long static limiterNoted = 0;                // When limiterTime[] was last added to
+
+  tSlope        static acptAmpsSlope;                   // Watching for the Acceptance Amps to level off  (EXIT_ACPT_DIDT)
+  unsigned long static acptAmpsStarted = 0;             // altModeChanged of the Acceptance phase acptAmpsSlope is watching
+
+  tRelayTune    static autoTune;                        // Working state of a Voltage PID auto-tune (auto_tune_V mode)
+  unsigned long static autoTuneStarted = 0;             // altModeChanged of the auto-tune run autoTune was set up for
+
   unsigned long enteredMills;                           // Time in millis() managed_alt() was entered.  Used throughout function and saves 300 bytes of code vs. repeated millis() calls
   char          charBuffer[OUTBOUND_BUFF_SIZE+1];       // Used to assemble Debug ASCII String (if needed)
 
@@ -763,13 +883,25 @@ void manage_ALT()  {
         //------ NOW we can start the code!!
         //
 
+      #ifdef INA226_FAST_LOAD_DUMP
+        if (updatingVAs && !fastAltVoltsReady) return;                                          // Nothing new, not even a fast reading for the load-dump checks below.
+      #else
         if (updatingVAs) return;                                                                // If Volts/Amps measurements are being refreshed just skip checking things this time around until they are ready.
+        #endif
 
 
         errorV = measuredBatVolts -  targetBatVolts;                                            // Calc the error values, as they are used a lot down the road.
         errorA = measuredAltAmps  -  targetAltAmps;                                             // + = over target, - = under target.
         errorW = measuredAltWatts - (targetAltWatts * otWattsPullbackFactor);                   // (Adjust down Target Alt Watts for any overtemp condition...)
 
+        LDerrorV = errorV;
+      #ifdef INA226_FAST_LOAD_DUMP
+        if (fastAltVoltsReady) {                                                                // Use the latest fast INA226 readings for the load-dump checks, carrying across any offset
+            LDerrorV = fastAltVolts + (measuredBatVolts - measuredAltVolts) - targetBatVolts;   //  resolve_BAT_VoltAmpTemp() applied to the last averaged reading (e.g., remote battery sensing)
+            fastAltVoltsReady = false;
+            }
+        #endif
+
 
         atTargVoltage = ((errorV + (PID_VOLTAGE_SENS * systemVoltMult)) >= 0);                  // We only need to be within 'shooting range' of the target votlage to conider we have met the conditions.
                                                                                                 //  (Helpful with small alternators which may not be able to push over the target voltage on low-impedance batteries)
@@ -794,26 +926,33 @@ void manage_ALT()  {
         //----  1st, seeing as we have a new valid voltage reading, letÃ¢â‚¬â„¢s do the quick over-voltage check as well check to see if there is if there seems to be load-dump situation...
         //
 
-        if (errorV > (LD1_THRESHOLD * systemVoltMult)) {                                        // Yes, we are AT LEAST over the 1st line...
+        if (LDerrorV > (LD1_THRESHOLD * systemVoltMult)) {                                        // Yes, we are AT LEAST over the 1st line...
+
+           fineFieldPWM = ((long)fieldPWMvalue * FIELD_PWM_STEPS) + fieldPWMfraction;          // (Pull back the Field in the same 1/FIELD_PWM_STEPS the PID works in)
 
            if (!LD1Triggered) {                                                                 // OK, this is the 1st time we have seen this level
-                fieldPWMvalue *= LD1_PULLBACK;                                                  // Cut the Field PWM drive a some this 1st overvoltage step.
+                fineFieldPWM  *= LD1_PULLBACK;                                                  // Cut the Field PWM drive a some this 1st overvoltage step.
                 LD1Triggered   = true;                                                          // but note that we have already done the LD1 reduction, to prevent overcorrection.
                 }
 
-           if ((errorV > (LD2_THRESHOLD * systemVoltMult)) && (!LD2Triggered)) {                // Over the 2nd trip level?  (and 1st time we have seen this slightly higher voltage?)
-                fieldPWMvalue *= (LD2_PULLBACK / LD1_PULLBACK);                                 // Yes, cut it again - harder this time...
+           if ((LDerrorV > (LD2_THRESHOLD * systemVoltMult)) && (!LD2Triggered)) {                // Over the 2nd trip level?  (and 1st time we have seen this slightly higher voltage?)
+                fineFieldPWM  *= (LD2_PULLBACK / LD1_PULLBACK);                                 // Yes, cut it again - harder this time...
                 LD2Triggered   = true;                                                          // Note that % value is cumulative with prior LD pullback..  Using  /LDx_.. to back-out the cumulative effect
                 }
 
  
 
-           if (errorV  > (LD3_THRESHOLD * systemVoltMult)) {                                    // And finally, if we are way over just shut things down
-            #ifndef SIMULATION                                                              
+           if (LDerrorV  > (LD3_THRESHOLD * systemVoltMult)) {                                    // And finally, if we are way over just shut things down
+            #if   defined(SIMULATION)
+            #elif defined(FIELD_PWM_OCR)
+              FIELD_PWM_OCR = FIELD_PWM_MIN;                                                    // (analogWrite() of 0 would disconnect pin from the 10-bit Timer1)
+            #else
               analogWrite(FIELD_PWM_PORT,FIELD_PWM_MIN);                                        // OK, this is (hopefully) a short-term spike.  To help things along, just spike the field down
               #endif                                                                            // while overvolt.  Once things have settled down, let the 'regulator' handle things normally.  
                                                                                                 // (or said another way:  pull the field down, but do not adjust the running PWM value...)
-            sample_ALT_VoltAmps();                                                              // Start a new local VA sample cycle, and see how things settle out when we resume our normal PID regulation cycle.
+            fieldPWMvalue    = fineFieldPWM / FIELD_PWM_STEPS;                                  // (Other then any LD1 / LD2 pull-back just made, which is kept for when we resume)
+            fieldPWMfraction = fineFieldPWM % FIELD_PWM_STEPS;
+            sample_ALT_VoltAmps();                                                             // Start a new local VA sample cycle, and see how things settle out when we resume our normal PID regulation cycle.
             LD1Triggered = false;                                                               // Resetting flags, if when we come back in we are STILL overvoltage 
             LD2Triggered = false;
             return;                                                                             // (I expect this to give a 10-20mS 'shot' of 0 field drive)
@@ -825,10 +964,14 @@ void manage_ALT()  {
 
 
            if (tachMode)
-                fieldPWMvalue = max(fieldPWMvalue, thresholdPWMvalue);                          // But if Tach mode, do not let PWM drop too low - else tach will stop working.
+                fineFieldPWM = max(fineFieldPWM, (long)thresholdPWMvalue * FIELD_PWM_STEPS);    // But if Tach mode, do not let PWM drop too low - else tach will stop working.
 
-           set_ALT_PWM(fieldPWMvalue);                                                          // Send out the new PWM value (do it here to get quick response, and also in case the time-loop
-                                                                                                // PWM_CHANGE_RATE has not occurred, as that will cause manage_alt() to exit this time through).
+           if (fineFieldPWM != ((long)fieldPWMvalue * FIELD_PWM_STEPS) + fieldPWMfraction) {    // Only if a pull-back was just made:  set_ALT_PWM() restarts the PWM_CHANGE_RATE wait, and
+                set_ALT_PWM(fineFieldPWM / FIELD_PWM_STEPS, fineFieldPWM % FIELD_PWM_STEPS);   //  doing that on every reading over LD1 would keep the PID from ever running to bring
+                                                                                                //  things back down.  (Send it out here to get quick response, and also in case the
+                                                                                                //  PWM_CHANGE_RATE has not occurred, as that will cause manage_alt() to exit this time through).
+                priorBatVolts = targetBatVolts + LDerrorV;                                      // The rise has now been answered, do not let the 'D' pull back for it a 2nd time.
+                }
            }
         else {
            LD1Triggered = false;                                                                // Does NOT look like a load-dump (not exceeding the LD1 threshold) so reset the triggers
@@ -839,13 +982,20 @@ void manage_ALT()  {
 
 
 
+      #ifdef INA226_FAST_LOAD_DUMP
+        if (updatingVAs) return;                                                                // The rest only works from full averaged readings.
+        #endif
+
+
+
+
         //---   OK then, let's get on with the rest of things.  But 1st, is it even time for us to adjust the PWM yet?
         //       Aside from the Load Dump checks we did above (which happen every time we get a new Vbat reading) we need to take some time to let the alternator and system
         //       settle in to changes.   Alts seem to take anywhere from 100-300mS to 'respond' to a change in PWM up, a bit less for down.  By controlling how often we
         //       try to adjust the PWM, we give the system time to respond to a prior change.
         //       A 2nd benefit is that by using a fixed time between adjustments  the PID calculations are somewhat simplified, specifically in the Derivative and Integral factors.
 
-        if ((enteredMills - lastPWMChanged) <= PWM_CHANGE_RATE)                                         //   Is it too soon to make a change?
+        if ((enteredMills - lastPWMChanged) <= (unsigned long) pidGains.CHANGE_RATE)                    //   Is it too soon to make a change?
                 return;                                                                                 //      Yes - skip doing anything this time around.
 
 
@@ -881,21 +1031,21 @@ void manage_ALT()  {
 
 
 
-        ViErr  += (errorV  * KiPWM_V  / systemVoltMult);                                                // Calc the I values.
-        AiErr  += (errorA  * KiPWM_A);                                                                  // Note also that the scaling factors are figured in here, as opposed to during the PID formula below.
-        WiErr  += (errorW  * KiPWM_W  / systemVoltMult);                                                // Doing so helps avoid issues down the road if we ever implement an auto-tuning capability, and change the I
-
-        ViErr  = constrain( ViErr, 0, PID_I_WINDUP_CAP);                                               // Keep the accumulated errors from getting out of hand, their impact is meant to be a soft refinement, not a
-        AiErr  = constrain( AiErr, 0, PID_I_WINDUP_CAP);                                               // sledge hammer!
-        WiErr  = constrain( WiErr, 0, PID_I_WINDUP_CAP);                                               // Also - ONLY use 'I' to pull-back the PWM, never to allow it to be driven stronger.
-
-        PWMErrorV   = (int) ((errorV * -KpPWM_V / systemVoltMult)  -  ViErr  - (VdErr * KdPWM_V / systemVoltMult));
-        PWMErrorA   = (int) ((errorA * -KpPWM_A)                   -  AiErr  - (AdErr * KdPWM_A));
-        PWMErrorW   = (int) ((errorW * -KpPWM_W / systemVoltMult)  -  WiErr  - (WdErr * KdPWM_W / systemVoltMult));
-
+                                                                                                        // Calc the P, I and D for each, see pid_term().  Note the scaling factors are figured into the gains (pidScaled), and
+                                                                                                        // the accumulated errors are kept from getting out of hand:  their impact is meant to be a soft
+                                                                                                        // refinement, not a sledge hammer!   Also - ONLY use 'I' to pull-back the PWM, never to allow it to be driven stronger.
+        ViPrior = ViErr;                                                                                // (Kept for the anti-windup below)
+        AiPrior = AiErr;
+        WiPrior = WiErr;
+        if (pidScaledFor != systemVoltMult)                                                             // Gains not yet scaled for this system voltage?
+                scale_PID_gains();
+        PWMErrorV   = (int) (pid_term(errorV, VdErr, &ViErr, pidScaled.KP_V, pidScaled.KI_V, pidScaled.KD_V, pidScaled.I_WINDUP_CAP) * FIELD_PWM_STEPS);
+        PWMErrorA   = (int) (pid_term(errorA, AdErr, &AiErr, pidScaled.KP_A, pidScaled.KI_A, pidScaled.KD_A, pidScaled.I_WINDUP_CAP) * FIELD_PWM_STEPS);
+        PWMErrorW   = (int) (pid_term(errorW, WdErr, &WiErr, pidScaled.KP_W, pidScaled.KI_W, pidScaled.KD_W, pidScaled.I_WINDUP_CAP) * FIELD_PWM_STEPS);
+                                                                                                        // (All PWM errors are in 1/FIELD_PWM_STEPS of a PWM step)
         if (max(measuredAltTemp,measuredAlt2Temp) > 0)
-                PWMErrorTA = ((float)(systemConfig.ALT_TEMP_SETPOINT - max(measuredAltTemp,measuredAlt2Temp))*KpPWM_TA) - ((float)ATdErr * KdPWM_TA);
-          else  PWMErrorTA = PWM_CHANGE_CAP;                                                            // Only do Temp Adjustments if we are able to read Temps (and it is not very very cold..)!
+                PWMErrorTA = (((float)(systemConfig.ALT_TEMP_SETPOINT - max(measuredAltTemp,measuredAlt2Temp))*pidGains.KP_TA) - ((float)ATdErr * pidGains.KD_TA)) * FIELD_PWM_STEPS;
+          else  PWMErrorTA = PWM_CHANGE_CAP * FIELD_PWM_STEPS;                                          // Only do Temp Adjustments if we are able to read Temps (and it is not very very cold..)!
                                                                                                         //  Else allow just a little raise, until we hit some other limit.
 
 
@@ -912,7 +1062,7 @@ void manage_ALT()  {
                         //      situation.
 
 
-        if (PWMErrorTA   <= OT_PULLBACK_THRESHOLD) {                                                    // Is the Alternator over temp by a noticeable amount?
+        if (PWMErrorTA   <= OT_PULLBACK_THRESHOLD * FIELD_PWM_STEPS) {                                                    // Is the Alternator over temp by a noticeable amount?
              if (otCycleTriggered != true)  {                                                           // Yes, have we seen this before?
 
                   otWattsPullbackFactor  *= OT_PULLBACK_FACTOR;                                         // No, this is the 1st time.  So Pull back the target watts some % of its current value
@@ -932,7 +1082,7 @@ void manage_ALT()  {
 
         PWMError = min(PWMErrorV, PWMErrorA);                                                           // If there is ANYONE who thinks PWM should be pulled down (or left as-is), let them have the 1st say.
         PWMError = min(PWMError,  PWMErrorW);
-        PWMError = min(PWMError,  PWM_CHANGE_CAP);                                                      // While we are at it, make sure we do not ramp up too fast!  (Note that ramping down is not capped)
+        PWMError = min(PWMError,  PWM_CHANGE_CAP * FIELD_PWM_STEPS);                                    // While we are at it, make sure we do not ramp up too fast!  (Note that ramping down is not capped)
                                                                                                         // We only do temperature based adjustments based on the slower cycle time (e.g. TAM_SENSITIVITY)
         if (TAMCounter == TAM_SENSITIVITY)                                                              // Over Alternator, adjust down due to overtemp.
                 PWMError = min(PWMError, PWMErrorTA);
@@ -945,6 +1095,8 @@ void manage_ALT()  {
 
 
 
+
+
         //----  Check to see if it is time to transition charging phases
         //
         //        Ramp   --> Bulk:    Total time allocated for Ramping exceeded, or we are driving alternator full bore.
@@ -954,16 +1106,13 @@ void manage_ALT()  {
         //
 
 
-        if (measuredBatAmps >= persistentBatAmps)                                                       // Adjust the smoothing Amps variable now.
-           persistentBatAmps = measuredBatAmps;                                                         // We want to track increases quickly,
-        else if (measuredBatAmps > 0.0)                                                                 // but decreases slowly...  This will prevent us from changing state too soon. (And don't count discharging)
-           persistentBatAmps = (((persistentBatAmps * (float)(AMPS_PERSISTENCE_FACTOR-1L)) + measuredBatAmps) / AMPS_PERSISTENCE_FACTOR);
+        if ((measuredBatAmps >= persistentBatAmps) || (measuredBatAmps > 0.0))                         // Adjust the smoothing Amps variable now.  We want to track increases quickly,
+           persistentBatAmps = persist_filter(&persistAmpsAcc, (int32_t) (measuredBatAmps * PERSISTENCE_AMPS_SCALE), AMPS_PERSISTENCE_SHIFT)
+                                * (1.0 / PERSISTENCE_AMPS_SCALE);                                        // but decreases slowly...  This will prevent us from changing state too soon. (And don't count discharging)
 
 
-        if (measuredBatVolts >= persistentBatVolts)                                                     // Adjust the smoothing Volts variable now.
-           persistentBatVolts = measuredBatVolts;                                                       // We want to track increases quickly,
-        else                                                                                            // but slowly decreases...  This will prevent us from changing state too soon.
-           persistentBatVolts = (((persistentBatVolts * (float)(VOLTS_PERSISTENCE_FACTOR-1)) + measuredBatVolts) / VOLTS_PERSISTENCE_FACTOR);
+        persistentBatVolts = persist_filter(&persistVoltsAcc, (int32_t) (measuredBatVolts * PERSISTENCE_VOLTS_SCALE), VOLTS_PERSISTENCE_SHIFT)
+                                * (1.0 / PERSISTENCE_VOLTS_SCALE);                                       // Same for Volts, track increases quickly but slowly decreases...
 
 
 
@@ -976,6 +1125,7 @@ void manage_ALT()  {
                         fieldPWMvalue = systemConfig.FIELD_TACH_PWM;                                    // send that out, even during engine warm-up period.
                 else    fieldPWMvalue = FIELD_PWM_MIN;                                                  //  All other cases, Alternator should still be turned off.
 
+                fieldPWMfraction = 0;
                 PWMError  = 0;                                                                          // In we will not be making ANY adjustments to the PWM for now.
 
                 if (((enteredMills- altModeChanged) > ENGINE_WARMUP_DURATION) &&                        // Have we been in WarmUp period long enough to start ramping?
@@ -991,6 +1141,8 @@ void manage_ALT()  {
           case ramping:
                 persistentBatAmps  = measuredBatAmps;                                                   //  While ramping, just track the actually measured amps and Watts.
                 persistentBatVolts = measuredBatVolts;                                                  //  Overwriting the persistence calculation above.
+                persist_set(&persistAmpsAcc,  (int32_t) (measuredBatAmps  * PERSISTENCE_AMPS_SCALE),  AMPS_PERSISTENCE_SHIFT);
+                persist_set(&persistVoltsAcc, (int32_t) (measuredBatVolts * PERSISTENCE_VOLTS_SCALE), VOLTS_PERSISTENCE_SHIFT);
 
 
 
@@ -1016,8 +1168,12 @@ void manage_ALT()  {
                          set_ALT_mode(bulk_charge);                                                     //   But 1st see if we need to measure the Alternators Capacity..
 
                 } else {
-                    if ((enteredMills - lastPWMChanged) <= PWM_RAMP_RATE)                               // Still under limits, while ramping wait longer between changes..
-                        return;
+                    if (rampStarted != altModeChanged) {                                                // Still under limits, so raise the Field no faster then PWM_CHANGE_CAP each PWM_RAMP_RATE.
+                        rampStarted = altModeChanged;                                                   //  This is spread over every adjustment (with the left over part of a step carried along)
+                        rampSlewAcc = 0;                                                                //  so the Field slews up smoothly, rather then moving in a few large steps now and then.
+                        }
+                    rampAllow = slew_allow(&rampSlewAcc, enteredMills - lastPWMChanged, PWM_CHANGE_CAP * FIELD_PWM_STEPS, PWM_RAMP_RATE);
+                    PWMError  = min(PWMError, rampAllow);                                               // (Not inside min(), which is a macro and would take the allowance twice)
                 }
 
                 break;
@@ -1027,6 +1183,36 @@ void manage_ALT()  {
 
 
 
+          case auto_tune_V:                                                                             // Auto-tuning the Voltage PID gains, started via $FRM:T
+                if (autoTuneStarted != altModeChanged) {                                                // 1st time through?  Set up a relay test around the present battery voltage (but never above target),
+                    autoTuneStarted = altModeChanged;                                                   //  swinging the Field PWM either side of where it is now.
+                    relay_tune_start(&autoTune, min(measuredBatVolts, targetBatVolts) / systemVoltMult, AUTOTUNE_HYSTERESIS, AUTOTUNE_MAX_SWING,
+                                     constrain(fieldPWMvalue, FIELD_PWM_MIN + AUTOTUNE_PWM_STEP, fieldPWMLimit - AUTOTUNE_PWM_STEP),
+                                     AUTOTUNE_PWM_STEP, enteredMills);
+                    }
+
+                if (((enteredMills - altModeChanged) >= AUTOTUNE_DURATION) ||                           // Have we been at it too long without seeing a steady oscillation?  --OR--
+                    (fieldPWMLimit < (FIELD_PWM_MIN + 2 * AUTOTUNE_PWM_STEP))) {                        // is there not enough room under the PWM limit to swing the Field?
+                        set_ALT_mode(bulk_charge);                                                      //  Give up, leaving the gains as they were, and get back to charging.
+                        break;
+                        }
+
+                fieldPWMvalue = relay_tune_step(&autoTune, measuredBatVolts / systemVoltMult, enteredMills);
+                PWMError      = -fieldPWMfraction;                                                      // Send out exactly what the relay is asking for, the PID engine has no say during the test.
+
+                if (relay_tune_gains(&autoTune, pidGains.CHANGE_RATE, &Kp, &Kd)) {                      // Enough cycles seen to work out new gains?
+                        pidGains.KP_V = constrain(Kp, 1.0, 200.0);                                      //  Yes, start using them (kept within the same limits as $PGV: allows)
+                        pidGains.KD_V = constrain(Kd, 0.0, 500.0);
+                        scale_PID_gains();
+                        pidGainsTuned = true;                                                           //  and have loop() save them away.
+                        set_ALT_mode(bulk_charge);                                                      // Back to charging, Bulk will move on to Acceptance if we are already at the target voltage.
+                        }
+                break;
+
+
+
+
+
           case determine_ALT_cap:
                 if ((systemConfig.ALT_AMPS_LIMIT != -1) ||                                              // If we are NOT configured to auto-determining the Alt Capacity,   --OR--
                     (fieldPWMvalue == FIELD_PWM_MAX)    ||                                              // we have Maxed Out the Field (PWM capping should have been removed during alt_cap mode) --OR--
@@ -1103,11 +1289,20 @@ void manage_ALT()  {
                 //      Finally, the regulator can be configured to disable Amp based determination of Exit-Acceptance and instead to a time-based exit criteria based on some factor
                 //      of the amount of timer we spent in Bulk.  This will happen if the user has entered -1 in the  EXIT_ACPT_AMPS, OR we do not seem to be able to measure any Amps
                 //      (ala, the user has not connected up the shunt).  Note that even with Adaptive Acceptance duration, we will never exceed the configured EXIT_ACPT_DURATION value.
+                //      Lastly, if EXIT_ACPT_DIDT is configured we will also move on once the Amps level off.  A full battery stops taking on more even if house loads (seen
+                //      by a shunt on the Alternator) keep the Amps from ever getting down to EXIT_ACPT_AMPS.
 
 
 
 
           case acceptance_charge:
+                if ((acptAmpsStarted != altModeChanged) || (!atTargVoltage)) {                          // New Acceptance phase, or not holding the voltage (so the Amps trend means little)?
+                    acptAmpsStarted = altModeChanged;                                                   //  Start watching the Amps trend over again.
+                    slope_reset(&acptAmpsSlope);
+                    }
+                acptAmpsFlat = slope_flat(&acptAmpsSlope, persistentBatAmps, enteredMills, ACPT_DIDT_WINDOW, workingParms.EXIT_ACPT_DIDT * systemAmpMult);
+                                                                                                        // (Kept up each time through, so there is always a full window to look back over)
+
                 if (((workingParms.EXIT_ACPT_DURATION > 0)                        &&
                      ((enteredMills - altModeChanged) >= workingParms.EXIT_ACPT_DURATION))      ||      // 3 ways to exit.  Have we have been in Acceptance Phase long enough?  --OR--
 
@@ -1119,7 +1314,12 @@ void manage_ALT()  {
                     (( workingParms.EXIT_ACPT_AMPS         >  0)                   &&                    // Is exiting by Amps enabled, and we have reached that threshold?
                      ((shuntAmpsMeasured == true) || (usingEXTAmps == true))       &&                    //  ... and does it look like we are even measuring Amps?
                      ( atTargVoltage)                                              &&                    //  ... Also, make sure the low amps are not because the engine is idling, or perhaps a large external load
-                     ( persistentBatAmps                   <= (workingParms.EXIT_ACPT_AMPS * systemAmpMult)))  ) {       //  has been applied.  We need to see low amps at the appropriate full voltage!
+                     ( persistentBatAmps                   <= (workingParms.EXIT_ACPT_AMPS * systemAmpMult)))  ||    //  has been applied.  We need to see low amps at the appropriate full voltage!
+                                                                                                        //                                                                      --OR--
+
+                    (( workingParms.EXIT_ACPT_DIDT         >  0)                   &&                    // Is exiting on the Amps leveling off enabled, and have they?
+                     ((shuntAmpsMeasured == true) || (usingEXTAmps == true))       &&                    //  ... again, only if we are measuring Amps
+                     ( acptAmpsFlat))  ) {                                                               //  (A full window at the target voltage has been seen, see above)
 
 
 
@@ -1193,6 +1393,7 @@ void manage_ALT()  {
 
                         set_ALT_mode(post_float);                                                       //  Yes, go into Post Float mode for now
                         fieldPWMvalue    = FIELD_PWM_MIN;                                               //  Turn off alternator
+                        fieldPWMfraction = 0;
                         PWMError         = 0;
                         }
 
@@ -1241,8 +1442,9 @@ void manage_ALT()  {
                         }
 
 
-                fieldPWMvalue = FIELD_PWM_MIN;                                                          //  If still in post Float mode, make sure to turn off alternator.
-                PWMError      = 0;
+                fieldPWMvalue    = FIELD_PWM_MIN;                                                       //  If still in post Float mode, make sure to turn off alternator.
+                fieldPWMfraction = 0;
+                PWMError         = 0;
 
                 break;
 
@@ -1275,7 +1477,8 @@ void manage_ALT()  {
                 PWMError      = 0;
                 LEDRepeat     = 0;                                                                      // And force a resetting of the LED blinking pattern
 
-                fieldPWMvalue = FIELD_PWM_MIN;                                                          //  Turn off alternator.
+                fieldPWMvalue    = FIELD_PWM_MIN;                                                       //  Turn off alternator.
+                fieldPWMfraction = 0;
                 break;
 
 
@@ -1295,20 +1498,97 @@ void manage_ALT()  {
 
 
 
+  #ifdef FIELD_FEED_FORWARD
+     //-----   Feed-forward:  While steady in Bulk (or sampling the Alt capacity) learn how many Amps each Field PWM step gives at these RPMs.
+     //        Then if the RPMs make a big move (say the engine is throttled back), set the Field straight to a little under where the map says
+     //        it will give the same Amps as before, rather then ramping up to it PWM_CHANGE_CAP at a time.  Only ever raise it this way, the PID does not
+     //        limit how fast it can pull the Field down.  Either way the PID trims things from there.  Only done in Bulk, as the map is learned:
+     //        once the Volts loop is in control (Acceptance, Float, ..) the Amps will be tapering off, and raising the Field back to hold the
+     //        old Amps would just push the battery over its target voltage.
+     //
+     ffSteady = (measuredRPMs > 0) && ((measuredRPMs - ffPriorRPMs) < FF_STEADY_RPMS) && ((ffPriorRPMs - measuredRPMs) < FF_STEADY_RPMS);
+
+     if ((ffRPMs > 0) && (measuredRPMs > 0)                                          &&                 // Have the RPMs moved a lot from where things were last steady?
+         (((measuredRPMs - ffRPMs) >= FF_RPM_JUMP) || ((ffRPMs - measuredRPMs) >= FF_RPM_JUMP))  &&     //  (Checked each time until they settle, so we end up using the
+         ((alternatorState == bulk_charge) || (alternatorState == determine_ALT_cap))) {                    //   map for where they settle)
+
+            ffSeedPWM = ff_pwm(&ffMap, measuredRPMs, ffAmps);                                           // Where does the map say the Field needs to be to hold the Amps we had?
+            ffSeedPWM = min(ffSeedPWM - ((ffSeedPWM * FF_SEED_MARGIN) / 100), fieldPWMLimit);          //  Stop a little short of it, and leave the PID to come the rest of
+                                                                                                        //  the way up.  (The map is only an estimate, better under then over)
+            if (ffSeedPWM > fieldPWMvalue) {
+                fieldPWMvalue    = ffSeedPWM;
+                fieldPWMfraction = 0;
+                PWMError         = min(PWMError, 0);                                                    // (Already made this adjustment's move up)
+                }
+            }
+
+     if (ffSteady) {
+            ffRPMs = measuredRPMs;                                                                      // Keep track of where things were steady
+            ffAmps = measuredAltAmps;
+
+            if (((alternatorState == bulk_charge) || (alternatorState == determine_ALT_cap))    &&     // And if in Bulk, learn from it.
+                (fieldPWMvalue == ffPriorPWM)                                                   &&
+                (AdErr < (FF_STEADY_AMPS * systemAmpMult)) && (AdErr > -(FF_STEADY_AMPS * systemAmpMult)))
+                    ff_learn(&ffMap, measuredRPMs, measuredAltAmps, fieldPWMvalue);
+            }
+
+     ffPriorRPMs = measuredRPMs;
+     ffPriorPWM  = fieldPWMvalue;
+    #endif
+
+
+
+
+
 
 
 
      //-----   Put out the PWM value to the Field control, making sure the adjusted value is within bounds.
      //        (And if the Tach mode is enabled, make sure we have SOME PWM)
      //
-     fieldPWMvalue += PWMError;                                                                         // Adjust the field value based on above calculations.
+     fineFieldPWM  = ((long)fieldPWMvalue * FIELD_PWM_STEPS) + fieldPWMfraction + PWMError;             // Adjust the field value based on above calculations.
      if (tachMode)
-        fieldPWMvalue = max(fieldPWMvalue, thresholdPWMvalue);                                          // But if Tach mode, do not let PWM drop too low - else tach will stop working.
+        fineFieldPWM = max(fineFieldPWM, (long)thresholdPWMvalue * FIELD_PWM_STEPS);                    // But if Tach mode, do not let PWM drop too low - else tach will stop working.
 
 
-     fieldPWMvalue = constrain(fieldPWMvalue, FIELD_PWM_MIN, fieldPWMLimit);                            // And in any case, always make sure we have not fallen out of bounds.
+     fineFieldPWM = constrain(fineFieldPWM, (long)FIELD_PWM_MIN * FIELD_PWM_STEPS, (long)fieldPWMLimit * FIELD_PWM_STEPS);   // And in any case, always make sure we have not fallen out of bounds.
 
-     set_ALT_PWM(fieldPWMvalue);                                                                        // Ok, after all that DO IT!  Update the PWM
+
+     //-----   Anti-windup:  A loop over its target winds its 'I' up if it takes on error that is not its to act on - because it did not have
+     //        the final say on the change (another loop asked for less, or the ramp, the Field cap or the Tach mode floor held the change
+     //        back), or because the Field has already been pulled back and the reading is on its way down.  Either way its 'I' is held
+     //        where it was.  A loop still under its target that did not get what it asked for is tracked back to the change that was made,
+     //        so as it closes in on its target it already holds about the pull-back it will need once it takes over.  (See pid_track())
+     //        Only while charging.
+     //
+     if ((alternatorState >= ramping) && (alternatorState <= RBM_CVCC) && (alternatorState != post_float)) {
+        PWMApplied = fineFieldPWM - (((long)fieldPWMvalue * FIELD_PWM_STEPS) + fieldPWMfraction);
+        pid_track(&ViErr, ViPrior, errorV, VdErr, (float) PWMErrorV / FIELD_PWM_STEPS, (float) PWMApplied / FIELD_PWM_STEPS, pidGains.KI_V, PID_TRACKING_GAIN, pidGains.I_WINDUP_CAP);
+        pid_track(&AiErr, AiPrior, errorA, AdErr, (float) PWMErrorA / FIELD_PWM_STEPS, (float) PWMApplied / FIELD_PWM_STEPS, pidGains.KI_A, PID_TRACKING_GAIN, pidGains.I_WINDUP_CAP);
+        pid_track(&WiErr, WiPrior, errorW, WdErr, (float) PWMErrorW / FIELD_PWM_STEPS, (float) PWMApplied / FIELD_PWM_STEPS, pidGains.KI_W, PID_TRACKING_GAIN, pidGains.I_WINDUP_CAP);
+        }
+
+
+     //-----   Take note of who is holding back the Field and add the time since the last adjustment to their count - so we can tell if a slow charge is down
+     //        to the battery voltage, the Amps or Watts (engine) limits, Alt temperature, the Ramp, full Field, or a de-rating (Small Alt / Half power mode,
+     //        idle pull-back ..).  Only while charging.
+     //
+     if ((alternatorState >= ramping) && (alternatorState <= RBM_CVCC) && (alternatorState != post_float)) {
+        limiterAsked[LIM_VOLTS]    = PWMErrorV;
+        limiterAsked[LIM_AMPS]     = PWMErrorA;
+        limiterAsked[LIM_WATTS]    = PWMErrorW;
+        limiterAsked[LIM_ALT_TEMP] = min(((TAMCounter == TAM_SENSITIVITY) ? PWMErrorTA : PWM_CHANGE_CAP * FIELD_PWM_STEPS),    // (The same way the Temp loop was
+                                         ((PWMErrorTA <= 0)               ? 0          : PWM_CHANGE_CAP * FIELD_PWM_STEPS));   //  brought in above)
+        limiterAsked[LIM_RAMP]     = rampAllow;
+
+        limiterInControl = limiter_of(limiterAsked, LIM_RAMP + 1, PWM_CHANGE_CAP * FIELD_PWM_STEPS, (fineFieldPWM >= (long)fieldPWMLimit * FIELD_PWM_STEPS), limiterDerated);
+        limiter_count(limiterTime, limiterInControl, min(enteredMills - limiterNoted, 2UL * pidGains.CHANGE_RATE));          // (A long gap, say after a fault, counts as only a couple of adjustments)
+        }
+     else
+        limiterInControl = LIM_NONE;
+     limiterNoted = enteredMills;
+
+     set_ALT_PWM(fineFieldPWM / FIELD_PWM_STEPS, fineFieldPWM % FIELD_PWM_STEPS);                      // Ok, after all that DO IT!  Update the PWM
 
 
      //-----    Before we leave, does the user want to see detailed Debug information of what just happened?
@@ -1317,6 +1597,7 @@ void manage_ALT()  {
      if ((sendDebugString == true) && (--SDMCounter  <= 0)) {
 
 #ifdef SYSTEMCAN
+       char offsetBuf[FIXED_STRING_SIZE];                                                              // RBM voltage offset is kept in mV, format it here.
        snprintf_P(charBuffer,OUTBOUND_BUFF_SIZE, PSTR("DBG;,%d.%03d, ,%d,%d, ,%d, ,%d,%d,%d,%d,%d, ,%d,%d, %c,%s,%s, ,%d,%d,%d,  ,%d,%d,%d,%s\r\n"),
 #else
        snprintf_P(charBuffer,OUTBOUND_BUFF_SIZE, PSTR("DBG;,%d.%03d, ,%d,%d, ,%d, ,%d,%d,%d,%d,%d, ,%d,%d, %c,%s,%s, ,%d,%d,%d\r\n"),
@@ -1362,12 +1643,15 @@ void manage_ALT()  {
                   , fetch_CAN_localID(),
                   CAN_RBM_sourceID,
                   ALT_Per_Util(),
-                  floatString(CAN_RBM_voltsOffset, 3)
+                  fixedString(offsetBuf, CAN_RBM_mVoltsOffset, 3)
 #endif
 
                    );
 
         Serial.write(charBuffer);
+#ifdef SYSTEMCAN
+        send_CAN_debug();
+#endif
         SDMCounter  = SDM_SENSITIVITY;
         }
 
@@ -29,8 +29,10 @@
 
 
 typedef enum  tModes {unknown, disabled, FAULTED, FAULTED_REDUCED_LOAD,                                                          // Used by most or all  (0..3)
-                     pending_R, ramping, determine_ALT_cap, bulk_charge, acceptance_charge, overcharge_charge, float_charge, forced_float_charge, post_float, equalize, RBM_CVCC} tModes; 
-                                                                                                                                // Alternator specific (4..14)
+                     pending_R, ramping, determine_ALT_cap, bulk_charge, acceptance_charge, overcharge_charge, float_charge, forced_float_charge, post_float, equalize, RBM_CVCC,
+                     auto_tune_V} tModes; 
+                                                                                                                                // Alternator specific (4..15)  (auto_tune_V was added at the end to keep the
+                                                                                                                                // values already known to the configuration tools)
                                                                                                                                 // Take care not to change the order of these, some tests use
                                                                                                                                 // things like <= pending_R
 
@@ -124,6 +126,28 @@ typedef struct  {                                               // System Config
 
 
 
+                                //----- Tuning values for the PID engine in manage_ALT().  Defaults are the KxPWM_x values in Config.h, they may be changed
+                                //      at run time via the $PGx: commands and are saved into EEPROM.  Changes take effect on the next PWM adjustment.
+
+typedef struct PIDS {                                           // PID Gains Structure
+
+   float        KP_V;                                           // Battery Voltage   Proportional, Integral, Derivative gains
+   float        KI_V;
+   float        KD_V;
+   float        KP_A;                                           // Alternator Amps
+   float        KI_A;
+   float        KD_A;
+   float        KP_W;                                           // Alternator (Engine) Watts
+   float        KI_W;
+   float        KD_W;
+   float        KP_TA;                                          // Alternator Temperature  (No 'I' is used)
+   float        KD_TA;
+   float        I_WINDUP_CAP;                                   // Limit of how much the accumulated 'I' may pull back the PWM.
+   int          CHANGE_RATE;                                    // Time (in mS) between adjustments of the PWM.
+   } PIDS;
+
+
+
 
 
 
@@ -143,13 +167,20 @@ extern int      measuredRPMs;
 extern bool     smallAltMode;
 extern bool     tachMode;
 extern int      fieldPWMvalue; 
+extern uint8_t  fieldPWMfraction;
 extern int      thresholdPWMvalue;
 extern bool     usingEXTAmps; 
 extern float    persistentBatAmps;
 extern float    persistentBatVolts;
+extern uint8_t  limiterInControl;
+extern unsigned long            limiterTime[];
+extern uint8_t  limiterDerated;
 
 extern CPS     workingParms;
 extern SCS     systemConfig;
+extern PIDS    pidGains;
+extern PIDS    pidScaled;
+extern bool    pidGainsTuned;
 
 extern float   systemVoltMult;
 extern float   systemAmpMult;
@@ -161,8 +192,9 @@ void stator_IRQ(void);
 void calculate_RPMs(void);
 void calculate_ALT_targets(void);
 void set_ALT_mode(tModes settingMode);
-void set_ALT_PWM(int  PWM);
+void set_ALT_PWM(int  PWM, uint8_t fraction = 0);
 void manage_ALT(void);
+void scale_PID_gains(void);
 bool initialize_alternator(void);
 
 #ifdef SYSTEMCAN 
@@ -44,15 +44,15 @@
                                                                 //
 
 const CPS PROGMEM defaultCPS[MAX_CPES] = {
-        //      Bulk/Accpt                  Overcharge                               Float                          Post Float              Equalization                    Temp Comp                   
-        {14.1, 6.0*3600000UL, 15,        0,  0.0,   0*3600000UL,        13.4,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.004*6, -9, -45, 52},  // #1 Default (safe) profile & AGM #1 (Low VOltage AGM).
-        {14.8, 3.0*3600000UL,  5,        0,  0.0,   0*3600000UL,        13.5,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.005*6, -9, -45, 52},  // #2 Standard FLA (e.g. Starter Battery, small storage)
-        {14.6, 4.5*3600000UL,  5,        0,  0.0,   0*3600000UL,        13.4,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,    15.3,  0, 3.0*60000UL, 0,     0.005*6, -9, -45, 52},  // #3 HD FLA (GC, L16, larger)
-        {14.7, 4.5*3600000UL,  3,        0,  0.0,   0*3600000UL,        13.4,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.004*6, -9, -45, 52},  // #4 AGM #2 (Higher Voltage AGM)
-        {14.1, 6.0*3600000UL,  5,        0,  0.0,   0*3600000UL,        13.5,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.005*6, -9, -45, 52},  // #5 GEL
-        {14.0, 1.0*3600000UL, 15,        0,  0.0,   0*3600000UL,        13.1,  -1, 0*3600000UL,   0,  0,  0.0,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.000*6, -9, -45, 52},  // #6 RESERVED (place saver of very safe values)
-        {14.4, 6.0*3600000UL, 15,       15, 15.3, 3.0*3600000UL,        13.1,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,    15.3,  0, 3.0*60000UL, 0,     0.005*6, -9, -45, 52},  // #7 4-stage HD LFA (+ Custom #1 changeable profile)  
-        {13.9, 1.0*3600000UL, 15,        0,  0.0,   0*3600000UL,        13.36,  0, 0*3600000UL,   0, 50, 13.3,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.000*6,  0,   0, 45}   // #8 LiFeP04        (+ Custom #2 changeable profile)
+        //      Bulk/Accpt                  Overcharge                               Float                          Post Float              Equalization                    Temp Comp          Accpt dI/dt
+        {14.1, 6.0*3600000UL, 15,        0,  0.0,   0*3600000UL,        13.4,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.004*6, -9, -45, 52,  0.0},  // #1 Default (safe) profile & AGM #1 (Low VOltage AGM).
+        {14.8, 3.0*3600000UL,  5,        0,  0.0,   0*3600000UL,        13.5,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.005*6, -9, -45, 52,  0.0},  // #2 Standard FLA (e.g. Starter Battery, small storage)
+        {14.6, 4.5*3600000UL,  5,        0,  0.0,   0*3600000UL,        13.4,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,    15.3,  0, 3.0*60000UL, 0,     0.005*6, -9, -45, 52,  0.0},  // #3 HD FLA (GC, L16, larger)
+        {14.7, 4.5*3600000UL,  3,        0,  0.0,   0*3600000UL,        13.4,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.004*6, -9, -45, 52,  0.0},  // #4 AGM #2 (Higher Voltage AGM)
+        {14.1, 6.0*3600000UL,  5,        0,  0.0,   0*3600000UL,        13.5,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.005*6, -9, -45, 52,  0.0},  // #5 GEL
+        {14.0, 1.0*3600000UL, 15,        0,  0.0,   0*3600000UL,        13.1,  -1, 0*3600000UL,   0,  0,  0.0,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.000*6, -9, -45, 52,  0.0},  // #6 RESERVED (place saver of very safe values)
+        {14.4, 6.0*3600000UL, 15,       15, 15.3, 3.0*3600000UL,        13.1,  -1, 0*3600000UL, -10,  0, 12.8,    0*3600000UL, 0.0, 0,    15.3,  0, 3.0*60000UL, 0,     0.005*6, -9, -45, 52,  0.0},  // #7 4-stage HD LFA (+ Custom #1 changeable profile)  
+        {13.9, 1.0*3600000UL, 15,        0,  0.0,   0*3600000UL,        13.36,  0, 0*3600000UL,   0, 50, 13.3,    0*3600000UL, 0.0, 0,     0.0,  0,   0*60000UL, 0,     0.000*6,  0,   0, 45,  0.0}   // #8 LiFeP04        (+ Custom #2 changeable profile)
         };
 
                                                                 // Side note:  The Arduino programming environment will place the above populated table into EPROM during compile time.
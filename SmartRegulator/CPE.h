@@ -51,7 +51,8 @@ typedef struct CPS {                                            // Charging Prof
                                                                 //                            or ADPT_ACPT_TIME_FACTOR adaptive duration.
                                                                 //      Set ExitAcptAmps = Same value used for LIMIT_OC_AMPS if Overcharge mode is to be used.
                                                                 //
-                                                                // FUTURE:  EXIT_ACPT_DVDT  Add dV/dt exit criteria for Acceptance mode, need to decide what it is :-)
+                                                                // See also EXIT_ACPT_DIDT below, to exit once the Amps level off.  (A dV/dt exit was once planned, but with the
+                                                                //      Volts held at ACPT_BAT_V_SETPOINT it is the Amps that show the battery is full)
 
 
 
@@ -99,6 +100,15 @@ typedef struct CPS {                                            // Charging Prof
    int           BAT_MIN_CHARGE_TEMP;                           // If Battery is below this temp (in deg-c), stop charging and force into Float Mode to protect it from under-temperature damage.
    int           BAT_MAX_CHARGE_TEMP;                           // If Battery exceeds this temp (in deg-c),  stop charging and force into Float Mode to protect it from over-temperature damage.
 
+
+
+                                                                // Members added after this point are not saved in the CPS's own EEPROM slot (so that adding them did not move, and
+                                                                //      invalidate, the profiles and structures already saved), but in the CPX block at the end of the EEPROM.  See Flash.h
+   float         EXIT_ACPT_DIDT;                                // Exit Accept mode once the Amps (while at the Accept voltage) have leveled off, changing by no more then this many Amps per hour
+                                                                //      across ACPT_DIDT_WINDOW.  A full battery stops taking more, even if house loads on an Alternator-side shunt keep the Amps
+                                                                //      from ever falling to EXIT_ACPT_AMPS.  (Voltage is held during Accept, so it is the slope of the Amps that tells us things)
+                                                                //      Set = 0 to disable.
+
    } CPS;
 
 
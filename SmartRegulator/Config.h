@@ -70,6 +70,15 @@
                                                                 //   with CPE #8.
 
 
+//#define FIELD_PWM_FINE                                        // Drive the Field in 1/4 PWM steps.  With large alternators one full PWM step can be a sizable jump in current, causing
+                                                                //   the voltage to 'hunt' around its target.  On the ATmega328 Timer1 is run in 10-bit mode, on other CPUs the 8-bit PWM
+                                                                //   is dithered between adjacent values to give the same average.
+
+//#define FIELD_FEED_FORWARD                                    // Learn how many Amps each Field PWM step gives at different engine RPMs (while steady in Bulk and Alt capacity
+                                                                //   sampling), and when the RPMs make a big jump set the Field straight to about where it needs to be instead of
+                                                                //   ramping up to it PWM_CHANGE_CAP steps at a time.  Needs the RPMs to be measured.
+
+
 
                                                                 
                                                                 
@@ -160,9 +169,14 @@
                                                             // (Note also this ratio is 'upside down' from typical - I did this so I could use a * instead of a / in the calc..)
  
     
+  #ifdef FIELD_PWM_FINE
+    #define  set_PWM_frequency() { TCCR1A = (TCCR1A & 0b11111100) | _BV(COM1A1) | 0x03;    \
+                                   TCCR1B = (TCCR1B & 0b11100000) | 0x03; }                 // Timer 1 in 10-bit Phase Correct mode, /64 --> still 122Hz.  And connect OC1A (pin 9) to the timer.
+    #define  FIELD_PWM_OCR       OCR1A                                                      // set_ALT_PWM() then loads the compare register directly (analogWrite() only knows 8-bits)
+  #else
     #define  set_PWM_frequency() TCCR1B = (TCCR1B & 0b11111000) | 0x04;                     // Set Timer 1 (Pin 9/10 PWM) to 122Hz (from default 488hz).  This more matches
                                                                                             // optimal Alternator Field requirements, as frequencies above 400Hz seem to send
-
+  #endif
     
     
     
@@ -439,6 +453,9 @@ typedef uint32_t prog_uint32_t;
 #define FAULT_ALT_TEMP                   1.1                    //  Fault if Alt Temp exceeds desired set point by 10%   
 #define FAULT_FET_TEMP                    70                    // If Field driver FETs are over 80c (Approx 160f), something is wrong with the FETs - fault.
 
+#define ACPT_DIDT_WINDOW             600000UL                   // When exiting Acceptance on the Amps leveling off (EXIT_ACPT_DIDT), look at how much they have changed over 10 minutes.
+                                                                // (persistentBatAmps looks back about a minute, this needs to be long enough to see a real trend through that.  Two windows in a row need to be level)
+
 #define ADPT_ACPT_TIME_FACTOR              5                    // If the regulators is operating in Adaptive Acceptance Duration mode (either because EXIT_ACPT_AMPS was set = -1, or
                                                                 // if we are unable to measure any amps), the amount of time we spend in Bulk phase will be multiplied by this factor, and
                                                                 // we will remain in Acceptance phase no longer then this, or EXIT_ACPT_DURATION - whichever is less.  This is in reality a backup
@@ -468,11 +485,23 @@ typedef uint32_t prog_uint32_t;
                                                         //  This same value is used to limit the highest value the user is allowed to enter using the $SCT ASCII command.
 #define PWM_CHANGE_CAP                2                 // Limits how much UP we will change the Field PWM in each time 'adjusting' it.
 
+#ifdef FIELD_PWM_FINE
+#define FIELD_PWM_FRAC_BITS           2                 // manage_ALT() works in 1/4 steps of the Field PWM  (fieldPWMvalue is still in 0..FIELD_PWM_MAX steps, 
+#else                                                   //  with the remainder held in fieldPWMfraction)
+#define FIELD_PWM_FRAC_BITS           0
+#endif
+#define FIELD_PWM_STEPS             (1 << FIELD_PWM_FRAC_BITS)
+
 #define PWM_CHANGE_RATE            100UL                // Time (in mS) between the 'adjustments' of the PWM.  Allows a settling period before making another move.
-#define PWM_RAMP_RATE              400UL                // When ramping, slow the rate of change down  to update only this often (in mS)  
+#define PWM_RAMP_RATE              400UL                // When ramping, slow the rate of change down to PWM_CHANGE_CAP every this many mS  (spread over each adjustment).
                                                         //    This combined with PWM_CHANGE_CAP will define the ramping time.
                                                         //    (for PWM to reach the FIELD_PWM_MAX value and exit Ramp).
 
+#define FF_RPM_JUMP                 300                 // FIELD_FEED_FORWARD:  RPMs have to move this much from where things were last steady for the Field to be re-set from the map.
+#define FF_STEADY_RPMS               25                 //  Steady = RPMs move by less then this ..
+#define FF_STEADY_AMPS              2.0                 //  .. and the Amps by less then this  (x systemAmpMult)  between PWM adjustments.
+#define FF_SEED_MARGIN               10                 //  The Field is only raised to this % under where the map puts it, the PID brings it the rest of the way.
+
    
                                                         // These are used to count down how many PWM_CHANGE_RATE cycles must pass before we look at the 
                                                         // these slow changing temperature values.  (TA = Alt)
@@ -504,10 +533,24 @@ typedef uint32_t prog_uint32_t;
 
 #define PID_I_WINDUP_CAP             0.9                // Capping value for the 'I' factor in the PID engines.  I is not allowed to influence the PWM any more then this limit 
                                                         // to prevent 'integrator Runaway' 
+#ifndef PID_TRACKING_GAIN
+#define PID_TRACKING_GAIN            1.0                // Anti-windup:  A loop under its target which did not get the PWM change it asked for moves its 'I' this fraction of the way
+                                                        // towards what would have made it agree with the change that was made, instead of accumulating its own error.  (See pid_track())
+#endif                                                  //  (0 turns the anti-windup off)
 
 #define PID_VOLTAGE_SENS            0.030               // When looking at mode transitions, if we come within 30mV of the target voltage (for rep 12v battery), consider we have 'met' that voltage condtion.
 
 
+                                //---- Auto-tuning of the Voltage PID gains  ($FRM:T)
+                                //     The Field PWM is toggled up/down around where it is when the test starts each time the battery voltage crosses the center point,
+                                //     and the resulting oscillation is measured to work out new KP_V / KD_V values.  (See relay_tune_gains() in Types.cpp)
+#define AUTOTUNE_PWM_STEP            10                 // Swing the Field PWM this many steps above and below its starting point.  (Less if the swing goes past AUTOTUNE_MAX_SWING)
+#define AUTOTUNE_HYSTERESIS         0.010               // Relay switches when VBat is 10mV past the center point (for rep 12v battery) - keeps noise from tripping it.
+#define AUTOTUNE_MAX_SWING          0.025               // Should VBat swing more then 25mV either side of the center point the PWM step is halved and the test started over,
+                                                        //  keeping well clear of the LD1_THRESHOLD load-dump check.
+#define AUTOTUNE_DURATION        60000UL                // Give up (leaving the gains unchanged) if a steady oscillation has not been measured in 60 seconds.
+
+
                                                           
                                 //---- Load Dump / Raw Overvoltage detection thresholds and actions.
                                 //     (These action occur asynchronous to the PID engine -- handled in real time linked to the ADCs sampling rate.)
@@ -544,10 +587,13 @@ typedef uint32_t prog_uint32_t;
                                                         // When deciding to change Alternator charge states, and adjust the throttle, we use persistent Watts and Amps.
                                                         // These are averaged values over X periods.  These are used to smooth changes in 
                                                         // Alternator State modes - to allow for short term bumps and dips.
-#define AMPS_PERSISTENCE_FACTOR          512            // Amps will be averaged over this number of samples at "PWM_CHANGE_RATE". (512 = a bit less then 1 minute look-back)
-                                                        // Set = 1L to disable  (Used to exit Acceptance and Float modes)
-#define VOLTS_PERSISTENCE_FACTOR        300             // Volts will be averaged over this number of samples at "PWM_CHANGE_RATE". (300 = ~1/2 min look-back)
-                                                        // Set = 1 to disable  (Used to exit post_float mode)
+                                                        // The averaging is done in fixed point with shifts, so the number of samples is given as a power of 2.
+#define AMPS_PERSISTENCE_SHIFT             9            // Amps will be averaged over 2^this number of samples at "PWM_CHANGE_RATE". (9 = 512 = a bit less then 1 minute look-back)
+                                                        // Set = 0 to disable  (Used to exit Acceptance and Float modes)
+#define VOLTS_PERSISTENCE_SHIFT            8            // Volts will be averaged over 2^this number of samples at "PWM_CHANGE_RATE". (8 = 256 = ~1/2 min look-back)
+                                                        // Set = 0 to disable  (Used to exit post_float mode)
+#define PERSISTENCE_AMPS_SCALE           256            // Fixed point scaling of the averaged Amps and Volts  (1/256A, 1/4096v).  Keep these powers of 2 as well,
+#define PERSISTENCE_VOLTS_SCALE         4096            //  so the conversion back to float is a multiply.  (Limited by 2^31 / 2^shift, ala 16,000A and 2,000v)
 
                                                         // Desensitizing parameters for deciding when to initiate a new Alternator Capacity Measurement cycle, 
 #define SAMPLE_ALT_CAP_RPM_THRESH      50               // Initiate a new Capacity Sample if we have seen in increase in RPMs / Amps from the prior reading.  
@@ -569,6 +615,14 @@ typedef uint32_t prog_uint32_t;
     
 #define INA226_CONFIG            0x4523                 // Configuration: Average 16 samples of 1.1mS A/Ds (17mS conversion time), mode=shunt&volt:triggered
 
+//#define INA226_FAST_LOAD_DUMP                         // Run the INA226 continuously with short, unaveraged, conversions.  A short average of the latest is checked by manage_ALT() for load-dump over-voltage
+                                                        //  as each one arrives, while the PID is still fed an average of them.  (Comment in to enable, else triggered 16x sampling only)
+#define INA226_CONFIG_FAST       0x4127                 // Configuration: 1 sample of 1.1mS A/Ds (2.2mS per Volts & Amps pair), mode=shunt&volt:continuous  (Also the INA226 power-on default)
+#define INA226_FAST_AVERAGE          8                  // Average this many fast conversions into one reading for the PID,
+#define INA226_FAST_WINDOW         18UL                 //  or however many have been read in this many mS  (In case loop() is not around to read each one)
+#define INA226_LD_AVERAGE            4                  // The load-dump checks look at the average of the last this many fast conversions (~9mS), so a single noisy one
+                                                        //  does not trip LD1.  (Keep to a power of 2)
+
 
 
 
@@ -169,6 +169,25 @@ void write_SCS_EEPROM(SCS *scsPtr) {
 
 
 
+//------------------------------------------------------------------------------------------------------
+// Read CPX EEPROM
+//
+//      Fetches the CPX block (the additions to all the saved Charge Profiles) into the passed buffer, and returns TRUE if
+//      it has been saved and its CRC checks out.
+//
+//------------------------------------------------------------------------------------------------------
+
+static bool read_CPX_EEPROM(CPX *cpxPtr) {
+
+   eeprom_read_block((void *)cpxPtr, (void *) CPX_FLASH_LOCAITON, sizeof(CPX));
+
+   return((cpxPtr->CPX_ID1 == CPX_ID1_K) && (cpxPtr->CPX_ID2 == CPX_ID2_K) &&
+          (calc_crc ((uint8_t*)cpxPtr->EXIT_ACPT_DIDT, sizeof(cpxPtr->EXIT_ACPT_DIDT)) == cpxPtr->CPX_CRC32));
+}
+
+
+
+
 //------------------------------------------------------------------------------------------------------
 // Read CPS EEPROM
 //
@@ -186,15 +205,21 @@ bool read_CPS_EEPROM(uint8_t index, CPS *cpsPtr) {
    EKEY  key;                                                                           // Structure used to see validate the presence of saved data.
 
 
+   CPX   cpx;
+
+
    eeprom_read_block((void *)&key, (const void *)EKEY_FLASH_LOCAITON  , sizeof(EKEY));  // Fetch the EKEY structure from EEPROM
 
    if  ((key.CPS_ID1[index] == CPS_ID1_K) && (key.CPS_ID2[index] == CPS_ID2_K)) {       // How about the Charge Profile tables? . . 
 
-        eeprom_read_block((void*)&buff, (void *)CPS_FLASH_LOCAITON, sizeof(CPS));
+        transfer_default_CPS(index, &buff);                                             // (Members past CPS_SAVED_SIZE start out with their defaults)
+        eeprom_read_block((void*)&buff, (void *)CPS_FLASH_LOCAITON, CPS_SAVED_SIZE);
                                                                                         //  . .  let's fetch it from EEPROM and see if the CRCs check out..
         
-        if (calc_crc ((uint8_t*)&buff, sizeof(CPS)) == key.CPS_CRC32[index]) {
-                *cpsPtr = buff;                                                         //  Looks valid, copy the working buffer into RAM
+        if (calc_crc ((uint8_t*)&buff, CPS_SAVED_SIZE) == key.CPS_CRC32[index]) {
+                if (read_CPX_EEPROM(&cpx))                                              //  Looks valid, pick up the additions if they have been saved as well
+                    buff.EXIT_ACPT_DIDT = cpx.EXIT_ACPT_DIDT[index];
+                *cpsPtr = buff;                                                         //  and copy the working buffer into RAM
                 return(true);
                 }
         }
@@ -220,6 +245,7 @@ bool read_CPS_EEPROM(uint8_t index, CPS *cpsPtr) {
 void write_CPS_EEPROM(uint8_t index, CPS *cpsPtr) {                                     // Save/flush entry 'index'
 
    EKEY  key;                                                                           // Structure used to see validate the presence of saved data.
+   CPX   cpx;
 
  
    eeprom_read_block((void *)&key, (void *) EKEY_FLASH_LOCAITON  , sizeof(EKEY));       // Fetch the EKEY structure from EEPROM to update appropriate portions
@@ -228,7 +254,7 @@ void write_CPS_EEPROM(uint8_t index, CPS *cpsPtr) {
   if (cpsPtr != NULL) {
         key.CPS_ID1[index] = CPS_ID1_K;                                                 // User wants to save the current systemConfig structure to EEPROM
         key.CPS_ID2[index] = CPS_ID2_K;                                                 // Put in validation tokens
-        key.CPS_CRC32[index] = calc_crc ((uint8_t*)cpsPtr, sizeof(CPS));
+        key.CPS_CRC32[index] = calc_crc ((uint8_t*)cpsPtr, CPS_SAVED_SIZE);
 
         #if !defined DEBUG && !defined SIMULATION
            if ((systemConfig.BT_CONFIG_CHANGED == false) ||                             // Wait a minute: Before we do any actual changes. . if the Bluetooth 
@@ -236,14 +262,24 @@ void write_CPS_EEPROM(uint8_t index, CPS *cpsPtr) {
               return;
               #endif                                                                    // (But do this check only if not in 'testing' mode!
 
-        eeprom_write_block((void*)cpsPtr, (void *)CPS_FLASH_LOCAITON, sizeof(CPS));
-        }                                                                               // And write out the indexed CPE entry
+        eeprom_write_block((void*)cpsPtr, (void *)CPS_FLASH_LOCAITON, CPS_SAVED_SIZE);
+                                                                                        // And write out the indexed CPE entry
+        if (!read_CPX_EEPROM(&cpx)) {                                                   // Followed by its additions, into the CPX block.
+            for (uint8_t i=0; i < MAX_CPES; i++)                                        //  (If this is the 1st time for CPX, the other profiles get their defaults)
+                cpx.EXIT_ACPT_DIDT[i] = pgm_read_float(&defaultCPS[i].EXIT_ACPT_DIDT);
+            }
+        cpx.EXIT_ACPT_DIDT[index] = cpsPtr->EXIT_ACPT_DIDT;
+        cpx.CPX_ID1   = CPX_ID1_K;
+        cpx.CPX_ID2   = CPX_ID2_K;
+        cpx.CPX_CRC32 = calc_crc ((uint8_t*)cpx.EXIT_ACPT_DIDT, sizeof(cpx.EXIT_ACPT_DIDT));
+        eeprom_write_block((void*)&cpx, (void *)CPX_FLASH_LOCAITON, sizeof(CPX));
+        }
         
   else  {
         key.CPS_ID1[index]   = 0;                                                       // User wants to invalidate the EEPROM saved info.  
         key.CPS_ID2[index]   = 0;                                                       // So just zero out the validation tokens
         key.CPS_CRC32[index] = 0;                                                       // And the CRC-32 to make dbl sure.
-        }
+        }                                                                               // (The CPX entry is left alone, it is only used along with a valid CPS)
 
      eeprom_write_block((void *)&key, (void *) EKEY_FLASH_LOCAITON  , sizeof(EKEY));    // Save back the updated EKEY structure
 
@@ -361,6 +397,87 @@ void write_CAL_EEPROM(CAL *calPtr) {
 
 
 
+//------------------------------------------------------------------------------------------------------
+// Read PID EEPROM
+//
+//      This function will see if there is a valid PID Gains structure saved in the EEPROM.
+//      If so, it will copy it from the EEPROM into the passed buffer and return TRUE.
+//
+//
+//
+//------------------------------------------------------------------------------------------------------
+
+bool read_PID_EEPROM(PIDS *pidPtr) {
+
+   PIDS  buff;
+   PKEY  key;                                                                           // Structure used to see validate the presence of saved data.
+
+
+   eeprom_read_block((void *)&key, (void *) PKEY_FLASH_LOCAITON, sizeof(PKEY));         // Fetch the PKEY structure from EEPROM
+
+   if  ((key.PID_ID1 == PID_ID1_K) && (key.PID_ID2 == PID_ID2_K)) {                     // We may have a valid pidGains structure . . 
+
+        eeprom_read_block((void*)&buff, (void *)PID_FLASH_LOCAITON, sizeof(PIDS));     
+                                                                                        //  . .  lets fetch it from EEPROM and see if the CRCs check out..
+        if (calc_crc ((uint8_t*)&buff, sizeof(PIDS)) == key.PID_CRC32) {
+            *pidPtr = buff;                                                             //  Looks valid, copy the working buffer into RAM
+             return(true);
+             }
+        }
+
+    return(false);                                                                      // Did not make it through all the checks...
+}
+
+
+
+
+//------------------------------------------------------------------------------------------------------
+// Write PID EEPROM
+//
+//      If a pointer is passed into this function it will write the passed PID Gains structure into the EEPROM and update the
+//      PKEY validation values.   If NULL is passed in for the data pointer, the saved PIDS will be invalidated in the EEPROM
+//
+//
+//
+//------------------------------------------------------------------------------------------------------
+
+void write_PID_EEPROM(PIDS *pidPtr) {
+
+   PKEY  key;                                                                           // Structure used to see validate the presence of saved data.
+
+
+  if (pidPtr != NULL) {
+        key.PID_ID1   = PID_ID1_K;                                                      // User wants to save the passed pidGains structure to EEPROM
+        key.PID_ID2   = PID_ID2_K;                                                      // Put in validation tokens
+        key.PID_CRC32 = calc_crc ((uint8_t*)pidPtr, sizeof(PIDS));
+
+        
+        #if !defined DEBUG && !defined SIMULATION
+           if ((systemConfig.BT_CONFIG_CHANGED == false) ||                             // Wait a minute: Before we do any actual changes. . if the Bluetooth 
+               (systemConfig.CONFIG_LOCKOUT   != 0))                                    // has not been made a bit more secure, or if we are locked out, prevent any update.
+              return;
+              #endif                                                                    // (But do this check only if not in 'testing' mode!
+
+
+        eeprom_write_block((void*)pidPtr, (void *)PID_FLASH_LOCAITON, sizeof(PIDS));
+        }                                                                               // And write out the current structure
+        
+  else  {
+        key.PID_ID1   = 0;                                                              // User wants to invalidate the EEPROM saved info.  
+        key.PID_ID2   = 0;                                                              // So just zero out the validation tokens
+        key.PID_CRC32 = 0;                                                              // And the CRC-32 to make dbl sure.
+        }
+        
+  eeprom_write_block((void *)&key, (void *)PKEY_FLASH_LOCAITON, sizeof(PKEY));         // Save back the updated PKEY structure
+
+}
+
+
+
+
+
+
+
 #ifdef SYSTEMCAN  
 
 //------------------------------------------------------------------------------------------------------
@@ -474,6 +591,8 @@ void    restore_all(){
 
      for (b=0; b<MAX_CPES; b++) 
         write_CPS_EEPROM(b, NULL);                                                      // Erase any saved charge profiles structures in the EEPROM
+
+     write_PID_EEPROM(NULL);                                                            // And the PID Gains
     
      #ifdef SYSTEMCAN
        write_CCS_EEPROM(NULL);                                                          // CANConfig structure as well
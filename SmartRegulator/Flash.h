@@ -39,6 +39,8 @@ void write_CAL_EEPROM(CAL *calPtr);
 bool read_CPS_EEPROM(uint8_t index, CPS *cpsPtr); 
 bool read_SCS_EEPROM(SCS *scsPtr);
 bool read_CAL_EEPROM(CAL *calPtr);
+bool read_PID_EEPROM(PIDS *pidPtr);
+void write_PID_EEPROM(PIDS *pidPtr);
 void restore_all(void);
 void commit_EEPROM(void);
 
@@ -62,6 +64,10 @@ void commit_EEPROM(void);
 #define CAL_ID2_K  0x0A97
 #define CCS_ID1_K  0x813A                                       // CAN structure                
 #define CCS_ID2_K  0xC03A
+#define PID_ID1_K  0x5A1D                                       // PID Gains structure
+#define PID_ID2_K  0x91C4
+#define CPX_ID1_K  0x3D82                                       // Charge Profile additions (CPS members past CPS_SAVED_SIZE)
+#define CPX_ID2_K  0xE619
 
 
 
@@ -75,9 +81,18 @@ void commit_EEPROM(void);
 
 #define  EKEY_FLASH_LOCAITON  0
 #define  CAL_FLASH_LOCAITON  (sizeof(EKEY))
-#define  CPS_FLASH_LOCAITON  (sizeof(EKEY) + sizeof(CAL) + 32 + (sizeof(CPS)*index))               
-#define  SCS_FLASH_LOCAITON  (sizeof(EKEY) + sizeof(CAL) + 32 + (sizeof(CPS)*MAX_CPES)) 
-#define  CCS_FLASH_LOCAITON  (sizeof(EKEY) + sizeof(CAL) + 32 + (sizeof(CPS)*MAX_CPES)  + sizeof(SCS))
+#define  CPS_FLASH_LOCAITON  (sizeof(EKEY) + sizeof(CAL) + 32 + (CPS_SAVED_SIZE*index))               
+#define  SCS_FLASH_LOCAITON  (sizeof(EKEY) + sizeof(CAL) + 32 + (CPS_SAVED_SIZE*MAX_CPES)) 
+#define  CCS_FLASH_LOCAITON  (sizeof(EKEY) + sizeof(CAL) + 32 + (CPS_SAVED_SIZE*MAX_CPES)  + sizeof(SCS))
+#ifdef SYSTEMCAN
+#define  PKEY_FLASH_LOCAITON (CCS_FLASH_LOCAITON + sizeof(CCS))
+#else
+#define  PKEY_FLASH_LOCAITON (CCS_FLASH_LOCAITON)
+#endif
+#define  PID_FLASH_LOCAITON  (PKEY_FLASH_LOCAITON + sizeof(PKEY))
+#define  CPX_FLASH_LOCAITON  (PID_FLASH_LOCAITON  + sizeof(PIDS))
+
+#define  CPS_SAVED_SIZE      (offsetof(CPS, EXIT_ACPT_DIDT))    // Only the part of a CPS that was there before 0.2.x lives in its CPS slot, the rest goes into CPX
 
 
                                                             
@@ -101,6 +116,24 @@ typedef struct EKEY {                                           // EEPROM Key St
    unsigned long CAL_CRC32;                                     //  CRC-32 of last stored ADCCal structure
    
    } EKEY;
+
+
+
+typedef struct PKEY {                                           // Key for the PID Gains structure.  Kept with the PIDS at the end of the EEPROM, rather than in EKEY,
+   unsigned      PID_ID1;                                       //  so that adding it did not move (and so invalidate) the CAL, CPS, SCS and CCS structures already saved.
+   unsigned      PID_ID2;
+   unsigned long PID_CRC32;                                     //  CRC-32 of last stored pidGains structure
+   } PKEY;
+
+
+
+typedef struct CPX {                                            // Charge Profile additions:  the CPS members added after CPS_SAVED_SIZE, for every profile, with their own key.
+   unsigned      CPX_ID1;                                       //  As with PKEY, kept at the end of the EEPROM so that growing the CPS did not move (and so invalidate) the
+   unsigned      CPX_ID2;                                       //  saved CPS, SCS, CCS and PIDS structures.
+   unsigned long CPX_CRC32;                                     //  CRC-32 of the EXIT_ACPT_DIDT[] table below
+
+   float         EXIT_ACPT_DIDT[MAX_CPES];
+   } CPX;
                                                         
 
 
@@ -80,6 +80,11 @@ int     measuredFieldAmps  = -99;                                       // What
 
 bool    updatingVAs       = false;                                      // Are we in the process of updating the Volts and Amps?  (Meaning, hold off doing anything critical until we get new data..)
 
+#ifdef INA226_FAST_LOAD_DUMP
+float   fastAltVolts      = 0.0;                                        // Latest single (unaveraged) INA226 voltage conversion,
+bool    fastAltVoltsReady = false;                                      //  and has manage_ALT() looked at it yet?
+#endif
+
 
 
 //----- Calibration buffer 
@@ -138,6 +143,17 @@ int16_t savedShuntRawADC;                                               // Place
           
 int  normalizeNTCAverage(unsigned long accumalatedSample, int beta, bool hasRG);
 int  read_INA226(void);
+void store_INA226(int16_t rawVolts, int16_t rawShunt);
+
+#ifdef INA226_FAST_LOAD_DUMP
+long          fastVoltsAccum;                                           // Accumulated raw INA226 conversions, averaged by store_INA226() into one Volts & Amps reading.
+long          fastShuntAccum;
+uint8_t       fastSamples;
+unsigned long fastWindowStarted;                                        // When did sample_ALT_VoltAmps() start this averaging window?
+int16_t       fastLDVolts[INA226_LD_AVERAGE];                           // The last few raw Volts conversions, and their sum, for the load-dump checks.
+long          fastLDSum;
+uint8_t       fastLDNext;
+#endif
 void sample_NTCs(void);
 void read_NTCs(void);
 void calibrate_ADCs(void);
@@ -394,12 +410,22 @@ bool  read_sensors(void) {
 //------------------------------------------------------------------------------------------------------
 
 bool sample_ALT_VoltAmps(void) {
+
+  #ifdef INA226_FAST_LOAD_DUMP
+    #define INA226_SAMPLE_CONFIG   INA226_CONFIG_FAST                                   // In continuous mode, a write restarts the conversions (and restores the config should the INA226 have reset),
+    fastVoltsAccum    = 0;                                                              //  and here we start a new averaging window.
+    fastShuntAccum    = 0;
+    fastSamples       = 0;
+    fastWindowStarted = millis();
+  #else
+    #define INA226_SAMPLE_CONFIG   INA226_CONFIG
+    #endif
     
   #ifdef CPU_AVR
     uint8_t ptr[2];
 
-    ptr[0] = highByte(INA226_CONFIG);                                                   // Config current & Vbat INA226
-    ptr[1] = lowByte (INA226_CONFIG);
+    ptr[0] = highByte(INA226_SAMPLE_CONFIG);                                            // Config current & Vbat INA226
+    ptr[1] = lowByte (INA226_SAMPLE_CONFIG);
        I2c.write(INA226_I2C_ADDRESS,CONFIG_REG, ptr, 2);                                // Writing the Config reg also 'triggers' a INA226 sample cycle.
     #endif
    
@@ -409,8 +435,8 @@ bool sample_ALT_VoltAmps(void) {
   #ifdef CPU_AVRCAN
     i2c_start(INA226_I2C_ADDRESS<<1 | I2C_WRITE);
     i2c_write(CONFIG_REG);                                                              // Writing the Config reg also 'triggers' a INA226 sample cycle.
-    i2c_write(highByte(INA226_CONFIG));                                                 // MSB always goes 1st
-    i2c_write( lowByte(INA226_CONFIG));
+    i2c_write(highByte(INA226_SAMPLE_CONFIG));                                          // MSB always goes 1st
+    i2c_write( lowByte(INA226_SAMPLE_CONFIG));
     i2c_stop();
     #endif
    
@@ -671,8 +697,8 @@ void resolve_BAT_VoltAmpTemp(void) {
       
             //----  Look at Remote Instrumentation of Amps.
             if ((enteredMills - CAN_RBM_ampsRefreshed) < REMOTE_CAN_MASTER_TIMEOUT) {               // Validate that we received an Amps message recently
-                if (abs(CAN_RBM_amps) <= MAX_SUPPORTED_SYSTEM_AMPS) {
-                    measuredBatAmps = CAN_RBM_amps;                                                 // Amps move slowly.  Just use the passed value for the next time period until a new one arrives.
+                if (labs(CAN_RBM_mAmps) <= (MAX_SUPPORTED_SYSTEM_AMPS * 1000L)) {
+                    measuredBatAmps = CAN_RBM_mAmps * 0.001;                                        // Amps move slowly.  Just use the passed value for the next time period until a new one arrives.
                     usingEXTAmps = true;
                 } else
                     ignoringRBM = true;                                                             // Whoa here!  WHAT is this guy saying??  So many amps??  Seems nuts.  We will ignore this guy from now on.
@@ -692,19 +718,21 @@ void resolve_BAT_VoltAmpTemp(void) {
                    
             //----- Look at Remote Instrumentation of Volts
             if ((enteredMills - CAN_RBM_voltsRefreshed) < REMOTE_CAN_MASTER_TIMEOUT) {              // Validate that we received a Volt message recently
-                if ((abs(CAN_RBM_voltsOffset) <= MAX_SUPPORTED_SYSTEM_VOFFSET)                && 
-                    (CAN_RBM_volts            <= (FAULT_BAT_VOLTS_EQUALIZE * systemVoltMult)) && 
-                    (CAN_RBM_volts            >= (FAULT_BAT_VOLTS_LOW      * systemVoltMult))) {
+                long svMult = scaleFloat(systemVoltMult, 2);                                        // (In 1/100ths, so the limits below are all integer mV)
+
+                if ((labs(CAN_RBM_mVoltsOffset) <= MAX_SUPPORTED_SYSTEM_mVOFFSET)                              &&
+                    (CAN_RBM_mVolts             <= ((long)(FAULT_BAT_VOLTS_EQUALIZE * 1000) * svMult / 100)) &&
+                    (CAN_RBM_mVolts             >= ((long)(FAULT_BAT_VOLTS_LOW      * 1000) * svMult / 100))) {
                     
-                    if (fieldPWMvalue < CAN_RBM_voPWMvalue)
-                        measuredBatVolts = measuredAltVolts + (CAN_RBM_voltsOffset * (fieldPWMvalue-thresholdPWMvalue)/(CAN_RBM_voPWMvalue-thresholdPWMvalue));
+                    if ((fieldPWMvalue < CAN_RBM_voPWMvalue) && (CAN_RBM_voPWMvalue > thresholdPWMvalue))
+                        measuredBatVolts = measuredAltVolts + (CAN_RBM_mVoltsOffset * (fieldPWMvalue-thresholdPWMvalue)/(CAN_RBM_voPWMvalue-thresholdPWMvalue)) * 0.001;
                                                                                                     // Applying Ohms Law here, if we have dramatically lowered the PWM from when we last received a Remote Instrument VBat,
                                                                                                     // we should 'anticipate' the offset will also be lower.
                                                                                                     // Without doing this correction we will tend of over-drive the alternator, and overshoot the VBat target.
                                                                                                     // This is a rough-n-ready correction, but without this even in simple systems lowering the PWM dramatically can cause 100mV to even 200mV
                                                                                                     // delta; and given we try to regulate to a +/- 10mV goal, that is massive....
                     else
-                        measuredBatVolts = measuredAltVolts + CAN_RBM_voltsOffset;                  // Only apply a amperage based reduction factor with lowered PWMs.  Never do an uplift!  
+                        measuredBatVolts = measuredAltVolts + CAN_RBM_mVoltsOffset * 0.001;         // Only apply a amperage based reduction factor with lowered PWMs.  Never do an uplift!  
                                                                                                     //   (Better to undershoot until a new remote offset value is received..)
                                                                                                     
                     
@@ -761,7 +789,7 @@ void resolve_BAT_VoltAmpTemp(void) {
 int read_INA226(void) {
 
 #ifdef CPU_AVR
-  int16_t i;
+  int16_t i, v;
 
                 //--- Do we have anything to read?   Check the VBat+, Alternator AMPs sensor.
 
@@ -775,10 +803,8 @@ int read_INA226(void) {
     if ((i = I2c.read(INA226_I2C_ADDRESS, VOLTAGE_REG, 2)) != 0)                        // Check Valt
         return(i);                                                                      // If I2C read error (non zero return), return error and skip the rest.
 
-    i  = I2c.receive() <<8;
-    i |= I2c.receive(); 
- 
-    measuredAltVolts  = i * 0.00125 * VALT_SCALER * ADCCal.VBatGainError;                // Each bit = 1.25mV, and adjust for the pre-scaling resisters.
+    v  = I2c.receive() <<8;
+    v |= I2c.receive(); 
 
 
     
@@ -799,8 +825,7 @@ int read_INA226(void) {
     //****************************************************************************************************************************
 
                                                                                         
-    measuredAltAmps  = (i - ADCCal.AmpOffset)  * 0.0000025 * AALT_SCALER * (float)systemConfig.AMP_SHUNT_RATIO;  // Each bit = 2.5uV Shunt Voltage.  Adjust by Shunt ratio and internal dividers (R22/R24)
-    updatingVAs = false;                                                                //   All done, ready to do another synchronized sample session anytime.
+    store_INA226(v, i);                                                                 //   All done, ready to do another synchronized sample session anytime.
     }
 
 
@@ -811,7 +836,7 @@ return (0);
 
 
 #ifdef CPU_AVRCAN
-  int16_t i;
+  int16_t i, v;
                 //--- Do we have anything to read from the INA226?   Check the VAlt+, AMPs sensor.
 
    if (!i2c_start(INA226_I2C_ADDRESS<<1 | I2C_WRITE)) return(1);                            // Initiate an I2C read operation - send out which register we want to read.
@@ -834,11 +859,9 @@ return (0);
      i2c_stop();
  
      if (!i2c_rep_start(INA226_I2C_ADDRESS<<1 | I2C_READ))  return(6); 
-     i  = i2c_read(false) <<8;
-     i |= i2c_read(true);  
+     v  = i2c_read(false) <<8;
+     v |= i2c_read(true);  
      i2c_stop();
-
-     measuredAltVolts  = i * 0.00125 * VALT_SCALER * ADCCal.VBatGainError;                       // Each bit = 1.25mV, and adjust for the pre-scaling resisters.
  
 
  
@@ -851,10 +874,7 @@ return (0);
      i |= i2c_read(true);                                                       
      i2c_stop();
 
-     savedShuntRawADC = i;                                                                   // Tuck this raw value away in case we are doing a auto-calibration procedure (See cal_ADCs())
-     measuredAltAmps  = (i - ADCCal.AmpOffset)  * 0.0000025 * AALT_SCALER * (float)systemConfig.AMP_SHUNT_RATIO;  
-                                                                                             // Each bit = 2.5uV Shunt Voltage.  Adjust by Shunt ratio and internal dividers 
-     updatingVAs = false;                                                                   //   All done, ready to do another synchronized sample session.
+     store_INA226(v, i);                                                                     //   All done, ready to do another synchronized sample session.
      }
 
 return (0);
@@ -868,6 +888,46 @@ return (0);
 
 
 
+//------------------------------------------------------------------------------------------------------
+// Store INA-226
+//      Called by read_INA226() with each raw Volts and Shunt reading.  Scales them into measuredAltVolts and measuredAltAmps.
+//      With INA226_FAST_LOAD_DUMP every reading is first handed to manage_ALT() via fastAltVolts for the load-dump checks (as the
+//      average of the last INA226_LD_AVERAGE), and then readings are averaged here, with measuredAltVolts/Amps only being updated
+//      once the averaging window is complete.
+//
+//------------------------------------------------------------------------------------------------------
+
+void store_INA226(int16_t rawVolts, int16_t rawShunt) {
+
+  #ifdef INA226_FAST_LOAD_DUMP
+    fastLDSum               += rawVolts - fastLDVolts[fastLDNext];                          // A short running average for the load-dump checks, so one noisy
+    fastLDVolts[fastLDNext]  = rawVolts;                                                    //  conversion does not look like a load dump.
+    fastLDNext               = (fastLDNext + 1) % INA226_LD_AVERAGE;
+    fastAltVolts             = (fastLDSum / INA226_LD_AVERAGE) * 0.00125 * VALT_SCALER * ADCCal.VBatGainError;
+    fastAltVoltsReady        = true;
+
+    if (!updatingVAs)                                                                       // Already delivered this window's average, wait for sample_ALT_VoltAmps() to start the next one.
+        return;
+
+    fastVoltsAccum += rawVolts;
+    fastShuntAccum += rawShunt;
+    if ((++fastSamples < INA226_FAST_AVERAGE) && ((millis() - fastWindowStarted) < INA226_FAST_WINDOW))
+        return;
+
+    rawVolts = fastVoltsAccum / fastSamples;
+    rawShunt = fastShuntAccum / fastSamples;
+    #endif
+
+    measuredAltVolts = rawVolts * 0.00125 * VALT_SCALER * ADCCal.VBatGainError;              // Each bit = 1.25mV, and adjust for the pre-scaling resisters.
+    savedShuntRawADC = rawShunt;                                                             // Tuck this raw value away in case we are doing a auto-calibration procedure (See cal_ADCs())
+    measuredAltAmps  = (rawShunt - ADCCal.AmpOffset)  * 0.0000025 * AALT_SCALER * (float)systemConfig.AMP_SHUNT_RATIO;
+                                                                                             // Each bit = 2.5uV Shunt Voltage.  Adjust by Shunt ratio and internal dividers (R22/R24)
+    updatingVAs      = false;
+}
+
+
+
+
 
 //------------------------------------------------------------------------------------------------------
 // Sample NTC's
@@ -1004,7 +1064,8 @@ void update_run_summary(void) {
   
 
 
-   if ((alternatorState >= pending_R) && (alternatorState <= equalize)) {                       //  If the Alternator is running, update the last-run vars.
+   if (((alternatorState >= pending_R) && (alternatorState <= equalize)) ||                     //  If the Alternator is running, update the last-run vars.
+        (alternatorState == auto_tune_V)) {
         generatorLrRunTime = millis() - generatorLrStarted;
         accumulatedLrAH    += measuredAltAmps;
         accumulatedLrWH    += measuredAltWatts;
@@ -34,6 +34,10 @@ typedef struct CAL {                                        // Calibration Struc
       
 
 extern bool    updatingVAs;
+#ifdef INA226_FAST_LOAD_DUMP
+extern float   fastAltVolts;
+extern bool    fastAltVoltsReady;
+#endif
 extern bool    shuntAmpsMeasured; 
 
 extern float   measuredAltVolts;
@@ -302,6 +302,7 @@ void setup() {
 
                                                                                         
    read_SCS_EEPROM(&systemConfig);                                                      // See if there are valid structures that have been saved in the EEPROM to overwrite the default (as-compiled) values
+   read_PID_EEPROM(&pidGains);
    read_CAL_EEPROM(&ADCCal);                                                            // See if there is an existing Calibration structure contained in the EEPROM.
 
    #ifdef SYSTEMCAN                                                                                     
@@ -904,6 +905,7 @@ void update_LED() {
   switch (alternatorState) {
         case ramping:
         case determine_ALT_cap:
+        case auto_tune_V:
         case bulk_charge: 
         case RBM_CVCC:                  blink_LED (LED_BULK,       LED_RATE_NORMAL, -1, false);
                                         break;
@@ -1260,6 +1262,7 @@ bool  check_for_faults() {
         
                 case bulk_charge:                                                               //  Do some more checks if we are running.
                 case determine_ALT_cap:
+                case auto_tune_V:
                 case ramping:
                 case acceptance_charge:
                 case overcharge_charge:
@@ -1509,6 +1512,11 @@ void loop()  {
         manage_ALT();                                                                                   // OK we are not faulted, we have made all our calculations. . . let's set the Alternator Field.
         manage_system_state();                                                                          // See if the overall System State needs changing.
 
+        if (pidGainsTuned) {                                                                            // Did an auto-tune just finish?  Save the new gains now the Field has been set,
+            pidGainsTuned = false;                                                                      //  rather then holding up manage_ALT() while the EEPROM is written.
+            write_PID_EEPROM(&pidGains);
+            }
+
 
 
   //
@@ -22,27 +22,542 @@
 #include <Arduino.h>
 #include "Types.h"
 
+// fixedString formats a scaled integer (mV with 3 decimals, cA with 2, deci-degrees with 1, ...)
+// as [-]whole.fraction into the caller supplied buffer of at least FIXED_STRING_SIZE bytes.
+// Only integer math and no static state is used, so it is reentrant.  Returns buf.
+char *fixedString(char *buf, long value, unsigned char decimals) {
+    char digits[FIXED_STRING_SIZE];
+    char *pos = buf;
+    unsigned long u;
+    unsigned char n = 0;
+
+    if (value < 0) {
+	    *(pos++) = '-';
+	    u = -(unsigned long)value;
+    } else
+	    u = value;
+
+    do {                                        // Peel off digits, least significant first, until we have
+	    digits[n++] = '0' + (u % 10);       //  all the fraction and at least one whole digit.
+	    u /= 10;
+    } while ((u != 0) || (n <= decimals));
+
+    while (n) {
+	    if (n == decimals)
+		    *(pos++) = '.';
+	    *(pos++) = digits[--n];
+    }
+    *pos = '\0';
+    return buf;
+}
+
+// scaleFloat converts a float into a scaled integer with the given number of decimals.
+// The fraction is truncated (not rounded) the same way floatString always has.
+long scaleFloat(float v, unsigned char decimals) {
+    long mult = 1;
+    long whole;
+
+    while (decimals--) {
+	    mult *= 10;
+    }
+    whole = (long)v;
+    return (whole * mult) + (long)((v - whole) * mult);
+}
+
 // floatString converts a float to a string
 // We return one of a set of static buffers
 char *floatString(float v, unsigned char decimals) {
     const int OUTPUT_BUFS = 6;  // maximum number of floats in a single sprintf
-    const int MAX_OUTPUT = 13;  // largest possible output string
-    static char outputBuffers[OUTPUT_BUFS][MAX_OUTPUT+1];
-    int callCount;
+    static char outputBuffers[OUTPUT_BUFS][FIXED_STRING_SIZE+1];
+    static unsigned char callCount = 0;
 
-    char *pos = outputBuffers[++callCount % OUTPUT_BUFS];
+    if (++callCount >= OUTPUT_BUFS)             // Wrap explicitly, a free running counter would repeat a
+	    callCount = 0;                      //  buffer too soon when it rolls over.
+    char *pos = outputBuffers[callCount];
     char *opos = pos;
     if (v < 0) {
 	    *(opos++) = '-';
 	    v = -v;
     }
-    int mult = 1;
-    int multleft = decimals;
-    while(multleft--) {
-	    mult *= 10;
-    }
-    char format[9];
-    snprintf_P(format, 9, PSTR("%%d.%%0%dd"), decimals);
-    snprintf_P(opos, MAX_OUTPUT, format, (int)v, (int)((v - (int)v) * mult));
+    fixedString(opos, scaleFloat(v, decimals), decimals);
     return pos;
 }
+
+
+
+
+// stream_string sends a RAM string, stream_string_P a PROGMEM one.
+void stream_string(const char *s, tPutChar put) {
+    while (*s)
+	    put(*(s++));
+}
+
+void stream_string_P(const char *s, tPutChar put) {
+    char c;
+
+    while ((c = pgm_read_byte(s++)) != '\0')
+	    put(c);
+}
+
+// stream_fixed sends a scaled integer, formatted the same as fixedString()
+void stream_fixed(long value, unsigned char decimals, tPutChar put) {
+    char buf[FIXED_STRING_SIZE];
+
+    stream_string(fixedString(buf, value, decimals), put);
+}
+
+// stream_float sends a float, formatted the same as floatString()
+void stream_float(float v, unsigned char decimals, tPutChar put) {
+    if ((v < 0) && (decimals != 0)) {           // floatString keeps the '-' even when the truncated value is zero,
+	    put('-');                           //  but "%d" of an (int) cast never did.
+	    v = -v;
+    }
+    stream_fixed(scaleFloat(v, decimals), decimals, put);
+}
+
+// stream_fields walks a PROGMEM table of field descriptors, sending each one until SF_END.
+// If base is not NULL, the descriptor src values are offsets into the structure it points to.
+void stream_fields(const tStatusField *table, const void *base, tPutChar put) {
+    tStatusField f;
+    const char  *src;
+
+    for (;;) {
+	    memcpy_P(&f, table++, sizeof(f));   // Only one descriptor at a time is ever held in RAM.
+	    stream_string(f.lead, put);
+
+	    src = (const char *) f.src;
+	    if ((base != NULL) && (f.type != SF_CALC))
+		    src = (const char *) base + (size_t) f.src;
+
+	    switch (f.type) {
+		case SF_END:     return;
+		case SF_INT:     stream_fixed(*(const int *)     src, 0, put);                             break;
+		case SF_UINT8:   stream_fixed(*(const uint8_t *) src, 0, put);                             break;
+		case SF_FLOAT:   stream_float(*(const float *)   src, f.decimals, put);                    break;
+		case SF_MINUTES: stream_fixed((unsigned int)(*(const unsigned long *) src / 60000UL), 0, put); break;
+		case SF_STR:     stream_string(src, put);                                                  break;
+		case SF_CALC:    stream_fixed(((long (*)(void)) f.src)(), f.decimals, put);                break;
+		default:         break;                 // SF_TEXT, the lead was all there was to send.
+	    }
+    }
+}
+
+
+
+
+// token_reset readies the tokenizer for a new command string.
+void token_reset(tTokens *t) {
+    t->count = 0;
+    t->state = TS_BETWEEN;
+}
+
+// token_add takes in the character being placed at buffer offset pos, and returns the character that should be
+// stored there.  Commas are returned as NULL, so each text field is left NULL terminated in the buffer.
+char token_add(tTokens *t, uint8_t pos, char c) {
+    uint8_t i;
+
+    if (c == ',') {
+	    t->state = TS_BETWEEN;
+	    return('\0');
+    }
+
+    if (t->state == TS_BETWEEN) {               // 1st character of a new field.
+	    if (t->count >= MAX_TOKENS)
+		    return(c);                  // Too many fields, the rest are just ignored.
+	    i = t->count++;
+	    t->start[i]    = pos;
+	    t->value[i]    = 0;
+	    t->decimals[i] = 0;
+	    t->negative    = false;
+	    t->state       = TS_LEAD;
+    }
+
+    i = t->count - 1;
+
+    switch (t->state) {
+	case TS_LEAD:
+		if (isspace(c))
+			break;
+		t->state = TS_INT;
+		if ((c == '-') || (c == '+')) {
+			t->negative = (c == '-');
+			break;
+		}
+		// fall through - this is the 1st character of the number
+
+	case TS_INT:
+	case TS_FRAC:
+		if ((c >= '0') && (c <= '9')) {
+			if (labs(t->value[i]) <= (TOKEN_MAX_VALUE / 10)) {
+				t->value[i] = (t->value[i] * 10) + (t->negative ? -(c - '0') : (c - '0'));
+				if (t->state == TS_FRAC)
+					t->decimals[i]++;
+			} else if (t->state == TS_INT)
+				t->value[i] = t->negative ? -TOKEN_MAX_VALUE : TOKEN_MAX_VALUE;
+		} else if ((c == '.') && (t->state == TS_INT))
+			t->state = TS_FRAC;
+		else
+			t->state = TS_DONE;
+		break;
+
+	default:
+		break;
+    }
+
+    return(c);
+}
+
+// token_scaled fetches a field's number scaled to the requested decimals, extra digits are truncated same as atoi() would.
+bool token_scaled(const tTokens *t, uint8_t field, unsigned char decimals, long *dest) {
+    long v;
+    unsigned char d;
+
+    if (field >= t->count)
+	    return(false);
+
+    v = t->value[field];
+    for (d = t->decimals[field]; d > decimals; d--)
+	    v /= 10;
+    for (; d < decimals; d++)
+	    v *= 10;
+
+    *dest = v;
+    return(true);
+}
+
+// token_float fetches a field's number as a float, with a single divide in place of atof().
+bool token_float(const tTokens *t, uint8_t field, float *dest) {
+    long div = 1;
+    unsigned char d;
+
+    if (field >= t->count)
+	    return(false);
+
+    for (d = t->decimals[field]; d > 0; d--)
+	    div *= 10;
+
+    *dest = (float) t->value[field] / div;
+    return(true);
+}
+
+
+
+// bit_count returns how many bits are set in a byte.
+static uint8_t bit_count(uint8_t b) {
+    uint8_t n;
+
+    for (n = 0; b != 0; n++)
+        b &= b - 1;                                             // Drop the lowest set bit
+
+    return(n);
+}
+
+// addr_set_clear empties the set.
+void addr_set_clear(tAddrSet *s) {
+    memset(s->bits, 0, ADDR_SET_BYTES);
+    s->count = 0;
+}
+
+// addr_set_put adds (member = true) or removes an address, keeping the count current.
+void addr_set_put(tAddrSet *s, uint8_t addr, bool member) {
+    uint8_t flag = 0x01 << (addr & 0x07);
+    uint8_t *b   = &s->bits[addr >> 3];
+
+    if (member && !(*b & flag)) {
+        *b |= flag;
+        s->count++;
+    } else if (!member && (*b & flag)) {
+        *b &= ~flag;
+        s->count--;
+    }
+}
+
+// addr_set_has tells if an address is in the set.
+bool addr_set_has(const tAddrSet *s, uint8_t addr) {
+    return((s->bits[addr >> 3] & (0x01 << (addr & 0x07))) != 0);
+}
+
+// addr_set_expire removes the 8 addresses held in bits[index] whose bit is not also set in keep.
+// Returns how many were removed.
+uint8_t addr_set_expire(tAddrSet *s, uint8_t index, uint8_t keep) {
+    uint8_t gone = s->bits[index] & ~keep;
+    uint8_t n    = bit_count(gone);
+
+    s->bits[index] &= keep;
+    s->count       -= n;
+    return(n);
+}
+
+
+
+// pid_term works out one term of manage_ALT()'s PID engine:  P on the error, I accumulated into *iErr (held between 0 and iCap, so it
+// only ever pulls the PWM back), and D on the change in the measured value.  The gains come already scaled for the system voltage
+// (see scale_PID_gains()), so there are no divides here.  Returns the PWM change asked for, + = drive the field harder.
+float pid_term(float error, float dMeasured, float *iErr, float Kp, float Ki, float Kd, float iCap) {
+
+    *iErr += (error * Ki);
+    if (*iErr < 0)
+        *iErr = 0;
+    if (*iErr > iCap)
+        *iErr = iCap;
+
+    return((error * -Kp) - *iErr - (dMeasured * Kd));
+}
+
+
+
+// pid_track is the anti-windup for the I of one loop, after pid_term() and once the PWM change actually made (applied) is known.  A loop
+// over its target (error > 0) that asked for more then was applied did not have the final say, and one whose reading is already coming
+// down (dMeasured < 0) has been answered:  either way, rather then taking on this adjustment's error its I is held at iPrior (conditional
+// integration).  A loop under its target that asked for more then was applied has its I moved gain of the way towards the value that
+// would have had it ask for just that (back-calculation), so a loop closing in on its target already holds about the pull-back it will
+// need.  asked and applied are in PWM steps.  No I, or a gain of 0 (anti-windup turned off), nothing to do.
+void pid_track(float *iErr, float iPrior, float error, float dMeasured, float asked, float applied, float Ki, float gain, float iCap) {
+
+    if ((Ki == 0) || (gain == 0))
+        return;
+
+    if (error > 0) {
+        if ((asked > applied) || (dMeasured < 0))
+            *iErr = iPrior;
+        return;
+        }
+
+    if (asked <= applied)
+        return;
+
+    *iErr = iPrior + gain * ((asked + (*iErr - iPrior)) - applied);
+    if (*iErr < 0)
+        *iErr = 0;
+    if (*iErr > iCap)
+        *iErr = iCap;
+}
+
+
+
+// relay_tune_start sets up a relay test around center (Volts), with the field PWM to be driven to bias +/- step.  We start driving high.
+// Should the Volts swing further then limit either side of center, the step is cut back.  (See relay_tune_step())
+void relay_tune_start(tRelayTune *t, float center, float hyst, float limit, int bias, int step, unsigned long now) {
+
+    t->center    = center;
+    t->hyst      = hyst;
+    t->limit     = limit;
+    t->bias      = bias;
+    t->step      = step;
+    t->hiV       = center;
+    t->loV       = center;
+    t->ampSum    = 0;
+    t->periodSum = 0;
+    t->lastRise  = now;
+    t->cycles    = 0;
+    t->high      = true;
+}
+
+
+// relay_tune_step takes in the latest Volts reading and returns the field PWM to send out.  Each time the relay switches back to
+// high a full cycle has completed, and its peak-to-peak Volts and length are added in.  (The 1st cycle is discarded, as it starts
+// from wherever the system happened to be)  A cycle that went past limit either side of center has the step halved, and the counting
+// starts over - so a large alternator on a stiff battery is not left swinging the Volts up into the load-dump checks.
+int relay_tune_step(tRelayTune *t, float volts, unsigned long now) {
+
+    if (volts > t->hiV)    t->hiV = volts;
+    if (volts < t->loV)    t->loV = volts;
+
+    if (t->high) {
+        if (volts > (t->center + t->hyst))
+	    t->high = false;
+        }
+    else if (volts < (t->center - t->hyst)) {
+        t->high = true;
+        if (((t->hiV - t->center) > t->limit) || ((t->center - t->loV) > t->limit)) {
+            if (t->step > 1)
+                t->step /= 2;
+            t->cycles    = 0;
+            t->ampSum    = 0;
+            t->periodSum = 0;
+            }
+        else if (t->cycles++ > 0) {
+            t->ampSum    += t->hiV - t->loV;
+            t->periodSum += now - t->lastRise;
+            }
+        t->lastRise = now;
+        t->hiV      = volts;
+        t->loV      = volts;
+        }
+
+    return(t->high ? (t->bias + t->step) : (t->bias - t->step));
+}
+
+
+// relay_tune_gains returns false until RELAY_TUNE_CYCLES have been measured.  Then it works out the ultimate gain (Ku = 4d / pi a, a being
+// half the peak-to-peak Volts) and period (Tu), and from them Ziegler-Nichols PI gains with Kc derated:  Kc = 0.35 Ku, Ti = Tu / 1.2.
+// manage_ALT() moves the PWM by a change each sampleTime (mS), so its Kd acts as the proportional term and its Kp as the integral one:
+// Kd = Kc, Kp = Kc T / Ti.  (ZN's full Kc = 0.45 Ku pulls the Field back too far after a house load drop, the battery then sitting under
+// target while the PWM climbs back.  Tyreus-Luyben's Ti = 2.2 Tu was tried, but with the PWM moved in whole steps an error under 1/Kp
+// is never acted on, and its much smaller Kp left the battery sitting 50-100mV off target.  See tests/testAutoTune.cpp)
+bool relay_tune_gains(const tRelayTune *t, unsigned long sampleTime, float *Kp, float *Kd) {
+    float amp, Ku, Tu;
+
+    if ((t->cycles <= RELAY_TUNE_CYCLES) || (t->ampSum <= 0))
+	    return(false);
+
+    amp = t->ampSum / (2 * (t->cycles - 1));
+    Ku  = (4.0 * t->step) / (3.14159 * amp);
+    Tu  = (float) t->periodSum / (t->cycles - 1);
+
+    *Kd = 0.35 * Ku;
+    *Kp = *Kd * sampleTime / (Tu / 1.2);
+    return(true);
+}
+
+
+
+// slope_reset forgets any window underway, the next call to slope_flat() will start a new one.
+void slope_reset(tSlope *s) {
+
+    s->started = false;
+}
+
+
+// slope_flat is called as new values come in.  At the end of each window (mS) it returns true if the value has moved by no more than
+// limit per hour across both it and the window before, and starts the next window from there.
+bool slope_flat(tSlope *s, float value, unsigned long now, unsigned long window, float limit) {
+    float change;
+
+    if (!s->started) {
+        s->mark     = value;
+        s->markTime = now;
+        s->started  = true;
+        s->wasFlat  = false;
+        return(false);
+        }
+
+    if ((now - s->markTime) < window)
+	    return(false);
+
+    change = value - s->mark;
+    if (change < 0)
+	    change = -change;
+    change = change * 3600000.0 / (float) (now - s->markTime);        // Per hour
+
+    s->mark     = value;
+    s->markTime = now;
+    if (change > limit) {
+        s->wasFlat = false;
+        return(false);
+        }
+    if (!s->wasFlat) {
+        s->wasFlat = true;
+        return(false);
+        }
+    return(true);
+}
+
+
+
+
+// persist_filter is the fast-up / slow-down smoothing used for persistentBatAmps and persistentBatVolts.  *acc holds the smoothed value
+// scaled up by 2^shift (so no fraction is lost between calls), and a sample lower than the present value is blended in with a weight of
+// 1/2^shift using only shifts and adds.  A sample at or above the present value is taken right away.  Returns the new smoothed value.
+int32_t persist_filter(int32_t *acc, int32_t sample, uint8_t shift) {
+
+    if (sample >= (*acc >> shift))
+	    persist_set(acc, sample, shift);
+    else
+	    *acc += sample - (*acc >> shift);
+
+    return(*acc >> shift);
+}
+
+
+// persist_set jumps the smoothed value straight to sample.
+void persist_set(int32_t *acc, int32_t sample, uint8_t shift) {
+
+    *acc = sample * ((int32_t) 1 << shift);
+}
+
+
+// slew_allow is how far the Field may be raised after 'elapsed' mS, when it is to rise at no more then 'rise' units per 'period' mS.
+// What is left over (less then one unit) is carried in *acc to the next call, so a rate that does not divide evenly into the time
+// between adjustments still comes out right over the ramp.  A long gap is counted as one period - the allowance does not bank up.
+int slew_allow(unsigned long *acc, unsigned long elapsed, int rise, unsigned long period) {
+    int n;
+
+    if (elapsed > period)
+	    elapsed = period;
+    *acc += elapsed * (unsigned long) rise;
+    n     = *acc / period;
+    *acc -= (unsigned long) n * period;
+    return(n);
+}
+
+
+
+// limiter_of works out who held the Field back this adjustment.  asked[] are the PWM changes each loop (and the Ramp) asked for, and the
+// smallest wins (the 'littlest kid' manage_ALT() lets win, with ties going to the first one).  If even that would have raised the Field
+// but it is sitting at its cap (atLimit), the cap is what is holding it.  And if the winner asked for all of cap (the most it may rise in
+// one adjustment), nothing is holding it back.  derated has a (1 << tLimiters) bit set for each target (or the Field cap) that was
+// de-rated, and if the winner is one of those it is the de-rating that is holding the Field back.
+uint8_t limiter_of(const int *asked, uint8_t n, int cap, bool atLimit, uint8_t derated) {
+    uint8_t i, who = 0;
+
+    for (i = 1; i < n; i++)
+	    if (asked[i] < asked[who])
+		    who = i;
+
+    if (atLimit && (asked[who] > 0))
+	    who = LIM_FIELD_MAX;
+    else if (asked[who] >= cap)
+	    return(LIM_NONE);
+
+    if (derated & (1 << who))
+	    return(LIM_DERATE);
+    return(who);
+}
+
+
+// limiter_count adds elapsed mS to who's time in control, stopping at the top rather then wrapping back to 0.
+void limiter_count(unsigned long *times, uint8_t who, unsigned long elapsed) {
+
+    if (elapsed > 0xFFFFFFFFUL - times[who])                            // (As on the AVR, where unsigned long is 32 bits)
+	    times[who] = 0xFFFFFFFFUL;
+    else
+	    times[who] += elapsed;
+}
+
+
+
+static int ff_bin(int rpms) {
+
+    rpms /= FF_RPM_BIN_WIDTH;
+    return((rpms < FF_RPM_BINS) ? rpms : FF_RPM_BINS - 1);
+}
+
+
+// ff_learn takes in one steady reading of the Alternator:  amps coming out with the Field at pwm while the engine turns rpms.
+void ff_learn(tFFMap *m, int rpms, float amps, int pwm) {
+    float *k;
+
+    if ((rpms <= 0) || (pwm <= 0) || (amps <= 0))
+	    return;
+
+    k = &m->ampsPerStep[ff_bin(rpms)];
+    if (*k == 0)
+	    *k  = amps / pwm;                                   // 1st time in this range, take it as is
+    else
+	    *k += ((amps / pwm) - *k) / FF_LEARN_WEIGHT;
+}
+
+
+// ff_pwm returns the Field PWM the map expects to give amps at rpms, or -1 if nothing has been learned for that range yet.
+int ff_pwm(const tFFMap *m, int rpms, float amps) {
+    float k;
+
+    if (rpms <= 0)
+	    return(-1);
+    k = m->ampsPerStep[ff_bin(rpms)];
+    if (k <= 0)
+	    return(-1);
+
+    return((int) ((amps / k) + 0.5));
+}
@@ -18,4 +18,183 @@
 //              along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 //
+
+#ifndef _TYPES_H_
+#define _TYPES_H_
+
+#include <Arduino.h>
+#include <stddef.h>
+
+#define FIXED_STRING_SIZE   14                                  // Largest string fixedString() will produce, including sign, decimal point and NULL.
+
+
+
+                                //----- Status strings are streamed out one character at a time directly from a PROGMEM table of field descriptors,
+                                //      as opposed to being assembled in a large buffer via snprintf_P().  Each descriptor holds the separator text
+                                //      that comes ahead of the field, how to format the field, and where to find its value.
+
+typedef void (*tPutChar)(char c);                               // Where streamed characters are sent to (Serial, CAN terminal, a test buffer..)
+
+typedef enum {SF_END, SF_TEXT, SF_INT, SF_UINT8, SF_FLOAT, SF_MINUTES, SF_STR, SF_CALC} tFieldTypes;
+                                                                // SF_END     = End of table, the lead text is sent (normally "\r\n")
+                                                                // SF_TEXT    = Only the lead text is sent
+                                                                // SF_INT     = int,  SF_UINT8 = uint8_t or bool
+                                                                // SF_FLOAT   = float, sent with 'decimals' places (truncated, same as floatString)
+                                                                // SF_MINUTES = unsigned long holding mS, sent as whole minutes
+                                                                // SF_STR     = NULL terminated string in RAM
+                                                                // SF_CALC    = long (*)(void) function returning a value scaled by 'decimals'
+
+#define SF_LEAD_SIZE    5                                       // Longest separator is ",  ," - plus the NULL.
+
+typedef struct {
+    char            lead[SF_LEAD_SIZE];                         // Text sent ahead of the field
+    uint8_t         type;                                       // tFieldTypes
+    uint8_t         decimals;                                   // Fixed point places for SF_FLOAT and SF_CALC
+    const void     *src;                                        // Address of the variable (or offset into a passed structure), or the SF_CALC function
+    } tStatusField;
+
+#define SF_VAR(lead, type, dec, var)        {lead, type,    dec, (const void *) &(var)}
+#define SF_MEMBER(lead, type, dec, st, mbr) {lead, type,    dec, (const void *) offsetof(st, mbr)}
+#define SF_FUNC(lead, dec, fn)              {lead, SF_CALC, dec, (const void *) (fn)}
+#define SF_LIT(lead)                        {lead, SF_TEXT, 0,   NULL}
+#define SF_EOL                              {"\r\n", SF_END, 0, NULL}
+
+
+
+                                //----- Inbound command strings are split into comma separated fields as each character arrives.  Numbers are
+                                //      parsed right then into scaled integers (e.g. "14.25" is held as 1425 with 2 decimals), so the command
+                                //      handlers never need to re-scan the string, or use atof().   Fields are found the same way strtok() and
+                                //      atoi()/atof() would:  empty fields are skipped, leading spaces and a sign are allowed, and the number 
+                                //      ends at the first character that does not fit.
+
+#define MAX_TOKENS          12                                  // $SCA: has the most fields, 11.
+#define TOKEN_MAX_VALUE     99999999L                           // Stop adding digits past this, to stay clear of overflowing a long.
+
+#define TS_BETWEEN          0                                   // Between fields, waiting for something other then a ','
+#define TS_LEAD             1                                   // Start of a field, skipping spaces and looking for a sign
+#define TS_INT              2                                   // Taking in whole digits
+#define TS_FRAC             3                                   // Taking in digits after the decimal point
+#define TS_DONE             4                                   // Number is finished, anything else in the field is just text
+
+typedef struct {
+    uint8_t         count;                                      // How many fields have been found
+    uint8_t         state;                                      // Where we are in parsing the current field, TS_xxx
+    bool            negative;                                   // Current field has a '-' sign
+    uint8_t         start[MAX_TOKENS];                          // Offset into the buffer where each field starts
+    long            value[MAX_TOKENS];                          // Each field's number, scaled by 10^decimals
+    uint8_t         decimals[MAX_TOKENS];                       // Digits seen after the decimal point
+    } tTokens;
+
+
+                                //----- Sets of CAN source addresses (one bit each), which also keep a count of their members so asking
+                                //      'is there anyone in this set?' needs no scan.  Members can be expired a byte (8 addresses) at a time,
+                                //      so the work of ageing out stale entries can be spread over many passes.
+
+#define ADDR_SET_BYTES      32                                  // 256 addresses
+
+typedef struct {
+    uint8_t         bits[ADDR_SET_BYTES];                       // Bit = 1 --> address is in the set
+    uint16_t        count;                                      // How many bits are set
+    } tAddrSet;
+
+
+
+                                //----- Relay (oscillation) test used to auto-tune the Voltage PID.  The field is switched between two PWM values each time the
+                                //      battery voltage crosses the center point, and the amplitude and period of the oscillation that results tell us the
+                                //      ultimate gain and period of the loop.  (Astrom-Hagglund relay method)
+
+#define RELAY_TUNE_CYCLES    4                                  // Number of full oscillations to average over, after the 1st one has been discarded.
+
+typedef struct {
+    float           center;                                     // Relay switches when Volts pass center +/- hyst
+    float           hyst;
+    float           limit;                                      // A cycle swinging further then center +/- this has the step halved
+    float           hiV;                                        // Highest and lowest Volts seen during the current cycle
+    float           loV;
+    float           ampSum;                                     // Sum of the peak-to-peak Volts of each measured cycle
+    unsigned long   periodSum;                                  // Sum of the length (mS) of each measured cycle
+    unsigned long   lastRise;                                   // When the relay last switched to high
+    int             bias;                                       // Field PWM is driven to bias +/- step
+    int             step;
+    uint8_t         cycles;                                     // Cycles completed, including the discarded 1st one
+    bool            high;                                       // Relay is driving the field to bias + step?
+    } tRelayTune;
+
+
+
+                                //----- Learned Field feed-forward map:  How many Amps the Alternator gives for each Field PWM step, kept for ranges of engine RPMs.
+                                //      Alternator output is not really a straight line with the Field, but this is only used to get close - the PID does the rest.
+
+#define FF_RPM_BINS         12                                  // 250 RPM wide ranges, anything over the last one is counted in it.
+#define FF_RPM_BIN_WIDTH   250
+#define FF_LEARN_WEIGHT      8                                  // Each new reading moves the learned value 1/8th of the way.
+
+typedef struct {
+    float           ampsPerStep[FF_RPM_BINS];                   // 0 = Not seen yet
+    } tFFMap;
+
+
+
+                                //----- Which limit is holding back the Field:  one of the PID loops, the Ramp's slew limit, full Field, a de-rating of the
+                                //      target or Field cap that held it (calculate_ALT_targets():  Small Alt / Half power mode, idle RPM pull-back ..), or
+                                //      nothing - the Field is on its way up as fast as it is allowed to go.  The loops and the Ramp are in the order their
+                                //      PWM changes are passed to limiter_of().
+
+typedef enum {LIM_VOLTS, LIM_AMPS, LIM_WATTS, LIM_ALT_TEMP, LIM_RAMP, LIM_FIELD_MAX, LIM_DERATE, LIM_NONE, LIMITERS} tLimiters;
+
+
+
+                                //----- Watching for a slow moving value (e.g., Acceptance Amps) to level off.  The value is compared with where it was at the
+                                //      start of each window, so only two values need to be kept no matter how long the window is.  It has to stay level for two
+                                //      windows in a row, so one step change (say a load coming on just as the Amps fall off) can not make it look level.
+
+typedef struct {
+    float           mark;                                       // Value at the start of the present window
+    unsigned long   markTime;                                   // and when that was (mS)
+    bool            started;                                    // Has a window been started?
+    bool            wasFlat;                                    // Was the last window level?
+    } tSlope;
+
+
+extern int32_t persist_filter(int32_t *acc, int32_t sample, uint8_t shift);
+extern void    persist_set(int32_t *acc, int32_t sample, uint8_t shift);
+extern int     slew_allow(unsigned long *acc, unsigned long elapsed, int rise, unsigned long period);
+
+extern uint8_t limiter_of(const int *asked, uint8_t n, int cap, bool atLimit, uint8_t derated);
+extern void    limiter_count(unsigned long *times, uint8_t who, unsigned long elapsed);
+
+extern void  ff_learn(tFFMap *m, int rpms, float amps, int pwm);
+extern int   ff_pwm(const tFFMap *m, int rpms, float amps);
+
+extern float pid_term(float error, float dMeasured, float *iErr, float Kp, float Ki, float Kd, float iCap);
+extern void  pid_track(float *iErr, float iPrior, float error, float dMeasured, float asked, float applied, float Ki, float gain, float iCap);
+
+extern void  slope_reset(tSlope *s);
+extern bool  slope_flat(tSlope *s, float value, unsigned long now, unsigned long window, float limit);
+
+extern void  relay_tune_start(tRelayTune *t, float center, float hyst, float limit, int bias, int step, unsigned long now);
+extern int   relay_tune_step(tRelayTune *t, float volts, unsigned long now);
+extern bool  relay_tune_gains(const tRelayTune *t, unsigned long sampleTime, float *Kp, float *Kd);
+
+extern void  addr_set_clear(tAddrSet *s);
+extern void  addr_set_put(tAddrSet *s, uint8_t addr, bool member);
+extern bool  addr_set_has(const tAddrSet *s, uint8_t addr);
+extern uint8_t addr_set_expire(tAddrSet *s, uint8_t index, uint8_t keep);
+
+extern void  token_reset(tTokens *t);
+extern char  token_add(tTokens *t, uint8_t pos, char c);
+extern bool  token_scaled(const tTokens *t, uint8_t field, unsigned char decimals, long *dest);
+extern bool  token_float(const tTokens *t, uint8_t field, float *dest);
+
+
 extern char *floatString(float v, unsigned char decimals);
+extern char *fixedString(char *buf, long value, unsigned char decimals);
+extern long  scaleFloat(float v, unsigned char decimals);
+
+extern void  stream_string(const char *s, tPutChar put);
+extern void  stream_string_P(const char *s, tPutChar put);
+extern void  stream_fixed(long value, unsigned char decimals, tPutChar put);
+extern void  stream_float(float v, unsigned char decimals, tPutChar put);
+extern void  stream_fields(const tStatusField *table, const void *base, tPutChar put);
+
+#endif  // _TYPES_H_
@@ -355,7 +355,7 @@ bool tNMEA2000::SendFrames()
 bool tNMEA2000::SendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent) {
   
   if ( !SendFrames() || !CANSendFrame(id,len,buf,wait_sent) ) { // If we can not sent frame immediately, add it to buffer
-    tCANSendFrame *Frame=GetNextFreeCANSendFrame();
+    tCANSendFrame *Frame=GetNextFreeCANSendFrame((unsigned char)((id >> 26) & 0x7));
     if ( Frame==0 ) return false;
     Frame->id=id;
     Frame->len=len;
@@ -367,17 +367,27 @@ bool tNMEA2000::SendFrame(unsigned long id, unsigned char len, const unsigned ch
 }
 
 //*****************************************************************************
-tNMEA2000::tCANSendFrame *tNMEA2000::GetNextFreeCANSendFrame() { 
+// Returns free slot for frame with given priority (0=highest). Buffer is kept in
+// CAN arbitration order, frames with same priority stay in FIFO order. So e.g. fast
+// packet frames are never reordered, but an alert may pass a queued status message.
+tNMEA2000::tCANSendFrame *tNMEA2000::GetNextFreeCANSendFrame(unsigned char priority) { 
   if (CANSendFrameBuf==0) return 0;
 
   uint8_t temp = (CANSendFrameBufferWrite + 1) % MaxCANSendFrames;
+  uint8_t first = (CANSendFrameBufferRead + 1) % MaxCANSendFrames;
+  uint8_t prev;
   
-  if (temp != CANSendFrameBufferRead) {
-    CANSendFrameBufferWrite = temp;
-    return &(CANSendFrameBuf[CANSendFrameBufferWrite]);
-  } else {
-    return 0;
+  if (temp == CANSendFrameBufferRead) return 0;
+  CANSendFrameBufferWrite = temp;
+
+  while (temp != first) { // Move lower priority frames one step back
+    prev = (temp + MaxCANSendFrames - 1) % MaxCANSendFrames;
+    if ( ((CANSendFrameBuf[prev].id >> 26) & 0x7) <= priority ) break;
+    CANSendFrameBuf[temp] = CANSendFrameBuf[prev];
+    temp = prev;
   }
+  
+  return &(CANSendFrameBuf[temp]);
 }
 
 //*****************************************************************************
@@ -516,7 +526,7 @@ bool tNMEA2000::CheckKnownMessage(unsigned long PGN, bool &SystemMessage, bool &
 }
 
 //*****************************************************************************
-int tNMEA2000::SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsigned char *buf) {
+int tNMEA2000::SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsigned char *buf, unsigned long time) {
   unsigned char Priority;
   unsigned long PGN;
   unsigned long OldestMsgTime,CurTime;
@@ -541,6 +551,7 @@ int tNMEA2000::SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsigned
           N2kCANMsgBuf[i].FreeMessage();
         }
         N2kCANMsgBuf[i].LastFrame=buf[0];
+        N2kCANMsgBuf[i].N2kMsg.MsgTime=time; // Message time is arrival of its latest frame
         for (int j=1; j<len; j++, N2kCANMsgBuf[i].CopiedLen++) {
           N2kCANMsgBuf[i].N2kMsg.Data[N2kCANMsgBuf[i].CopiedLen]=buf[j];
         }
@@ -559,6 +570,7 @@ int tNMEA2000::SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsigned
         N2kCANMsgBuf[i].KnownMessage=KnownMessage;
         N2kCANMsgBuf[i].SystemMessage=SystemMessage;
         N2kCANMsgBuf[i].N2kMsg.Init(Priority,PGN,Source,Destination);
+        N2kCANMsgBuf[i].N2kMsg.MsgTime=time;
         N2kCANMsgBuf[i].CopiedLen=0;
         if (FastPacket) {
 //    Serial.print("First frame="); Serial.print(PGN);  Serial.print("\r\n");
@@ -864,6 +876,7 @@ void tNMEA2000::ParseMessages() {
     unsigned long canId;
     unsigned char len = 0;
     unsigned char buf[8];
+    unsigned long time;
     int MsgIndex;
     static const int MaxReadFramesOnParse=20;
     int FramesRead=0;
@@ -874,10 +887,10 @@ void tNMEA2000::ParseMessages() {
     SendFrames();
     SendPendingInformation();
     
-    while (FramesRead<MaxReadFramesOnParse && CANGetFrame(canId,len,buf) ) {           // check if data coming
+    while (FramesRead<MaxReadFramesOnParse && CANGetFrame(canId,len,buf,time) ) {      // check if data coming
         FramesRead++;
 //        ForwardStream->print("Can ID:"); ForwardStream->print(canId); ForwardStream->print(" len:"); ForwardStream->print(len); ForwardStream->print(" data:"); PrintBuf(ForwardStream,len,buf); ForwardStream->println("\r\n");
-        MsgIndex=SetN2kCANBufMsg(canId,len,buf);
+        MsgIndex=SetN2kCANBufMsg(canId,len,buf,time);
         if (MsgIndex>=0) {
           if ( !HandleReceivedSystemMessage(MsgIndex) ) {
 //            Serial.println(MsgIndex);
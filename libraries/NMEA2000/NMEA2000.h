@@ -229,18 +229,21 @@ protected:
     virtual bool CANSendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent=true)=0;
     virtual bool CANOpen()=0;
     virtual bool CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf)=0;
+    // Interfaces which capture the arrival time of a frame should override this one to return it (in millis() time).
+    // By default the frame is stamped when it is read.
+    virtual bool CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf, unsigned long &time) { time=millis(); return CANGetFrame(id,len,buf); }
 
 protected:
     bool SendFrames(); // Sends pending frames
     bool SendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent=true);
-    tCANSendFrame *GetNextFreeCANSendFrame();
+    tCANSendFrame *GetNextFreeCANSendFrame(unsigned char priority);
     // Currently Product Information and Configuration Information will we pended on ISO request.
     // This is because specially for broadcasted response it may take a while, when higher priority
     // devices sends their response.
     void SendPendingInformation();
     
 protected:
-    int SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsigned char *buf);
+    int SetN2kCANBufMsg(unsigned long canId, unsigned char len, unsigned char *buf, unsigned long time);
     bool CheckKnownMessage(unsigned long PGN, bool &SystemMessage, bool &FastPacket);
     bool HandleReceivedSystemMessage(int MsgIndex);
     void ForwardMessage(const tN2kMsg &N2kMsg);
@@ -269,6 +272,9 @@ public:
     // So e.g. Product information takes totally 134 bytes. This needs 20 frames. If you also send GNSS 47 bytes=7 frames.
     // If you want to be sure that both will be sent on any situation, you need at least 27 frame buffer size.
     void SetN2kCANSendFrameBufSize(const unsigned char _MaxCANSendFrames) { if (CANSendFrameBuf==0) { MaxCANSendFrames=_MaxCANSendFrames; }; }
+    // How many more frames the send buffer can take right now. A sender with a lot to say (e.g. a long Terminal reply) can pace itself
+    // by this, rather than fill the buffer and have other messages refused.
+    uint8_t GetCANSendFrameBufFree() const { return (MaxCANSendFrames-1) - (CANSendFrameBuf==0 ? 0 : (uint8_t)((CANSendFrameBufferWrite + MaxCANSendFrames - CANSendFrameBufferRead) % MaxCANSendFrames)); }
     
     // Define your product information. Defaults will be set on initialization.
     // For keeping defaults use 0xffff/0xff for int/char values and nul ptr for pointers.
@@ -41,6 +41,7 @@ based setup. See also NMEA2000 library.
 
 //*****************************************************************************
 tNMEA2000_avr::tNMEA2000_avr() : tNMEA2000() {
+  RxEmptyTime=0;
 }
 
 //*****************************************************************************
@@ -60,32 +61,55 @@ bool tNMEA2000_avr::CANSendFrame(unsigned long id, unsigned char len, const unsi
 //*****************************************************************************
 bool tNMEA2000_avr::CANOpen() {
     Can0.begin(CAN_BPS_250K);
-  //By default there are 6 mailboxes, 5x of which are used for Rx boxes
-  //This sets each mailbox to have an open filter that will accept extended
+  //There are 6 mailboxes (on the ATmegaxxM1), N2K_AVR_TX_MOBS of them are kept
+  //armed for Tx back-to-back, the rest are used for Rx boxes.
+  //This sets each Rx mailbox to have an open filter that will accept extended
   //or standard frames
   int filter;
+  int rxBoxes = CANMB_QUANTITY - Can0.setNumTXBoxes(N2K_AVR_TX_MOBS);
 
-  for (filter = 0; filter < 4; filter++) {
+  for (filter = 0; filter < rxBoxes - 1; filter++) {
   	Can0.setRXFilter(filter, 0, 0, true);		// Majority of them for extended messages	
   }  
 
-  Can0.setRXFilter(4, 0, 0, false);			// Use the last one for std messages
+  if (rxBoxes > 0) Can0.setRXFilter(rxBoxes - 1, 0, 0, false);	// Use the last one for std messages
+  RxEmptyTime=millis();
 
     return true;
 }
 
 //*****************************************************************************
 bool tNMEA2000_avr::CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf) {
+  unsigned long time;
+
+    return CANGetFrame(id, len, buf, time);
+}
+
+//*****************************************************************************
+// Same, but also returns when the frame arrived (in millis() time) - worked back
+// from the MOb capture timestamp, so time spent waiting in the Rx ring is not counted.
+// The capture timestamp is only 16 bits and comes round every CAN_TIMER_WRAP_MS, so a
+// frame left waiting longer than that would look newer than it is.  If the ring has not
+// been found empty for that long we cannot tell, and take the frame to be as old as it
+// could be:  arrived just after the ring was last empty.
+bool tNMEA2000_avr::CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf, unsigned long &time) {
   bool HasFrame=false;
   CAN_FRAME incoming;
+  unsigned long now=millis();
 
     if ( Can0.available() > 0 ) {           // check if data coming
         Can0.read(incoming); 
         id=incoming.id;
         len=incoming.length;
         for (int i=0; i<len && i<8; i++) buf[i]=incoming.data.bytes[i];
+        if (now - RxEmptyTime < CAN_TIMER_WRAP_MS)
+            time=now - CAN_TIMER_TICKS_TO_MS((uint16_t)(Can0.get_internal_timer_value() - incoming.time));
+        else
+            time=RxEmptyTime;
         HasFrame=true;
     }
+    else
+        RxEmptyTime=now;
     
     return HasFrame;
 }
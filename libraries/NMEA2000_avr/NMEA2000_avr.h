@@ -40,12 +40,20 @@ based setup. See also NMEA2000 library.
 #include <NMEA2000.h> 
 #include <N2kMsg.h>
 
+#ifndef N2K_AVR_TX_MOBS
+#define N2K_AVR_TX_MOBS 2       // How many of the CAN MObs to use for Tx, the rest are Rx.  More Tx boxes avoid bus idle gaps
+#endif                          // while the ISR reloads, but leave fewer Rx boxes to absorb bursts of incoming frames.
+
 class tNMEA2000_avr : public tNMEA2000
 {
+private:
+    unsigned long RxEmptyTime;  // When the Rx ring was last found empty - every frame in it now arrived since then.
+
 protected:
     bool CANSendFrame(unsigned long id, unsigned char len, const unsigned char *buf, bool wait_sent);
     bool CANOpen();
     bool CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf);
+    bool CANGetFrame(unsigned long &id, unsigned char &len, unsigned char *buf, unsigned long &time);
     
 public:
     tNMEA2000_avr();
@@ -375,7 +375,7 @@ void SetRVCPGN1FFC7(tN2kMsg &N2kMsg, tRVCChrgType ChrgType, uint8_t Instance, ui
 
 bool ParseRVCPGN1FFC7(const tN2kMsg &N2kMsg, tRVCChrgType &ChrgType, uint8_t &Instance, uint16_t &CVdc, uint16_t &CAdc, uint8_t &PerMax,
                             tRVCBatChrgMode &State, bool &EnableAtPO, bool &AutoRechg, tRVCChrgForceChrg &ForcedChrg){                           
-  if (N2kMsg.PGN!=0x1FEC7) return false;
+  if (N2kMsg.PGN!=0x1FFC7) return false;
 
   int     Index=0;
   uint8_t flag;
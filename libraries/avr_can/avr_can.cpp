@@ -32,6 +32,10 @@
 #include <avr/interrupt.h>
 #include <avr/pgmspace.h>
 
+#ifndef CAN_TX_STEP
+#define CAN_TX_STEP()                   //Host tests define this to let the ISR in between the steps of sendFrame()
+#endif
+
   
     
 
@@ -132,8 +136,11 @@ uint8_t CANRaw::init(uint8_t ub_baudrate)
      CANIE1 = 0x00;
      CANGIE = 0x00;                                                 // As well as master CAN controller interupts.
 
+	reset_buffer_stats();
+	CANTCON = CAN_TIMER_PRESCALE;                                  // Pace the CAN timer used for frame time stamps.
+
 	//By default use one mailbox for TX 
-	setNumTXBoxes(1);
+	setNumTXBoxes(CAN_TX_MOBS);
 
 	/* Enable the CAN controller. */
 	enable();
@@ -394,6 +401,85 @@ uint8_t CANRaw::get_rx_error_cnt()
 	return (uint8_t) (CANREC);                              //was --> (m_pCan->CAN_ECR >> CAN_ECR_REC_Pos);
 }
 
+/**
+ * \brief Get count of received frames dropped because the RX ring was full.
+ *
+ * \retval Number of dropped frames (saturates at 0xFFFF).
+ */
+uint16_t CANRaw::get_rx_overflow_cnt()
+{
+	uint8_t  oldSREG = SREG;
+	uint16_t cnt;
+
+	cli();                                                  // 16-bit value updated by the ISR, read it atomically.
+	cnt = rx_overflows;
+	SREG = oldSREG;
+	return cnt;
+}
+
+/**
+ * \brief Get count of frames sendFrame() refused because the TX ring was full.
+ *
+ * \retval Number of refused frames (saturates at 0xFFFF).
+ */
+uint16_t CANRaw::get_tx_overflow_cnt()
+{
+	return tx_overflows;                                    // Only ever changed by sendFrame(), no need to hold off the ISR.
+}
+
+/**
+ * \brief Get the most frames that have been waiting in the RX ring at one time.
+ *
+ * \retval High-water mark, compare to SIZE_RX_BUFFER-1.
+ */
+uint8_t CANRaw::get_rx_high_water()
+{
+	return rx_high_water;
+}
+
+/**
+ * \brief Get the most frames that have been waiting in the TX ring at one time.
+ *
+ * \retval High-water mark, compare to SIZE_TX_BUFFER-1.
+ */
+uint8_t CANRaw::get_tx_high_water()
+{
+	return tx_high_water;
+}
+
+/**
+ * \brief Get the longest time a received frame waited between capture and being serviced by the ISR.
+ *
+ * \retval Latency in CAN timer ticks:  init() sets CANTCON to CAN_TIMER_PRESCALE, a tick every 8*(CAN_TIMER_PRESCALE+1) CLKio
+ *         cycles (8uS at 16MHz).  CAN_TIMER_TICKS_TO_US() converts.  A wait longer than the timer's wrap (524mS) reads short.
+ */
+uint16_t CANRaw::get_isr_latency_max()
+{
+	uint8_t  oldSREG = SREG;
+	uint16_t lat;
+
+	cli();
+	lat = isr_latency_max;
+	SREG = oldSREG;
+	return lat;
+}
+
+/**
+ * \brief Clear the overflow, high-water and latency counters.
+ */
+void CANRaw::reset_buffer_stats()
+{
+	uint8_t oldSREG = SREG;
+
+	cli();
+	rx_overflows    = 0;
+	tx_overflows    = 0;
+	rx_high_water   = 0;
+	tx_high_water   = 0;
+	isr_latency_max = 0;
+	SREG = oldSREG;
+}
+
 
 /**
  * \brief Send single mailbox abort request.
@@ -457,6 +543,7 @@ void CANRaw::reset_all_mailbox()
 	for (uint8_t i = 0; i < CANMB_QUANTITY; i++) {		
 		mailbox_init(i);
 	}
+	tx_mobs_busy = false;                                   //Nothing armed now, so no TXOK interrupt to come
     
 }
 
@@ -506,44 +593,138 @@ template <typename t> void CANRaw::write(t inputValue)
  * or 2. queue the frame for sending later via interrupt. Automatically turns on TX interrupt
  * if necessary.
  * 
+ * The hardware picks between armed TX MObs by MOb number, not by ID, so a frame loaded into a free
+ * MOb while another is still armed could go out ahead of frames queued before it.  Every frame is
+ * queued, and the TX MObs are only loaded from the queue (in MOb order, see tx_mobs_refill()) once
+ * all of them have finished.  (So with several TX MObs (see setNumTXBoxes()) frames still go out
+ * back-to-back, a batch at a time)
+ *
  * Returns whether sending/queueing succeeded. Will not smash the queue if it gets full.
  */
 bool CANRaw::sendFrame(CAN_FRAME& txFrame) 
 {
-	for (int i = (CANMB_QUANTITY - numTXBoxes); i < CANMB_QUANTITY; i++) {          // Search the Tx MObs, looking for one that is not currently busy.
-       	   mailbox_set_MOb_index(i);                                                //    Select a Mob
-              if ( (i < 8)   && !(CANEN2 & (1<<i))        ||                        //    1st 8 read-bits in CANEN2.  bit=1 = in use.
-                  ((i >= 8)  && !(CANEN1 & (1<<(i-8)))))                            //    Next 8 in CANEN1
-			{                                                                       //is it available (not sending anything?)
-				mailbox_set_id(i, txFrame.id, txFrame.extended);
-                CANCDMOB = (txFrame.length & 0x0F);                                 // Set the data length
-                if (txFrame.extended) 
-                    CANCDMOB |= 1<<IDE;                                             // And if it is a standard or extended frame.
-				for (uint8_t cnt = 0; cnt < 8; cnt++)
-				{    
-					CANMSG = txFrame.data.bytes[cnt];                               // Push data out to MOb.  Datapointer will increment with each write to CANMSG reg
-				}  
-				enable_interrupt(i);                                                //enable the TX interrupt for this box
-                return(mailbox_tx_frame(i) == CAN_MAILBOX_TRANSFER_OK);             //we've sent it. send back if it worked..
-
+	uint8_t temp, prev, pri;
+	uint8_t oldSREG = SREG;
 
-			}
-    }
-	
-    //if execution got to this point then no free mailbox was found above
-    //so, queue the frame if possible. But, don't increment the 
+	//Queue the frame if possible. But, don't increment the 
 	//tail if it would smash into the head and kill the queue.
-	uint8_t temp;
-	temp = (tx_buffer_tail + 1) % SIZE_TX_BUFFER;
-	if (temp == tx_buffer_head) return false;
-    tx_frame_buff[tx_buffer_tail].id = txFrame.id;
-    tx_frame_buff[tx_buffer_tail].extended = txFrame.extended;
-    tx_frame_buff[tx_buffer_tail].length = txFrame.length;
-    tx_frame_buff[tx_buffer_tail].data.value = txFrame.data.value;
-    tx_buffer_tail = temp;
+	//The queue is kept in arbitration priority order (FIFO among equal priorities), so
+	//the TX MObs are always loaded with the most urgent frames waiting.
+	//
+	//Only sendFrame() moves the tail, so a frame going on the back of the queue needs no
+	//interrupt masking while it is copied in - fill the slot, then publish it by advancing
+	//the tail.  Only a frame that must pass others holds off the ISR while it does.
+	temp = (tx_buffer_tail + 1) & TX_BUFFER_MASK;
+	if (temp == tx_buffer_head) {
+		if (tx_overflows != 0xFFFF) tx_overflows++;
+		return false;
+	}
+
+	pri  = tx_priority(txFrame.id, txFrame.extended);
+	prev = (tx_buffer_tail - 1) & TX_BUFFER_MASK;
+	temp = tx_buffer_tail;
+
+	if ((tx_buffer_head != tx_buffer_tail) &&
+	    (tx_priority(tx_frame_buff[prev].id, tx_frame_buff[prev].extended) > pri)) {
+		cli();                                                                      // The ISR pulls from the head - hold it off while we shuffle.
+		while (temp != tx_buffer_head) {                                            // Move lower priority frames one step towards the tail
+			prev = (temp - 1) & TX_BUFFER_MASK;
+			if (tx_priority(tx_frame_buff[prev].id, tx_frame_buff[prev].extended) <= pri) break;
+			tx_frame_buff[temp].id         = tx_frame_buff[prev].id;
+			tx_frame_buff[temp].extended   = tx_frame_buff[prev].extended;
+			tx_frame_buff[temp].length     = tx_frame_buff[prev].length;
+			tx_frame_buff[temp].data.value = tx_frame_buff[prev].data.value;
+			temp = prev;
+		}
+	}
+
+	CAN_TX_STEP();
+    tx_frame_buff[temp].id = txFrame.id;
+    tx_frame_buff[temp].extended = txFrame.extended;
+    tx_frame_buff[temp].length = txFrame.length;
+    tx_frame_buff[temp].data.value = txFrame.data.value;
+	CAN_TX_STEP();
+    tx_buffer_tail = (tx_buffer_tail + 1) & TX_BUFFER_MASK;                         // Publish it
+	CAN_TX_STEP();
+
+	temp = (tx_buffer_tail - tx_buffer_head) & TX_BUFFER_MASK;
+	if (temp > tx_high_water) tx_high_water = temp;
+
+	if (!tx_mobs_busy) {                                                            // If the last TX MOb finished before the frame was published (or none
+		CAN_TX_STEP();                                                              //  was busy) the ISR had nothing to load, and will not come again - start
+		cli();                                                                      //  them here.  (tx_mobs_refill() changes CANPAGE, so the ISR is held off)
+		tx_mobs_refill();                                                           // While a MOb is busy its TXOK interrupt is still to come, and will find
+	}                                                                               //  the frame (it was published before tx_mobs_busy was looked at).
+	SREG = oldSREG;                                                                 // (Interrupts back on, if held off here or for the shuffle)
+	return true;
+}
+
+
+/**
+ * \brief Arbitration priority of a frame ID, lower is more urgent
+ *
+ * \param id The frame ID
+ * \param extended True if a 29-bit ID
+ *
+ * \retval The 3 priority bits of a 29-bit (J1939 / NMEA2000) ID, or the top 3 bits of an 11-bit ID.
+ */
+uint8_t CANRaw::tx_priority(uint32_t id, uint8_t extended)
+{
+	return (extended ? (id >> 26) : (id >> 8)) & 0x07;
+}
+
+
+/**
+ * \brief Are all the TX MObs free?  (Interrupts must be held off, CANPAGE is changed)
+ *
+ * \retval true if no TX MOb is armed, or holding a sent frame the ISR has not yet retired.
+ */
+bool CANRaw::tx_mobs_idle()
+{
+	for (uint8_t i = (CANMB_QUANTITY - numTXBoxes); i < CANMB_QUANTITY; i++) {
+		if (((i < 8)  && (CANEN2 & (1<<i))) ||                                      // Still sending,
+		    ((i >= 8) && (CANEN1 & (1<<(i-8)))))
+			return false;
+		mailbox_set_MOb_index(i);
+		if (CANSTMOB & (1<<TXOK))                                                   //  or sent but not yet retired by the ISR?
+			return false;
+	}
 	return true;
 }
 
+
+/**
+ * \brief If all the TX MObs are free, load them from the head of the queue in MOb order - the order the hardware
+ * will send them in.  (Interrupts must be held off, called from sendFrame() and the ISR)
+ */
+void CANRaw::tx_mobs_refill()
+{
+	if (!tx_mobs_idle())
+		return;
+	tx_mobs_busy = false;
+	for (uint8_t i = (CANMB_QUANTITY - numTXBoxes); (i < CANMB_QUANTITY) && (tx_buffer_head != tx_buffer_tail); i++) {
+		tx_mob_load(i, tx_frame_buff[tx_buffer_head]);
+		tx_buffer_head = (tx_buffer_head + 1) & TX_BUFFER_MASK;
+		tx_mobs_busy = true;                                                        // Its TXOK interrupt will call us again
+	}
+}
+
+
+/**
+ * \brief Load a frame into a free TX MOb and start it sending.  (Interrupts must be held off, CANPAGE is changed)
+ */
+void CANRaw::tx_mob_load(uint8_t mb, volatile CAN_FRAME &txFrame)
+{
+	mailbox_set_id(mb, txFrame.id, txFrame.extended);                               // (Selects the MOb as well)
+	CANCDMOB = (txFrame.length & 0x0F);                                             // Set the data length
+	if (txFrame.extended)
+		CANCDMOB |= 1<<IDE;                                                         // And if it is a standard or extended frame.
+	for (uint8_t cnt = 0; cnt < 8; cnt++)
+		CANMSG = txFrame.data.bytes[cnt];                                           // Push data out to MOb.  Datapointer will increment with each write to CANMSG reg
+	enable_interrupt(mb);                                                           // Enable the TX interrupt for this box
+	mailbox_tx_frame(mb);
+}
+
   
 
 /**
@@ -677,10 +858,7 @@ int CANRaw::available()
 	int val;
 	if (rx_avail()) 
 	{ 	
-        val = rx_buffer_head - rx_buffer_tail;
-		//Now, because this is a cyclic buffer it is possible that the ordering was reversed
-		//So, handle that case
-		if (val < 0) val += SIZE_RX_BUFFER;
+        val = (rx_buffer_head - rx_buffer_tail) & RX_BUFFER_MASK;     //Cyclic buffer, masking handles the head having wrapped
         return(val);
 	}
 	else return 0;
@@ -715,7 +893,8 @@ uint8_t CANRaw::get_rx_buff(CAN_FRAME& buffer) {
 	buffer.extended = rx_frame_buff[rx_buffer_tail].extended;
 	buffer.length = rx_frame_buff[rx_buffer_tail].length;
 	buffer.data.value = rx_frame_buff[rx_buffer_tail].data.value;
-	rx_buffer_tail = (rx_buffer_tail + 1) % SIZE_RX_BUFFER;
+	buffer.time = rx_frame_buff[rx_buffer_tail].time;
+	rx_buffer_tail = (rx_buffer_tail + 1) & RX_BUFFER_MASK;
 	return 1;
 }
 
@@ -909,6 +1088,7 @@ void CANRaw::mailbox_int_handler(uint8_t mb) {
     
 	CAN_FRAME tempFrame;
 	boolean caughtFrame = false;
+	uint16_t latency;
 	CANListener *thisListener;
 	if (mb > (CANMB_QUANTITY-1)) mb = (CANMB_QUANTITY-1);
 
@@ -917,6 +1097,8 @@ void CANRaw::mailbox_int_handler(uint8_t mb) {
                                 
     if (CANSTMOB & (1<<RXOK)) {                                              // Here bacuase of an Receive interupt?
            	mailbox_read(mb, &tempFrame);                                     // Yes, so go get it!
+            latency = get_internal_timer_value() - tempFrame.time;              // How long did it wait for us since capture?
+            if (latency > isr_latency_max) isr_latency_max = latency;
 
               // Reset this MOb to receive another message.
             mailbox_set_id(mb, RXIDFilterSave[mb],(CANCDMOB & (1<<IDE)));     // Restore the ID filter, with extended/standard flag.
@@ -960,35 +1142,23 @@ void CANRaw::mailbox_int_handler(uint8_t mb) {
 			}
 			if (!caughtFrame) //if none of the callback types caught this frame then queue it in the buffer
 			{
-				uint8_t temp = (rx_buffer_head + 1) % SIZE_RX_BUFFER;
+				uint8_t temp = (rx_buffer_head + 1) & RX_BUFFER_MASK;
 				if (temp != rx_buffer_tail) 
 				{  
                     memcpy((void *)&rx_frame_buff[rx_buffer_head], &tempFrame, sizeof(CAN_FRAME));
 					rx_buffer_head = temp;
+					temp = (rx_buffer_head - rx_buffer_tail) & RX_BUFFER_MASK;
+					if (temp > rx_high_water) rx_high_water = temp;
 				}
+				else if (rx_overflows != 0xFFFF) rx_overflows++;                  //No room, count the dropped frame.
                    
 			}
                          
     } else if (CANSTMOB & (1<<TXOK)) {                                                      // Something just transmitted.
                CANSTMOB &= ~(1<<TXOK);                                                       // Clear the Tx interupt flag
                CANCDMOB = 0;  								    //   ... and the controller reg.
-         	if (tx_buffer_head != tx_buffer_tail) 
-			{ //if there is a frame in the queue to send - refill this now empty MOb and start sending.
-				mailbox_set_id(mb, tx_frame_buff[tx_buffer_head].id, tx_frame_buff[tx_buffer_head].extended);
-                CANCDMOB = (tx_frame_buff[tx_buffer_head].length & 0x0F);
-                if (tx_frame_buff[tx_buffer_head].extended)
-                    CANCDMOB |= 1<<IDE;
-				for (uint8_t cnt = 0; cnt < 8; cnt++)
-				{    
-					CANMSG = tx_frame_buff[tx_buffer_head].data.bytes[cnt];
-				}       
-				enable_interrupt(mb);                                                        //enable the TX interrupt for this MOb
-				mailbox_tx_frame(mb);
-				tx_buffer_head = (tx_buffer_head + 1) % SIZE_TX_BUFFER;
-			}
-			else {
-				disable_interrupt(mb);                                                      // We are done with this MOb for now.
-			}
+               disable_interrupt(mb);                                                        // We are done with this MOb for now.
+               tx_mobs_refill();                                                             // Once every TX MOb has finished, load them from the queue.
     } else { 
                                                                                             // Some type of error in the MOb,
      //!       disable_interrupt(mb);                                                          // Due API does not report out errors, so just clear it here and free the MOb
@@ -41,6 +41,7 @@
 
 #include <Arduino.h>
 #include <avr/pgmspace.h>
+#include "avr_can_config.h"     //SIZE_RX_BUFFER, SIZE_TX_BUFFER, CAN_TIMER_PRESCALE and CAN_TX_MOBS, set there for library and sketch alike
 
 #define CAN		Can0
 
@@ -145,8 +146,16 @@
 #define CAN_MAILBOX_RX_NEED_RD_AGAIN  0x04  //! Application needs to re-read the data register in Receive with Overwrite mode.
 
 
-#define SIZE_RX_BUFFER	16 //RX incoming ring buffer is this big  (due had 32)
-#define SIZE_TX_BUFFER	8  //TX ring buffer is this big           (due had 16)
+#if (SIZE_RX_BUFFER & (SIZE_RX_BUFFER - 1)) || (SIZE_RX_BUFFER > 128) || \
+    (SIZE_TX_BUFFER & (SIZE_TX_BUFFER - 1)) || (SIZE_TX_BUFFER > 128)
+    #error SIZE_RX_BUFFER and SIZE_TX_BUFFER must be a power of two, 128 or less
+#endif
+#define RX_BUFFER_MASK	(SIZE_RX_BUFFER - 1)  //Ring indexes wrap by masking
+#define TX_BUFFER_MASK	(SIZE_TX_BUFFER - 1)
+
+#define CAN_TIMER_TICKS_TO_MS(t)	(((uint32_t)(t) * (8UL * (CAN_TIMER_PRESCALE + 1))) / (F_CPU / 1000UL))
+#define CAN_TIMER_WRAP_MS	CAN_TIMER_TICKS_TO_MS(0x10000UL)  //How long the CAN timer takes to come round again
+#define CAN_TIMER_TICKS_TO_US(t)	(((uint32_t)(t) * (8UL * (CAN_TIMER_PRESCALE + 1))) / (F_CPU / 1000000UL))
 #define SIZE_LISTENERS	4  //number of classes that can register as listeners with this class
 
 	/** Define the timemark mask. */
@@ -281,10 +290,19 @@ class CANRaw
 	volatile CAN_FRAME rx_frame_buff[SIZE_RX_BUFFER];
 	volatile CAN_FRAME tx_frame_buff[SIZE_TX_BUFFER];
 
-	volatile uint8_t rx_buffer_head, rx_buffer_tail;
-    volatile uint8_t tx_buffer_head, tx_buffer_tail;
+	volatile uint8_t rx_buffer_head, rx_buffer_tail;                   //rx head belongs to the ISR, rx tail to get_rx_buff() and tx tail to sendFrame().
+    volatile uint8_t tx_buffer_head, tx_buffer_tail;                   //tx head is moved by tx_mobs_refill(), ISR held off.  (8-bit, so reads are atomic)
+    volatile bool    tx_mobs_busy;                                     //A TX MOb is loaded, so its TXOK interrupt will come and refill them.  (Set / cleared by tx_mobs_refill())
+
+	volatile uint16_t rx_overflows, tx_overflows;                       //Frames dropped because the ring was full
+	volatile uint8_t  rx_high_water, tx_high_water;                     //Most frames ever waiting in each ring
+	volatile uint16_t isr_latency_max;                                  //Longest wait (CAN timer ticks) from frame capture to the ISR servicing it
     
 	void mailbox_int_handler(uint8_t mb);
+	static uint8_t tx_priority(uint32_t id, uint8_t extended);
+	bool tx_mobs_idle();
+	void tx_mobs_refill();
+	void tx_mob_load(uint8_t mb, volatile CAN_FRAME &txFrame);
 
 	uint8_t enablePin;
 	uint8_t busSpeed;                                                   //what speed is the bus currently initialized at? 0 if it is off right now
@@ -348,6 +366,12 @@ class CANRaw
     
  	uint8_t  get_tx_error_cnt();
 	uint8_t  get_rx_error_cnt(); 
+	uint16_t get_rx_overflow_cnt();
+	uint16_t get_tx_overflow_cnt();
+	uint8_t  get_rx_high_water();
+	uint8_t  get_tx_high_water();
+	uint16_t get_isr_latency_max();
+	void     reset_buffer_stats();
     uint16_t get_internal_timer_value();
     uint16_t get_timestamp_value();
     
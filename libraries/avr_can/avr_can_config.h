@@ -0,0 +1,20 @@
+/*
+  Build time settings for the avr_can library.
+
+  These size the CANRaw class and set up the hardware in avr_can.cpp, so the library and every sketch file including
+  avr_can.h must see the same values.  Change them here, and only here:  a #define placed ahead of #include <avr_can.h>
+  in a sketch is not seen when the library itself is compiled, and the two would then disagree on the class layout.
+*/
+
+#ifndef _AVR_CAN_CONFIG_
+#define _AVR_CAN_CONFIG_
+
+#define SIZE_RX_BUFFER	16 //RX incoming ring buffer is this big  (due had 32)
+#define SIZE_TX_BUFFER	8  //TX ring buffer is this big           (due had 16)
+
+#define CAN_TIMER_PRESCALE	15  //CANTCON: CAN timer (and so CAN_FRAME.time) ticks every 8*(CAN_TIMER_PRESCALE+1) CLKio cycles,
+                                //8uS @ 16MHz - wraps after 524mS.  Frames must be read before then for their time to be useful.
+
+#define CAN_TX_MOBS	1  //Number of MObs init() sets aside for TX, the rest are RX.  Change later with setNumTXBoxes()
+
+#endif
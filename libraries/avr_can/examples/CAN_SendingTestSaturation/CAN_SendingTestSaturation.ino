@@ -36,7 +36,21 @@ bool sendData()
     return(Can0.sendFrame(outgoing));
 }
 
+void reportStats()
+{
+    Serial.print("Tx ring high-water: ");   Serial.print(Can0.get_tx_high_water());
+    Serial.print("/");                      Serial.print(SIZE_TX_BUFFER - 1);
+    Serial.print("  Tx overflows: ");       Serial.print(Can0.get_tx_overflow_cnt());
+    Serial.print("  Rx ring high-water: "); Serial.print(Can0.get_rx_high_water());
+    Serial.print("/");                      Serial.print(SIZE_RX_BUFFER - 1);
+    Serial.print("  Rx overflows: ");       Serial.print(Can0.get_rx_overflow_cnt());
+    Serial.print("  Max ISR latency (uS): ");
+    Serial.println(CAN_TIMER_TICKS_TO_US(Can0.get_isr_latency_max()));
+}
+
 void loop(){
+  unsigned long lastReport = millis();
+
   while (true)  {                                       // Don't even go back into Arduino IDE, just fling them out as fast as one can
   
     if (!sendData()) {                                  // Transmission request    
@@ -46,6 +60,11 @@ void loop(){
         else
             Serial.println(" - Failed");
     }
+
+    if ((millis() - lastReport) >= 5000) {              // Every 5 seconds show how hard the buffers are being pushed,
+        reportStats();                                  // use this to size SIZE_TX_BUFFER / SIZE_RX_BUFFER (avr_can_config.h) against real traffic.
+        lastReport = millis();
+    }
   }                                             
 }
 
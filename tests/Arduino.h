@@ -1,3 +1,148 @@
+// Just enough of the Arduino (and AVR libc) API to build the regulator sources on a PC.  Every test is a single file that
+// #includes the sources it needs, so the mock state lives here as plain statics.  Time only moves when a test moves it.
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <cassert>
+#include "binary.h"
+
 #define PSTR(x) x
+#define F(x) x
+#define PROGMEM
+#define PGM_P const char *
 #define snprintf_P snprintf
+#define sprintf_P sprintf
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strcmp_P strcmp
+#define pgm_read_byte(p)  (*(const uint8_t *)(p))
+#define pgm_read_word(p)  (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_float(p) (*(const float *)(p))
+#define pgm_read_byte_near(p)  pgm_read_byte(p)
+#define pgm_read_word_near(p)  pgm_read_word(p)
+#define pgm_read_dword_near(p) pgm_read_dword(p)
+
+#define abs(x)             ((x) > 0 ? (x) : -(x))
+#define min(a,b)           ((a) < (b) ? (a) : (b))
+#define max(a,b)           ((a) > (b) ? (a) : (b))
+#define constrain(v,lo,hi) ((v) < (lo) ? (lo) : ((v) > (hi) ? (hi) : (v)))
+#define lowByte(w)         ((uint8_t) ((w) & 0xFF))
+#define highByte(w)        ((uint8_t) ((w) >> 8))
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0
+#define OUTPUT  1
+#define INPUT_PULLUP 2
+#define RISING  3
+#define A0  14
+#define A1  15
+#define A2  16
+#define A3  17
+#define A4  18
+#define A5  19
+#define A6  20
+#define A7  21
+#define A8  22
+#define A10 24
+
+#define _BV(b)             (1 << (b))
+#define bit_is_set(r,b)    0                            // ADC conversions finish at once
+
+
+// The few ATmega328 registers the sources touch directly.  ADCL/ADCH read back as a Vcc of 5.0v (see readVccMv())
+static uint8_t  ADMUX, ADCSRA, ADCL = 225, ADCH = 0, TCCR1A, TCCR1B;
+static uint16_t OCR1A;
+#define REFS0   6
+#define MUX3    3
+#define MUX2    2
+#define MUX1    1
+#define ADSC    6
+#define COM1A1  7
+
+
+static unsigned long hostMicros = 0;                    // The clock, moved along by the test (or by delay())
+static int           hostPinOut[32];                    // Last value written to each pin by digitalWrite() / analogWrite()
+static int           hostPinIn[32];                     // What digitalRead() / analogRead() return
+
+static inline unsigned long millis(void)                 { return hostMicros / 1000UL; }
+static inline unsigned long micros(void)                 { return hostMicros; }
+static inline void          host_advance(unsigned long ms) { hostMicros += ms * 1000UL; }
+static inline void          delay(unsigned long ms)      { host_advance(ms); }
+static inline void          delayMicroseconds(unsigned int us) { hostMicros += us; }
+static inline void          pinMode(uint8_t, uint8_t)    { }
+static inline void          digitalWrite(uint8_t p, uint8_t v) { hostPinOut[p & 31] = v; }
+static inline int           digitalRead(uint8_t p)       { return hostPinIn[p & 31]; }
+static inline void          analogWrite(uint8_t p, int v){ hostPinOut[p & 31] = v; }
+static inline int           analogRead(uint8_t p)        { return hostPinIn[p & 31]; }
+static inline void          attachInterrupt(uint8_t, void (*)(void), int) { }
+static inline void          interrupts(void)             { }
+static inline void          noInterrupts(void)           { }
+static inline long          random(long n)               { return n ? rand() % n : 0; }
+static inline void          randomSeed(unsigned long s)  { srand(s); }
+static inline long          map(long x, long inLo, long inHi, long outLo, long outHi) { return (x - inLo) * (outHi - outLo) / (inHi - inLo) + outLo; }
+
+
+// Serial port:  what is sent is kept (up to HOST_SERIAL_SIZE) for the test to look at, and input is taken from a string the test supplies.
+#define HOST_SERIAL_SIZE  16384
+#define DEC 10
+#define HEX 16
+
+class Stream {
+public:
+	char        out[HOST_SERIAL_SIZE + 1];
+	unsigned    outLen;
+	unsigned long outTotal;                         // Every character ever sent, even once out[] is full
+	const char *in;
+
+	void   begin(unsigned long)     { }
+	void   flush(void)              { }
+	int    available(void)          { return (in && *in) ? 1 : 0; }
+	int    read(void)               { return (in && *in) ? *(in++) : -1; }
+	size_t write(uint8_t c)         { outTotal++; if (outLen < HOST_SERIAL_SIZE) { out[outLen++] = c; out[outLen] = 0; } return 1; }
+	size_t write(const char *s)     { size_t n = 0; while (*s) n += write((uint8_t) *(s++)); return n; }
+	size_t write(const uint8_t *b, size_t n) { for (size_t i = 0; i < n; i++) write(b[i]); return n; }
+	size_t print(const char *s)     { return write(s); }
+	size_t print(char c)            { return write((uint8_t) c); }
+	size_t print(long v, int base = DEC)          { char b[24]; snprintf(b, sizeof(b), (base == HEX) ? "%lX" : "%ld", v); return write(b); }
+	size_t print(unsigned long v, int base = DEC) { char b[24]; snprintf(b, sizeof(b), (base == HEX) ? "%lX" : "%lu", v); return write(b); }
+	size_t print(int v, int base = DEC)           { return print((long) v, base); }
+	size_t print(unsigned v, int base = DEC)      { return print((unsigned long) v, base); }
+	size_t print(unsigned char v, int base = DEC) { return print((unsigned long) v, base); }
+	size_t print(double v, int d = 2) { char b[32]; snprintf(b, sizeof(b), "%.*f", d, v); return write(b); }
+	size_t println(void)            { return write("\r\n"); }
+	template <typename T> size_t println(T v)        { size_t n = print(v); return n + println(); }
+	template <typename T> size_t println(T v, int d) { size_t n = print(v, d); return n + println(); }
+	void   clear(void)              { outLen = 0; out[0] = 0; }
+	};
+
+static Stream Serial;
+
+
+#if defined(__AVR_ATmega64M1__)
+#include "HostCAN.h"
+#endif
+
+
+// EEPROM:  a 2K block of RAM, starting out erased.
+#define HOST_EEPROM_SIZE 2048
+static uint8_t hostEEPROM[HOST_EEPROM_SIZE] = { 0 };
+static bool    hostEEPROMErased = false;
+
+static inline void host_eeprom_erase(void) { memset(hostEEPROM, 0xFF, sizeof(hostEEPROM)); hostEEPROMErased = true; }
+static inline void eeprom_read_block(void *dst, const void *src, size_t n)  { if (!hostEEPROMErased) host_eeprom_erase(); memcpy(dst, hostEEPROM + (size_t) src, n); }
+static inline void eeprom_write_block(const void *src, void *dst, size_t n) { if (!hostEEPROMErased) host_eeprom_erase(); memcpy(hostEEPROM + (size_t) dst, src, n); }
+static inline void eeprom_update_block(const void *src, void *dst, size_t n){ eeprom_write_block(src, dst, n); }
+
+#endif
@@ -0,0 +1,318 @@
+// Host model of the ATmega64M1 CAN controller, enough to run avr_can.cpp (and so NMEA2000_avr and the regulator's CAN code) on a PC.
+// Pulled in by Arduino.h when __AVR_ATmega64M1__ is defined, as <avr/io.h> would be.
+//
+//  - 6 MObs, each with its CANCDMOB / CANSTMOB / ID tag / ID mask / 8 data bytes / time stamp, picked with CANPAGE (data index
+//    auto-increments on each CANMSG access).  Writing CANCDMOB with CONMOB != 0 arms a MOb, CONMOB == 0 disables it.  CANEN and CANSIT
+//    are worked out from the MObs as the hardware does.
+//  - host_can_bus() plays the bus:  the lowest numbered armed TX MOb goes first (as the hardware picks, whatever order they were
+//    armed in), the frame is kept in hostCANSent[], TXOK is set and the MOb drops out of CANEN.  host_can_receive() puts a frame into
+//    the lowest numbered armed RX MOb whose filter takes it, stamped with the CAN timer.
+//  - The CAN timer runs off micros(), 8*(CANTCON+1) CPU clocks a tick.
+//  - SREG's I bit is modelled:  a pending MOb interrupt (CANSIT & CANIE, with ENIT) runs ISR(CAN_INT_vect) as soon as interrupts are
+//    on - right away, or when cli() is undone by sei() or SREG = oldSREG.
+//  - Bus time:  with hostCANFrameMicros set each frame takes that long on the bus, and if TXOK finds no other TX MOb armed the bus then
+//    sits idle for hostCANReloadMicros (the ISR's response) before whatever the ISR arms can start.  Both 0 (time stands still) unless
+//    a test sets them;  the idle time is totted up in hostCANIdleMicros.
+//  - hostCANPreemptAt lets a test have the bus finish a frame (and the ISR then run, if it can) just before the n'th CAN register access
+//    from the main line code (or CAN_TX_STEP() point between the steps of avr_can's sendFrame(), defined below) - walked through every n
+//    that is how the ISR / producer interleavings get tested.  hostCANTouches / hostCANTouchesOff / hostCLIs count what main line code
+//    costs:  its register accesses, those made with interrupts held off, and how often it held them off.
+#ifndef _HOST_CAN_H_
+#define _HOST_CAN_H_
+
+#define F_CPU               16000000UL
+#define HOST_CAN_MOBS       6
+#define HOST_CAN_SENT_MAX   4096
+
+#define ISR(vector)         void vector(void)
+#define CAN_INT_vect        host_CAN_INT_vect
+#define CAN_TOVF_vect       host_CAN_TOVF_vect
+void host_CAN_INT_vect(void);
+
+                                                // Bit numbers, as in <avr/io.h>
+#define SWRES   0                               //  CANGCON
+#define ENASTB  1
+#define TEST    2
+#define LISTEN  3
+#define SYNTTC  4
+#define TTC     5
+#define OVRQ    6
+#define ABRQ    7
+#define OVRTIM  5                               //  CANGIT
+#define ENIT    7                               //  CANGIE
+#define CONMOB1 7                               //  CANCDMOB
+#define CONMOB0 6
+#define RPLV    5
+#define IDE     4
+#define DLCW    7                               //  CANSTMOB
+#define TXOK    6
+#define RXOK    5
+#define BERR    4
+#define SERR    3
+#define CERR    2
+#define FERR    1
+#define AERR    0
+#define RTRMSK  2                               //  CANIDM4
+#define IDEMSK  0
+#define AINC    3                               //  CANPAGE
+
+
+typedef struct {
+	uint8_t  cdmob, stmob;
+	uint8_t  idt[4], idm[4], msg[8];
+	uint16_t stm;
+	bool     enabled;
+	} tHostMOb;
+
+typedef struct {                                // A frame as it went by on the bus
+	uint32_t id;
+	bool     extended;
+	uint8_t  length;
+	uint8_t  data[8];
+	uint8_t  mob;                           // Which MOb sent it
+	unsigned long at;                       // micros()
+	} tHostCANFrame;
+
+static tHostMOb      hostMOb[HOST_CAN_MOBS];
+static uint8_t       hostCANPage;
+static uint8_t       hostCANRegs[16];           // The plain registers, see HOST_CAN_REG
+static tHostCANFrame hostCANSent[HOST_CAN_SENT_MAX];
+static unsigned      hostCANSentCnt;
+static unsigned      hostCANLost;               // Frames host_can_receive() found no armed RX MOb for
+static uint8_t       hostSREG = 0x80;
+static bool          hostInISR;
+static unsigned      hostISRRuns;
+static long          hostCANPreemptAt = -1;    // Count of main line register accesses to go before the bus finishes a frame (-1 = never)
+static unsigned long hostCANTouches;            // Main line register accesses,
+static unsigned long hostCANTouchesOff;         // .. those made with interrupts held off,
+static unsigned long hostCLIs;                  // .. and how many times main line code held them off
+static unsigned long hostCANFrameMicros;        // Bus time of one frame
+static unsigned long hostCANReloadMicros;       // Bus left idle after a TXOK with no other TX MOb armed
+static unsigned long hostCANIdleMicros;
+
+static void host_can_bus(int frames);
+
+
+static inline uint16_t host_can_timer(void) {
+	return((uint16_t) ((hostMicros * (F_CPU / 1000000UL)) / (8UL * (hostCANRegs[3] + 1))));             // hostCANRegs[3] is CANTCON
+}
+
+static inline uint8_t host_can_sit(void) {
+	uint8_t s = 0;
+	for (int i = 0; i < HOST_CAN_MOBS; i++)
+		if (hostMOb[i].stmob)
+			s |= 1 << i;
+	return(s);
+}
+
+static inline void host_can_service(void) {                                    // Run the ISR for as long as it has something to do, if it can.
+	for (int guard = 0; (guard < 16) && !hostInISR && (hostSREG & 0x80) && (hostCANRegs[2] & (1 << ENIT)) &&
+	                    (host_can_sit() & hostCANRegs[4]); guard++) {           // CANGIE, CANIE2
+		hostInISR = true;
+		hostSREG &= ~0x80;                                                   // As the AVR does on the way in ..
+		host_CAN_INT_vect();
+		hostSREG |= 0x80;                                                    // .. and reti() on the way out
+		hostISRRuns++;
+		hostInISR = false;
+		}
+}
+
+static inline void host_can_touch(void) {                                      // Every register access from the main line code comes here.
+	if (hostInISR)
+		return;
+	hostCANTouches++;
+	if (!(hostSREG & 0x80))
+		hostCANTouchesOff++;
+	if (hostCANPreemptAt < 0)
+		return;
+	if (hostCANPreemptAt-- == 0)
+		host_can_bus(1);
+}
+
+static inline void host_can_step(void) {                                       // A point between the steps of sendFrame(), see CAN_TX_STEP()
+	if (!hostInISR && (hostCANPreemptAt >= 0) && (hostCANPreemptAt-- == 0))
+		host_can_bus(1);
+}
+#define CAN_TX_STEP()   host_can_step()
+
+
+class tHostSREG {
+public:
+	operator uint8_t() const              { return(hostSREG); }
+	tHostSREG &operator=(uint8_t v)       { hostSREG = v; host_can_service(); return(*this); }
+	};
+static tHostSREG SREG;
+static inline void cli(void)  { if (!hostInISR && (hostSREG & 0x80)) hostCLIs++;  hostSREG &= ~0x80; }
+static inline void sei(void)  { hostSREG |=  0x80; host_can_service(); }
+
+
+class tHostCANReg {                                                             // A CAN register; read and write go through get() / set()
+public:
+	uint8_t (*get)(void);
+	void    (*set)(uint8_t);
+
+	operator uint8_t() const                { host_can_touch(); return(get()); }
+	tHostCANReg &operator=(uint8_t v)       { host_can_touch(); set(v); return(*this); }
+	tHostCANReg &operator=(const tHostCANReg &r) { return(*this = (uint8_t) r); }
+	tHostCANReg &operator|=(uint8_t v)      { host_can_touch(); set(get() | v); return(*this); }
+	tHostCANReg &operator&=(uint8_t v)      { host_can_touch(); set(get() & v); return(*this); }
+	};
+
+static inline tHostMOb &host_can_mob(void) { return(hostMOb[(hostCANPage >> 4) % HOST_CAN_MOBS]); }
+
+#define HOST_CAN_REG(name, n)   static tHostCANReg name = { [](void) -> uint8_t { return(hostCANRegs[n]); }, [](uint8_t v) { hostCANRegs[n] = v; } }
+#define HOST_MOB_REG(name, f)   static tHostCANReg name = { [](void) -> uint8_t { return(host_can_mob().f); }, [](uint8_t v) { host_can_mob().f = v; } }
+
+HOST_CAN_REG(CANGCON, 0);
+HOST_CAN_REG(CANGIT,  1);
+HOST_CAN_REG(CANGIE,  2);
+HOST_CAN_REG(CANTCON, 3);
+HOST_CAN_REG(CANIE2,  4);
+HOST_CAN_REG(CANIE1,  5);
+HOST_CAN_REG(CANBT1,  6);
+HOST_CAN_REG(CANBT2,  7);
+HOST_CAN_REG(CANBT3,  8);
+HOST_CAN_REG(CANTEC,  9);
+HOST_CAN_REG(CANREC, 10);
+HOST_MOB_REG(CANSTMOB, stmob);
+HOST_MOB_REG(CANIDT1,  idt[0]);
+HOST_MOB_REG(CANIDT2,  idt[1]);
+HOST_MOB_REG(CANIDT3,  idt[2]);
+HOST_MOB_REG(CANIDT4,  idt[3]);
+HOST_MOB_REG(CANIDM1,  idm[0]);
+HOST_MOB_REG(CANIDM2,  idm[1]);
+HOST_MOB_REG(CANIDM3,  idm[2]);
+HOST_MOB_REG(CANIDM4,  idm[3]);
+
+static tHostCANReg CANCDMOB = { [](void) -> uint8_t { return(host_can_mob().cdmob); },
+                                [](uint8_t v) { host_can_mob().cdmob = v;  host_can_mob().enabled = (v & ((1 << CONMOB1) | (1 << CONMOB0))) != 0; } };
+static tHostCANReg CANPAGE  = { [](void) -> uint8_t { return(hostCANPage); }, [](uint8_t v) { hostCANPage = v; } };
+static tHostCANReg CANMSG   = { [](void) -> uint8_t { uint8_t v = host_can_mob().msg[hostCANPage & 7];
+                                                    if (!(hostCANPage & (1 << AINC))) hostCANPage = (hostCANPage & 0xF8) | ((hostCANPage + 1) & 7);
+                                                    return(v); },
+                                [](uint8_t v) { host_can_mob().msg[hostCANPage & 7] = v;
+                                                if (!(hostCANPage & (1 << AINC))) hostCANPage = (hostCANPage & 0xF8) | ((hostCANPage + 1) & 7); } };
+static tHostCANReg CANEN2   = { [](void) -> uint8_t { uint8_t e = 0; for (int i = 0; i < HOST_CAN_MOBS; i++) e |= hostMOb[i].enabled << i; return(e); },
+                                [](uint8_t) { } };
+static tHostCANReg CANSIT2  = { [](void) -> uint8_t { return(host_can_sit()); }, [](uint8_t) { } };
+static tHostCANReg CANEN1   = { [](void) -> uint8_t { return(0); }, [](uint8_t) { } };
+static tHostCANReg CANSIT1  = { [](void) -> uint8_t { return(0); }, [](uint8_t) { } };
+static tHostCANReg CANSTML  = { [](void) -> uint8_t { return(lowByte(host_can_mob().stm)); },  [](uint8_t) { } };
+static tHostCANReg CANSTMH  = { [](void) -> uint8_t { return(highByte(host_can_mob().stm)); }, [](uint8_t) { } };
+static tHostCANReg CANTIML  = { [](void) -> uint8_t { return(lowByte(host_can_timer())); },  [](uint8_t) { } };
+static tHostCANReg CANTIMH  = { [](void) -> uint8_t { return(highByte(host_can_timer())); }, [](uint8_t) { } };
+static tHostCANReg CANTTCL  = CANTIML;
+static tHostCANReg CANTTCH  = CANTIMH;
+
+
+                                                // ID tag / mask registers <--> 11 or 29 bit IDs, as laid out by the hardware
+static inline void host_can_id_regs(uint32_t id, bool extended, uint8_t *r) {
+	if (extended) {
+		r[0] = id >> 21;   r[1] = id >> 13;   r[2] = id >> 5;   r[3] = (id << 3) & 0xF8;
+		}
+	else {
+		r[0] = id >> 3;    r[1] = (id << 5) & 0xE0;   r[2] = 0;   r[3] = 0;
+		}
+}
+
+static inline uint32_t host_can_regs_id(const uint8_t *r, bool extended) {
+	if (extended)
+		return(((uint32_t) r[0] << 21) | ((uint32_t) r[1] << 13) | ((uint32_t) r[2] << 5) | (r[3] >> 3));
+	return(((uint32_t) r[0] << 3) | (r[1] >> 5));
+}
+
+
+static inline bool host_can_tx_armed(void) {
+	for (int i = 0; i < HOST_CAN_MOBS; i++)
+		if (hostMOb[i].enabled && (((hostMOb[i].cdmob >> CONMOB0) & 3) == 1))
+			return(true);
+	return(false);
+}
+
+
+static inline uint8_t host_can_raise(tHostMOb *m, uint8_t flag) {              // Finish up a MOb:  flag it, stamp it, and drop it from CANEN
+	m->stmob  |= 1 << flag;
+	m->stm     = host_can_timer();
+	m->enabled = false;
+	return(0);
+}
+
+
+// Let the bus send up to 'frames' frames.  Each goes from the lowest numbered armed TX MOb, and the ISR gets a chance after each one.
+static void host_can_bus(int frames) {
+	while (frames-- > 0) {
+		int i;
+		for (i = 0; i < HOST_CAN_MOBS; i++)
+			if (hostMOb[i].enabled && (((hostMOb[i].cdmob >> CONMOB0) & 3) == 1))
+				break;
+		if (i == HOST_CAN_MOBS)
+			return;
+
+		tHostMOb &m = hostMOb[i];
+		if (hostCANSentCnt < HOST_CAN_SENT_MAX) {
+			tHostCANFrame &f = hostCANSent[hostCANSentCnt];
+			f.extended = (m.cdmob & (1 << IDE)) != 0;
+			f.id       = host_can_regs_id(m.idt, f.extended);
+			f.length   = m.cdmob & 0x0F;
+			f.mob      = i;
+			f.at       = hostMicros;
+			memcpy(f.data, m.msg, 8);
+			}
+		hostCANSentCnt++;
+		hostMicros += hostCANFrameMicros;
+		host_can_raise(&m, TXOK);
+		bool armed = host_can_tx_armed();
+		host_can_service();
+		if (!armed && host_can_tx_armed()) {                                 // The next frame waited on the ISR
+			hostMicros        += hostCANReloadMicros;
+			hostCANIdleMicros += hostCANReloadMicros;
+			}
+		}
+}
+
+
+// A frame arrives off the bus.  Returns the MOb that took it, or -1 if none could.
+static int host_can_receive(uint32_t id, bool extended, uint8_t length, const uint8_t *data) {
+	uint8_t r[4];
+
+	host_can_id_regs(id, extended, r);
+	for (int i = 0; i < HOST_CAN_MOBS; i++) {
+		tHostMOb &m = hostMOb[i];
+		if (!m.enabled || (((m.cdmob >> CONMOB0) & 3) != 2))
+			continue;
+		if ((m.idm[3] & (1 << IDEMSK)) && (((m.cdmob & (1 << IDE)) != 0) != extended))
+			continue;
+		bool match = true;
+		for (int b = 0; b < 4; b++)
+			match = match && !((r[b] ^ m.idt[b]) & m.idm[b] & ((b == 3) ? 0xF8 : 0xFF));
+		if (!match)
+			continue;
+
+		memcpy(m.idt, r, 4);
+		memcpy(m.msg, data, 8);
+		m.cdmob = (m.cdmob & 0xE0) | (extended ? (1 << IDE) : 0) | (length & 0x0F);
+		host_can_raise(&m, RXOK);
+		host_can_service();
+		return(i);
+		}
+	hostCANLost++;
+	return(-1);
+}
+
+
+static inline void host_can_reset(void) {
+	memset(hostMOb, 0, sizeof(hostMOb));
+	memset(hostCANRegs, 0, sizeof(hostCANRegs));
+	hostCANPage       = 0;
+	hostCANSentCnt    = 0;
+	hostCANLost       = 0;
+	hostSREG          = 0x80;
+	hostCANPreemptAt  = -1;
+	hostISRRuns       = 0;
+	hostCANIdleMicros = 0;
+	hostCANTouches    = 0;
+	hostCANTouchesOff = 0;
+	hostCLIs          = 0;
+}
+
+#endif
@@ -0,0 +1,24 @@
+// Host stand-in for the I2Cx library:  an INA226 whose registers the test fills in (hostINA226[reg]).  A non-zero hostI2CError makes
+// every read fail with that error code, as a stuck bus would.
+#ifndef _HOST_I2CX_H_
+#define _HOST_I2CX_H_
+
+static uint16_t hostINA226[8];
+static uint8_t  hostI2CError = 0;
+
+class tHostI2C {
+public:
+	uint16_t rxWord;
+	uint8_t  rxBytes;
+
+	void    begin(void)            { }
+	void    timeOut(uint16_t)      { }
+	void    pullup(uint8_t)        { }
+	uint8_t write(uint8_t, uint8_t reg, uint8_t *p, uint8_t) { if (reg < 8) hostINA226[reg] = (p[0] << 8) | p[1]; return(hostI2CError); }
+	uint8_t read(uint8_t, uint8_t reg, uint8_t)              { rxWord = hostINA226[reg & 7]; rxBytes = 2; return(hostI2CError); }
+	uint8_t receive(void)          { return((rxBytes-- == 2) ? highByte(rxWord) : lowByte(rxWord)); }
+	};
+
+static tHostI2C I2c;
+
+#endif
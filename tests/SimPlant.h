@@ -0,0 +1,191 @@
+// An alternator and battery for the real regulator (see SimRegulator.h) to drive.  The plant follows the Field the regulator actually puts
+// out (FIELD_PWM_OCR, or the analogWrite() to FIELD_PWM_PORT), and the INA226 model converts it back into register readings in whichever
+// mode sample_ALT_VoltAmps() configured:  triggered 16x averaging, or INA226_FAST_LOAD_DUMP's continuous single conversions.  Each reading
+// goes through read_ALT_VoltAmps() and resolve_BAT_VoltAmpTemp() into manage_ALT(), the same as loop() does it.
+//
+// Tests set the targets (targetBatVolts, targetAltAmps ...) and the mode, move the engine speed and house load, and call plant_tick().
+#ifndef _SIM_PLANT_H_
+#define _SIM_PLANT_H_
+
+#include "SimRegulator.h"
+
+#include <math.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define PLANT_TICK_US           100UL           // Plant time step
+#define INA226_AVERAGED_US    35200UL           // INA226_CONFIG:       16x (1.1mS Volts + 1.1mS Amps)
+#define INA226_FAST_US         2200UL           // INA226_CONFIG_FAST:  1 x (1.1mS Volts + 1.1mS Amps)
+
+
+typedef struct {
+	double ampsPerStep;                     // Alternator output per Field PWM step, at full engine speed
+	double maxAmps;
+	double fieldTau;                        // Field / stator response (S)
+	double r0, r1, tau1;                    // Battery:  series R, and an RC 'surface charge' branch
+	double ocv;                             // Open circuit volts to start with ..
+	double ocvRise;                         //  .. and how fast they come up (V per A.S)
+	double noiseV, noiseA;                  // Noise on each single INA226 conversion (standard deviation)
+	} tPlantSpec;
+
+typedef struct {
+	const tPlantSpec *spec;
+	double  speed;                          // Engine speed, as a fraction of the Amps per step at full speed  (moved by the test)
+	double  load;                           // House load, Amps  (moved by the test)
+	double  amps, vc, ocv, volts;           // Alternator Amps, surface charge volts, open circuit and terminal volts
+	double  convV, convA;                   // INA226 conversion under way
+	int     convN;
+	bool    converting;
+	unsigned long convStarted;
+	} tPlant;
+
+
+static double plant_noise(void) {                                       // Roughly normal, standard deviation 1
+	double n = -6;
+	for (int i = 0; i < 12; i++)
+		n += rand() / (double) RAND_MAX;
+	return(n);
+}
+
+
+// The Field the regulator is driving right now, in PWM steps.  (Including the load-dump 'shot' of FIELD_PWM_MIN, which does not
+// go through set_ALT_PWM())
+static double plant_field(void) {
+  #ifdef FIELD_PWM_OCR
+	return((double) FIELD_PWM_OCR / FIELD_PWM_STEPS);
+  #else
+	return((double) hostPinOut[FIELD_PWM_PORT & 31]);
+  #endif
+}
+
+
+static void plant_start(tPlant *p, const tPlantSpec *spec, double load) {
+	memset(p, 0, sizeof(*p));
+	p->spec  = spec;
+	p->speed = 1.0;
+	p->load  = load;
+	p->ocv   = spec->ocv;
+	p->volts = spec->ocv;
+	if (hostMicros < 1000000UL)                                             // (Up a while:  manage_ALT() spots a new mode by altModeChanged
+		hostMicros = 1000000UL;                                         //  moving, which it would not from millis() 0)
+	sample_ALT_VoltAmps();
+}
+
+
+// Start with the battery held at 'volts' carrying 'load', and the Field where it needs to be to do it.
+static void plant_balance(tPlant *p, const tPlantSpec *spec, double volts, double load) {
+	plant_start(p, spec, load);
+	double bat = (volts - spec->ocv) / (spec->r0 + spec->r1);
+	p->amps    = load + bat;
+	p->vc      = bat * spec->r1;
+	p->volts   = volts;
+
+	long fine = lround(p->amps / (spec->ampsPerStep * p->speed) * FIELD_PWM_STEPS);
+	set_ALT_PWM(fine / FIELD_PWM_STEPS, fine % FIELD_PWM_STEPS);
+}
+
+
+// INA226 readings into the registers, and on through the regulator as loop() would.
+static void plant_convert(tPlant *p, bool fast) {
+	double noiseScale = fast ? 1.0 : 0.25;                                          // (16 samples averaged)
+	double v = p->convV / p->convN + p->spec->noiseV * noiseScale * plant_noise();
+	double a = p->convA / p->convN + p->spec->noiseA * noiseScale * plant_noise();
+
+	hostINA226[VOLTAGE_REG] = (int16_t) lround(v / (0.00125 * VALT_SCALER * ADCCal.VBatGainError));
+	hostINA226[SHUNT_V_REG] = (int16_t) (lround(a / (0.0000025 * AALT_SCALER * (float) systemConfig.AMP_SHUNT_RATIO)) + ADCCal.AmpOffset);
+	hostINA226[STATUS_REG]  = 0x0008;                                               // Conversion ready
+	read_ALT_VoltAmps();
+	hostINA226[STATUS_REG]  = 0;
+
+	resolve_BAT_VoltAmpTemp();
+	manage_ALT();
+	if (!updatingVAs)                                                               // Start the next reading straight away, as the stator IRQ would
+		sample_ALT_VoltAmps();
+}
+
+
+static void plant_tick(tPlant *p) {
+	const tPlantSpec *s  = p->spec;
+	double            dt = PLANT_TICK_US / 1000000.0;
+
+	hostMicros += PLANT_TICK_US;
+
+	double target = fmin(plant_field() * s->ampsPerStep * p->speed, s->maxAmps);
+	p->amps  += (target - p->amps) * dt / s->fieldTau;
+	double bat = p->amps - p->load;
+	p->vc    += (bat * s->r1 - p->vc) * dt / s->tau1;
+	p->ocv   += bat * s->ocvRise * dt;
+	p->volts  = p->ocv + bat * s->r0 + p->vc;
+
+	bool fast = (hostINA226[CONFIG_REG] == INA226_CONFIG_FAST);                     // (Continuous, else only once triggered by sample_ALT_VoltAmps())
+	if (!p->converting) {
+		if (!fast && !updatingVAs)
+			return;
+		p->converting  = true;
+		p->convStarted = hostMicros - PLANT_TICK_US;
+		p->convV = p->convA = 0;
+		p->convN = 0;
+		}
+	p->convV += p->volts;
+	p->convA += p->amps;
+	p->convN++;
+	if ((hostMicros - p->convStarted) < (fast ? INA226_FAST_US : INA226_AVERAGED_US))
+		return;
+
+	p->converting = false;
+	plant_convert(p, fast);
+}
+
+
+// Runs fn(arg) in a child process and hands back its result, so each run starts from the regulator as it is now.  (manage_ALT() keeps
+// its PID, load-dump and feed-forward working values in function statics, which nothing outside it can reset)
+template <typename R, typename A> static R sim_fresh(R (*fn)(A), A arg) {
+	int   fd[2], status;
+	R     r;
+
+	assert(pipe(fd) == 0);
+	fflush(stdout);
+	pid_t pid = fork();
+	assert(pid >= 0);
+	if (pid == 0) {
+		close(fd[0]);
+		r = fn(arg);
+		fflush(stdout);
+		_exit(write(fd[1], &r, sizeof(r)) == sizeof(r) ? 0 : 1);
+		}
+	close(fd[1]);
+	ssize_t got = read(fd[0], &r, sizeof(r));
+	close(fd[0]);
+	assert(waitpid(pid, &status, 0) == pid);
+	assert(WIFEXITED(status) && (WEXITSTATUS(status) == 0));               // (A failed assert in the run shows up here)
+	assert(got == sizeof(r));
+	return(r);
+}
+
+
+// For comparing build options:  the README also builds the test without the option, as <test><suffix>.  Run that way (argv[1] of
+// "--result") a test hands its result back with sim_result() instead, and sim_other_build() runs the other build to get it.
+#define SIM_RESULT_ARG          "--result"
+
+template <typename R> static bool sim_result(int argc, char *argv[], const R &r) {
+	if ((argc < 2) || (strcmp(argv[1], SIM_RESULT_ARG) != 0))
+		return(false);
+	assert(fwrite(&r, sizeof(r), 1, stdout) == 1);
+	return(true);
+}
+
+template <typename R> static R sim_other_build(const char *argv0, const char *suffix) {
+	char  cmd[256];
+	R     r;
+
+	snprintf(cmd, sizeof(cmd), "%s%s " SIM_RESULT_ARG, argv0, suffix);
+	fflush(stdout);
+	FILE *f = popen(cmd, "r");
+	assert(f != NULL);
+	size_t got = fread(&r, sizeof(r), 1, f);
+	assert(pclose(f) == 0);                                                 // (Not built?  See the README)
+	assert(got == 1);
+	return(r);
+}
+
+#endif
@@ -0,0 +1,50 @@
+// The regulator built as one host program:  the real Types, CPE, Flash, Sensors, Alternator and AltReg_Serial sources, with the few
+// globals SmartRegulator.ino owns supplied here.  Tests set the measured* globals (or the INA226 registers in I2Cx.h) and call
+// manage_ALT(), send_outbound(), check_inbound() ... directly, moving time along with host_advance().
+//
+// By default it is the standalone (ATmega328) regulator.  With SIM_SYSTEMCAN defined first it is the CAN (ATmega64M1) one instead,
+// adding AltReg_CAN and the NMEA2000 / RV-C / avr_can libraries, running on the CAN controller model in HostCAN.h.
+//
+//      c++ -O2 -Wno-narrowing -I. testX.cpp -o testX         (CPE.c has float constants in unsigned long tables, fine in C)
+//      c++ -O2 -Wno-narrowing -I. -I../libraries/avr_can -I../libraries/NMEA2000 -I../libraries/RV_C -I../libraries/NMEA2000_avr testX.cpp -o testX
+#ifndef _SIM_REGULATOR_H_
+#define _SIM_REGULATOR_H_
+
+#ifdef SIM_SYSTEMCAN
+  #define __AVR_ATmega64M1__
+  #include "Arduino.h"
+  #include "SoftI2CMaster.h"
+  #include "../libraries/avr_can/avr_can.cpp"
+  #include "../libraries/NMEA2000/N2kMsg.cpp"
+  #include "../libraries/NMEA2000/NMEA2000.cpp"
+  #include "../libraries/NMEA2000/N2kMessages.cpp"
+  #include "../libraries/RV_C/RVCMessages.cpp"
+  #include "../libraries/NMEA2000_avr/NMEA2000_avr.cpp"
+#else
+  #define __AVR_ATmega328P__
+  #include "Arduino.h"
+  #include "I2Cx.h"
+#endif
+
+#include "../SmartRegulator/Types.cpp"
+#include "../SmartRegulator/CPE.c"
+#include "../SmartRegulator/Flash.cpp"
+#include "../SmartRegulator/Sensors.cpp"
+#include "../SmartRegulator/Alternator.cpp"
+#include "../SmartRegulator/AltReg_Serial.cpp"
+#ifdef SIM_SYSTEMCAN
+  #include "../SmartRegulator/AltReg_CAN.cpp"
+#endif
+
+unsigned   faultCode;
+int8_t     LEDRepeat;
+int8_t     SDMCounter      = SDM_SENSITIVITY;
+bool       sendDebugString = false;
+char const firmwareVersion[] = REG_FIRMWARE_VERSION;
+uint8_t    hostDipSwitch   = 0;
+int        hostReboots     = 0;
+
+uint8_t readDipSwitch()  { return(hostDipSwitch); }
+void    reboot()         { hostReboots++; }
+
+#endif
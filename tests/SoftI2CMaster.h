@@ -0,0 +1,22 @@
+// Host stand-in for SoftI2CMaster (the CAN regulator's bit-banged I2C):  the same INA226 as I2Cx.h, one register pointer, two bytes
+// a read.  A non-zero hostI2CError makes every i2c_start() fail.
+#ifndef _HOST_SOFTI2CMASTER_H_
+#define _HOST_SOFTI2CMASTER_H_
+
+#define I2C_READ   1
+#define I2C_WRITE  0
+
+static uint16_t hostINA226[8];
+static uint8_t  hostI2CError = 0;
+static uint8_t  hostI2CReg, hostI2CBytes;
+static uint16_t hostI2CWord;
+
+static inline bool    i2c_init(void)            { return(true); }
+static inline bool    i2c_start(uint8_t)        { hostI2CBytes = 0; return(hostI2CError == 0); }
+static inline bool    i2c_rep_start(uint8_t)    { hostI2CBytes = 2; return(hostI2CError == 0); }
+static inline void    i2c_stop(void)            { if (hostI2CBytes == 3) hostINA226[hostI2CReg & 7] = hostI2CWord; }
+static inline bool    i2c_write(uint8_t v)      { if (hostI2CBytes == 0) hostI2CReg = v; else hostI2CWord = (hostI2CWord << 8) | v;
+                                                  hostI2CBytes = (hostI2CBytes + 1) & 3;  return(true); }
+static inline uint8_t i2c_read(bool last)       { uint16_t w = hostINA226[hostI2CReg & 7]; return(last ? lowByte(w) : highByte(w)); }
+
+#endif
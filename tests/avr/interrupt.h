@@ -0,0 +1 @@
+// Host stand-in for <avr/interrupt.h>:  ISR(), cli() and sei() come with the CAN controller model in HostCAN.h
@@ -0,0 +1 @@
+// Host stand-in for <avr/pgmspace.h>:  PROGMEM is plain memory on a PC, see Arduino.h
@@ -0,0 +1,9 @@
+// Host stand-in for <avr/wdt.h>:  the watchdog never bites on a PC.
+#define WDTO_15MS  0
+#define WDTO_1S    6
+#define WDTO_2S    7
+#define WDTO_4S    8
+#define WDTO_8S    9
+#define wdt_reset()
+#define wdt_enable(t)
+#define wdt_disable()
@@ -0,0 +1,186 @@
+// Acceptance phase of a flooded lead-acid bank, with the shunt on the alternator so the house load is part of what is measured.
+// The Amps never get down to EXIT_ACPT_AMPS, so without EXIT_ACPT_DIDT the phase runs until EXIT_ACPT_DURATION.  With it, the
+// phase should end once the battery has stopped taking on charge - a lot sooner, and without leaving charge behind.  The readings are
+// handed straight to the real manage_ALT() (see SimRegulator.h), with the voltage loop taken as holding the target once it is reached.
+#include "SimPlant.h"                           // (Just for sim_fresh(), no alternator plant here)
+
+#define ACPT_EXIT_AMPS           5.0            // Default HD FLA profile
+#define ACPT_EXIT_DURATION (4.5 * 3600000UL)
+#define ACPT_EXIT_DIDT           2.0            // A/hour
+#define STEP_MS   (PWM_CHANGE_RATE + 5)         // A new reading every 105mS, just past PWM_CHANGE_RATE, so each makes an adjustment
+
+#define ACPT_VOLTS              14.6
+#define MAX_ALT_AMPS           100.0
+
+                                                // Battery:  2 well (available / bound charge) model, 500Ah
+#define CAPACITY               500.0
+#define C_AVAIL                 0.50            // Fraction of the capacity in the 'available' well
+#define K_DIFF                  2.00            // Rate charge moves into the bound well (per hour)
+#define OCV_EMPTY              12.00
+#define OCV_SPAN                2.60            // OCV rises this much as the available well fills
+#define R_BAT                  0.003
+#define GAS_AMPS               0.004            // Gassing near full, per Ah of capacity
+
+#define HOUSE_LOAD               6.0
+
+
+typedef struct {
+	double q1, q2;                          // Ah in the available and bound wells
+	} tBattery;
+
+
+// Charge Amps the battery takes at 'volts', and how much of it is lost to gassing.
+static double bat_amps(const tBattery *b, double volts, double *gas) {
+	double h1 = b->q1 / (C_AVAIL * CAPACITY);
+	double h2 = b->q2 / ((1 - C_AVAIL) * CAPACITY);
+	*gas = GAS_AMPS * CAPACITY * pow(h2, 8);
+	double amps = (volts - (OCV_EMPTY + OCV_SPAN * h1)) / R_BAT;
+	return((amps > 0 ? amps : 0) + *gas);
+}
+
+
+static void via_serial(const char *cmd) {
+	static char line[100];
+
+	snprintf(line, sizeof(line), "$%s\r\n", cmd);
+	Serial.clear();
+	Serial.in = line;
+	for (int i = 0; i < 100; i++) {
+		host_advance(10);
+		check_inbound();
+		}
+	Serial.in = NULL;
+}
+
+
+static void bat_step(tBattery *b, double amps, double gas, double seconds) {
+	double h1 = b->q1 / (C_AVAIL * CAPACITY);
+	double h2 = b->q2 / ((1 - C_AVAIL) * CAPACITY);
+	double flow = K_DIFF * (h1 - h2) * CAPACITY;
+	b->q1 += (amps - gas - flow) * seconds / 3600;
+	b->q2 += flow * seconds / 3600;
+}
+
+
+typedef struct {
+	double bulkHours;
+	double acptHours;
+	double stored;                          // Ah in the battery at the end of Acceptance
+	} tResult;
+
+
+typedef struct {
+	double startSOC;
+	bool   useDIDT;
+	} tRun;
+
+
+// Bulk at full alternator output until ACPT_VOLTS is reached, then hold it until manage_ALT() moves on to Float.  Measured Amps have
+// a little noise, and a 4A load comes on for good an hour into Acceptance.
+static tResult charge(tRun g) {
+	tBattery b = { g.startSOC * C_AVAIL * CAPACITY, g.startSOC * (1 - C_AVAIL) * CAPACITY };
+	tResult  r = { 0, 0, 0 };
+	unsigned long ms = 0, acptStarted = 0;
+	bool     inAcpt = false;
+	double   gas;
+
+	srand(45);
+	targetBatVolts = ACPT_VOLTS;
+	targetAltAmps  = 500;
+	targetAltWatts = 15000;
+	workingParms.EXIT_ACPT_AMPS     = ACPT_EXIT_AMPS;
+	workingParms.EXIT_ACPT_DURATION = ACPT_EXIT_DURATION;
+	workingParms.EXIT_ACPT_DIDT     = g.useDIDT ? ACPT_EXIT_DIDT : 0;
+	workingParms.LIMIT_OC_AMPS      = 0;
+	hostMicros = 1000000UL;
+	set_ALT_mode(bulk_charge);
+
+	for (; alternatorState != float_charge; ms += STEP_MS) {
+		double amps  = bat_amps(&b, ACPT_VOLTS, &gas);
+		double load  = HOUSE_LOAD + ((inAcpt && (ms - acptStarted) > 3600000UL) ? 4.0 : 0.0);
+		double volts = ACPT_VOLTS;
+		if (amps + load > MAX_ALT_AMPS) {                               // Alternator flat out, under the target voltage
+			amps  = MAX_ALT_AMPS - load;
+			volts = ACPT_VOLTS - (bat_amps(&b, ACPT_VOLTS, &gas) - amps) * R_BAT;
+			}
+		bat_step(&b, amps, gas, STEP_MS / 1000.0);
+
+		measuredBatVolts  = measuredAltVolts = volts;                   // (Shunt on the alternator)
+		measuredBatAmps   = measuredAltAmps  = amps + load + ((rand() % 101) - 50) / 100.0;
+		measuredAltWatts  = measuredAltVolts * measuredAltAmps;
+		shuntAmpsMeasured = true;
+		updatingVAs       = false;
+		hostMicros       += STEP_MS * 1000UL;
+		manage_ALT();
+
+		if (!inAcpt && (alternatorState == acceptance_charge)) {
+			inAcpt      = true;
+			acptStarted = ms;
+			r.bulkHours = ms / 3600000.0;
+			}
+		assert(ms < 12 * 3600000UL);
+		}
+
+	r.acptHours = (ms - acptStarted) / 3600000.0;
+	r.stored    = b.q1 + b.q2;
+	return(r);
+}
+
+
+int main() {
+	tSlope s;
+
+	// Nothing until a full window has passed, then the change across it scaled to per-hour - and it has to be level for two windows
+	// in a row.
+	slope_reset(&s);
+	assert(!slope_flat(&s, 20.0f, 1000, 600000UL, 1.0f));
+	assert(!slope_flat(&s, 20.0f, 500000, 600000UL, 1.0f));
+	assert(!slope_flat(&s, 19.0f, 601000, 600000UL, 1.0f));       // 1A in 10 min = 6 A/hour
+	assert(!slope_flat(&s, 18.9f, 700000, 600000UL, 1.0f));       // (New window started at 601000)
+	assert(!slope_flat(&s, 18.8f, 1201000, 600000UL, 1.0f));      // 0.2A in 10 min = 1.2 A/hour
+	assert(!slope_flat(&s, 18.7f, 1801000, 600000UL, 1.0f));      // 0.1A in 10 min = 0.6 A/hour, the first level window ..
+	assert( slope_flat(&s, 18.8f, 2401000, 600000UL, 1.0f));      //  .. and the second (rising slowly counts as level too)
+	assert(!slope_flat(&s, 20.0f, 3001000, 600000UL, 1.0f));      // A step up (load coming on) starts the count over
+	assert(!slope_flat(&s, 20.0f, 3601000, 600000UL, 1.0f));
+	assert( slope_flat(&s, 20.0f, 4201000, 600000UL, 1.0f));
+	slope_reset(&s);
+	assert(!slope_flat(&s, 20.0f, 4202000, 600000UL, 1.0f));      // Reset starts over
+	assert(!slope_flat(&s, 20.0f, 4802000, 600000UL, 1.0f));
+	assert( slope_flat(&s, 20.0f, 5402000, 600000UL, 1.0f));
+
+
+	// EXIT_ACPT_DIDT is saved apart from the rest of the profile, in the CPX block after the PIDS, so the CPS slots (and everything
+	// after them) are where they were before it was added.  A profile saved before then still reads back, with the default dI/dt.
+	CPS  cp;
+	systemConfig.BT_CONFIG_CHANGED = true;                          // (Else nothing is saved, see write_CPS_EEPROM())
+	via_serial("CPA:7,14.6,120,4,2.5");
+	assert(strstr(Serial.out, "AOK") != NULL);
+	assert(read_CPS_EEPROM(6, &cp));
+	assert((cp.ACPT_BAT_V_SETPOINT == 14.6f) && (cp.EXIT_ACPT_AMPS == 4) && (cp.EXIT_ACPT_DIDT == 2.5f));
+	assert(SCS_FLASH_LOCAITON == sizeof(EKEY) + sizeof(CAL) + 32 + offsetof(CPS, EXIT_ACPT_DIDT) * MAX_CPES);
+
+	memset(hostEEPROM + CPX_FLASH_LOCAITON, 0xFF, sizeof(CPX));                     // (As left by a build from before CPX)
+	assert(read_CPS_EEPROM(6, &cp));
+	assert((cp.ACPT_BAT_V_SETPOINT == 14.6f) && (cp.EXIT_ACPT_DIDT == defaultCPS[6].EXIT_ACPT_DIDT));
+
+
+	// From a few starting states of charge, dI/dt should cut Acceptance well short of the 4.5 hour limit while leaving the battery
+	// holding as much charge as the full-length run did, bar what the last ~1A it was still taking would have put in.  (That tails
+	// off over most of an hour, so exiting any sooner than EXIT_ACPT_DURATION leaves a little behind)
+	static const double socs[] = { 0.50, 0.70, 0.85 };
+	for (int i = 0; i < (int) (sizeof(socs) / sizeof(socs[0])); i++) {
+		tResult base = sim_fresh(charge, (tRun) { socs[i], false });
+		tResult didt = sim_fresh(charge, (tRun) { socs[i], true  });
+
+		printf("SOC %2.0f%%   bulk %4.2f h   acceptance %4.2f / %4.2f h   stored %6.1f / %6.1f Ah (of %3.0f)\n",
+		       socs[i] * 100, base.bulkHours, base.acptHours, didt.acptHours, base.stored, didt.stored, CAPACITY);
+
+		assert(base.acptHours >= ACPT_EXIT_DURATION / 3600000.0);            // House load keeps the Amps over EXIT_ACPT_AMPS
+		assert(didt.acptHours <  base.acptHours * 0.8);
+		assert(didt.acptHours >  2 * ACPT_DIDT_WINDOW / 3600000.0);
+		assert(base.stored - didt.stored < 1.0);
+		assert(didt.stored > CAPACITY * 0.998);
+		}
+
+	return 0;
+}
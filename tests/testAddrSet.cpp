@@ -0,0 +1,167 @@
+// The charger priority sets, run for real (see SimRegulator.h):  chargers put their Charger Status2 and Status frames on the bus, and
+// check_CAN() parses them into RVCChrgStat2_handler() / RVCChrgStat_handler() and ages the sets with age_BIT_arrays().  Against a brute
+// force reference of who said what and when, the sets must hold everyone heard from within 1/2 of REMOTE_CAN_CHARGER_TIMEOUT and
+// nobody not heard from for a full timeout, and CAN_HPUUCS / EPCS / LPCS_lastReceived must only move for chargers still in them.
+#define SIM_SYSTEMCAN
+#include "SimRegulator.h"
+
+#define SETS        3                           // Higher, Equal, Lower priority chargers
+#define PERIOD      (REMOTE_CAN_CHARGER_TIMEOUT / 2)    // Aging period
+#define STEP        (PERIOD / SBSZ)             //  and how often age_BIT_arrays() moves on a byte
+#define CHARGERS    40
+
+static tAddrSet     *sets[SETS] = { &chargerSBHP, &chargerSBEP, &chargerSBLP };
+
+static bool          ref[SETS][256];            // Brute force reference: membership as last set by a Charger Status2 ..
+static long          lastHeard[256];            //  .. and when that was (-1 = never)
+static long          updates[SETS];             // How many times each _lastReceived was seen to move
+
+
+static void to_bus(tN2kMsg &msg, uint8_t source) {
+	uint32_t id = ((uint32_t) msg.Priority << 26) | (msg.PGN << 8) | source;
+	assert(msg.DataLen <= 8);
+	assert(host_can_receive(id, true, msg.DataLen, msg.Data) >= 0);
+	check_CAN();
+	host_advance(1);                                // Next frame a mS on, so a _lastReceived that moves can be seen to.
+}
+
+// A Charger Status2 from addr, noting in the reference what RVCChrgStat2_handler() should make of it.
+static void status2(long now, uint8_t addr, bool sameBat, uint8_t devPri) {
+	tN2kMsg msg;
+	uint8_t ourPri = canConfig.DEVICE_PRIORITY;
+	bool    m[SETS] = { sameBat && (devPri > ourPri), sameBat && (devPri == ourPri), sameBat && (devPri <= ourPri) };
+
+	for (int s = 0; s < SETS; s++)
+		ref[s][addr] = m[s];
+	if (sameBat)
+		lastHeard[addr] = now;
+
+	SetRVCChargerStatus2(msg, RVCDCct_Engine, 1, sameBat ? batteryInstance : batteryInstance + 1, devPri, 13500 / 50, 0x7D00, 40 + 40);
+	to_bus(msg, addr);
+}
+
+// Is addr in set s?  Sure to be if heard from within 1/2 of the timeout, sure not to be if not heard from for a full one, else as the set has it.
+static bool member(int s, uint8_t addr, long now) {
+	if (!ref[s][addr] || (lastHeard[addr] < 0) || (now - lastHeard[addr] > (long)(2 * PERIOD + STEP)))
+		return(false);
+	if (now - lastHeard[addr] < (long)(PERIOD - STEP))
+		return(true);
+	return(addr_set_has(sets[s], addr));
+}
+
+// A Charger Status from addr, and which of the _lastReceived times RVCChrgStat_handler() should have moved for it.
+static void status1(long now, uint8_t addr, uint8_t perMax) {
+	tN2kMsg       msg;
+	unsigned long before[SETS] = { CAN_HPUUCS_lastReceived, CAN_EPCS_lastReceived, CAN_LPCS_lastReceived };
+	bool          moves[SETS]  = { member(0, addr, now) && (perMax < 80), member(1, addr, now), member(2, addr, now) && (perMax > 20) };
+
+	SetRVCChargerStatus(msg, RVCDCct_Engine, 1, 13500 / 50, 0x7D00 + 2000, perMax, RVCDCbcm_Bulk, true, false, RVCDCfc_Cancel);
+	to_bus(msg, addr);
+
+	unsigned long after[SETS] = { CAN_HPUUCS_lastReceived, CAN_EPCS_lastReceived, CAN_LPCS_lastReceived };
+	for (int s = 0; s < SETS; s++) {
+		assert((after[s] != before[s]) == moves[s]);
+		if (moves[s]) {
+			assert((long)(millis() - after[s]) <= 2);       // and to when the frame came in
+			updates[s]++;
+			}
+		}
+}
+
+// Check the sets against the reference.  Anyone heard within 1/2 of the timeout must still be there, and nobody
+// not heard for a full timeout may be.  Counts and the 'anyone there?' summary must match a full scan.
+static void check(long now) {
+	for (int s = 0; s < SETS; s++) {
+		int n = 0;
+
+		for (int a = 0; a < 256; a++) {
+			bool has = addr_set_has(sets[s], a);
+
+			if (has) {
+				n++;
+				assert(ref[s][a]);
+				assert(now - lastHeard[a] <= (long)(2 * PERIOD + STEP));
+			} else if (ref[s][a])
+				assert(now - lastHeard[a] >= (long)(PERIOD - STEP));
+		}
+		assert(n == sets[s]->count);
+		assert((n != 0) == (sets[s]->count != 0));
+	}
+}
+
+
+int main(int argc, char *argv[]) {
+	initialize_CAN();
+	for (int i = 0; i < 300; i++) {                 // Address claim
+		host_advance(10);
+		check_CAN();
+		host_can_bus(50);
+		}
+	uint8_t us = NMEA2000.GetN2kSource();
+
+	srand(1);
+
+	for (int run = 0; run < 100; run++) {
+		int     chargers = 1 + rand() % CHARGERS;
+		uint8_t addr[CHARGERS], pri[CHARGERS];
+		bool    same[CHARGERS];
+		long    every[CHARGERS], next[CHARGERS];
+
+		canConfig.DEVICE_PRIORITY = 60 + rand() % 20;
+		reset_BIT_arrarys();
+		memset(ref, 0, sizeof(ref));
+		for (int a = 0; a < 256; a++)
+			lastHeard[a] = -1;
+		unsigned long start = millis();
+
+		for (int c = 0; c < chargers; c++) {
+			do {                                    // Each charger has its own CAN address, not ours
+				addr[c] = rand() % 252;
+			} while ((addr[c] == us) || (memchr(addr, addr[c], c) != NULL));
+			pri[c]   = canConfig.DEVICE_PRIORITY - 2 + rand() % 5;
+			same[c]  = (rand() % 4) != 0;
+			every[c] = 1000 + rand() % 5000;
+			next[c]  = rand() % every[c];
+		}
+
+		for (long now = 0; now < 120000; now += STEP) {
+			host_advance(start + now - millis());
+			check_CAN();                            // Ages the next byte of the sets
+			host_can_bus(50);
+			check(now);
+
+			for (int c = 0; c < chargers; c++) {
+				if ((now >= 60000) && (c & 1))
+					continue;                       // Half the chargers go quiet part way through
+				if (now >= next[c]) {
+					if ((rand() % 50) == 0)
+						pri[c] = canConfig.DEVICE_PRIORITY - 2 + rand() % 5;   // Odd one changes its priority,
+					if ((rand() % 50) == 0)
+						same[c] = !same[c];                                    //  or moves to another battery
+					status2(millis() - start, addr[c], same[c], pri[c]);
+					status1(millis() - start, addr[c], rand() % 101);
+					next[c] += every[c];
+				}
+			}
+		}
+
+		for (int s = 0; s < SETS; s++)          // By now the quiet ones have all aged out,
+			for (int c = 1; c < chargers; c += 2)
+				if (lastHeard[addr[c]] < 60000)
+					assert(!addr_set_has(sets[s], addr[c]));
+
+		for (int c = 1; c < chargers; c += 2)   //  and what they say no longer counts.
+			status1(millis() - start, addr[c], (rand() & 1) ? 10 : 90);
+	}
+	assert(updates[0] && updates[1] && updates[2]);
+
+	canConfig.ENABLE_OSE = false;               // RV-C turned off:  Status2 frames are not taken in at all.
+	reset_BIT_arrarys();
+	tN2kMsg msg;
+	SetRVCChargerStatus2(msg, RVCDCct_Engine, 1, batteryInstance, canConfig.DEVICE_PRIORITY, 13500 / 50, 0x7D00, 80);
+	to_bus(msg, 0x40);
+	assert((chargerSBHP.count == 0) && (chargerSBEP.count == 0) && (chargerSBLP.count == 0));
+
+	printf("_lastReceived moved:  HPUUCS %ld, EPCS %ld, LPCS %ld times\n", updates[0], updates[1], updates[2]);
+	printf("All tests passed.\n");
+}
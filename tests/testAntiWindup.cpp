@@ -0,0 +1,151 @@
+// The real manage_ALT() (see SimPlant.h) through the Bulk --> Acceptance hand-over:  Amps limited Bulk until the battery comes up to the
+// target voltage, and then the Volts loop takes over.  A loop over its target has its 'I' held if it did not get the PWM change it asked
+// for or its reading is already coming down, and one under its target that did not get what it asked for is tracked back to the applied
+// change (see pid_track()).  Done both for a plain hand-over, and one where the engine speeds up just as the target voltage is reached
+// (so both loops are over their targets at once), each with a run of noise seeds - and compared with the same runs with the anti-windup
+// turned off, which the README also builds as testAntiWindupUntracked (-DUNTRACKED, PID_TRACKING_GAIN 0).
+#ifdef UNTRACKED
+#define PID_TRACKING_GAIN   0
+#endif
+#include "SimPlant.h"
+
+#define TARGET_VOLTS        14.4
+#define WATCH_FOR          60000L               // mS after the hand-over to look at
+#define SEEDS              16                   // Noise seeds each case is run with
+
+typedef struct {
+	const char *name;
+	tPlantSpec  spec;                       // (Bulk squeezed down into a few minutes by the quick rise of the open circuit volts)
+	float       targetAmps;
+	} tCase;
+
+static const tCase cases[] = {
+	{ "120A on 400Ah",  { 0.5, 120.0, 0.15, 0.004, 0.004, 4.0, 13.8, 0.00004, 0.01, 1.0 },  80.0 },
+	{ "120A, noisy",    { 0.5, 120.0, 0.15, 0.004, 0.004, 4.0, 13.8, 0.00004, 0.03, 3.0 },  80.0 },
+	{ "250A on 600Ah",  { 1.0, 250.0, 0.25, 0.002, 0.003, 5.0, 13.9, 0.00002, 0.02, 3.0 }, 150.0 },
+	{ "60A on 100Ah",   { 0.3,  60.0, 0.08, 0.008, 0.010, 2.0, 13.7, 0.0001,  0.02, 1.5 },  50.0 },
+	};
+
+typedef struct {
+	double overshoot;                       // Highest Volts over target after the hand-over
+	double dip;                             // Lowest Volts under target, from 2S after the hand-over
+	bool   accepted;                        // Made it into Acceptance
+	} tResult;
+
+typedef struct {
+	double overshoot[8];                    // Each case (plain, speed-up), summed over the seeds
+	double dip[8];
+	} tTotals;
+
+
+static tResult run(int which) {
+	const tCase *c = &cases[(which % 8) / 2];
+	bool    speedUp = which & 1;
+	tResult r = { 0, 0, false };
+	tPlant  p;
+	long    reached = -1;
+	bool    faster  = false;
+
+	srand(47 + which / 8);
+	targetBatVolts = TARGET_VOLTS;
+	targetAltAmps  = c->targetAmps;
+	targetAltWatts = 15000;
+	workingParms.EXIT_ACPT_DURATION = 0;                                    // (Stay in Acceptance)
+	workingParms.EXIT_ACPT_AMPS     = 0;
+	workingParms.EXIT_ACPT_DIDT     = 0;
+	plant_start(&p, &c->spec, 0);
+	set_ALT_mode(bulk_charge);
+
+	for (long t = 0; t < 240000L * 1000L / (long) PLANT_TICK_US; t++) {
+		long ms = t * PLANT_TICK_US / 1000L;
+		if (speedUp && !faster && (p.volts >= TARGET_VOLTS - 0.06)) {
+			faster  = true;                                         // Engine picks up:  40% more Amps per field step
+			p.speed = 1.4;
+			}
+		plant_tick(&p);
+
+		if ((reached < 0) && (p.volts >= TARGET_VOLTS - 0.030))
+			reached = ms;
+		if ((reached >= 0) && ((ms - reached) < WATCH_FOR)) {
+			r.overshoot = fmax(r.overshoot, p.volts - TARGET_VOLTS);
+			if ((ms - reached) > 2000)
+				r.dip = fmax(r.dip, TARGET_VOLTS - p.volts);
+			}
+		}
+	r.accepted = (alternatorState == acceptance_charge);
+	return(r);
+}
+
+
+int main(int argc, char *argv[]) {
+	float i;
+
+	// Over its target and not in control:  held where it was, not taking on this pass's error.
+	i = 0.6f;                                       // (pid_term() had added 0.3 to an I of 0.3)
+	pid_track(&i, 0.3f, 0.03f, 0.01f, -1.0f, -2.0f, 10.0f, 0.5f, 0.9f);
+	assert(i == 0.3f);
+	i = 0.6f;                                       // In control, but the reading is already on its way down:  held too
+	pid_track(&i, 0.3f, 0.03f, -0.01f, -2.0f, -2.0f, 10.0f, 0.5f, 0.9f);
+	assert(i == 0.3f);
+	i = 0.6f;                                       // In control and still going up, keeps what pid_term() made of it
+	pid_track(&i, 0.3f, 0.03f, 0.01f, -2.0f, -2.0f, 10.0f, 0.5f, 0.9f);
+	assert(i == 0.6f);
+	// Under its target:  I moves gain of the way to where the loop would have asked for just the applied change, ignoring this pass's error.
+	i = 0.1f;                                       // (pid_term() had taken 0.2 off an I of 0.3)
+	pid_track(&i, 0.3f, -0.02f, 0.0f, 1.0f, 0.6f, 10.0f, 0.5f, 0.9f);
+	assert(fabs(i - (0.3f + 0.5f * (0.8f - 0.6f))) < 0.0001f);
+	i = 0.5f;
+	pid_track(&i, 0.4f, -0.01f, 0.0f, 3.0f, 1.0f, 10.0f, 0.5f, 0.9f);
+	assert(i == 0.9f);                              // Capped
+	i = 0.1f;
+	pid_track(&i, 0.3f, -0.02f, 0.0f, 0.6f, 0.6f, 10.0f, 0.5f, 0.9f);        // Had its say
+	assert(i == 0.1f);
+	i = 0.6f;
+	pid_track(&i, 0.3f, 0.03f, 0.01f, -1.0f, -2.0f, 0.0f, 0.5f, 0.9f);       // No I in this loop (Ki = 0),
+	assert(i == 0.6f);
+	pid_track(&i, 0.3f, 0.03f, 0.01f, -1.0f, -2.0f, 10.0f, 0.0f, 0.9f);      //  or the anti-windup turned off, stays put
+	assert(i == 0.6f);
+
+
+	// Through the hand-over, on every plant, the Volts loop should take over without tripping the load-dump checks, or letting the
+	// battery sag as far under the target as LD2 is over it.  (A sudden speed-up right then is a small load dump of its own, and with
+	// triggered 16x sampling may just touch LD1 on the smaller alternators before the Field comes back, but should never reach LD2)
+	tTotals t;
+	memset(&t, 0, sizeof(t));
+	for (int n = 0; n < 8 * SEEDS; n++) {
+		tResult r = sim_fresh(run, n);
+
+		assert(r.accepted);
+		assert(r.overshoot < ((n & 1) ? LD2_THRESHOLD : LD1_THRESHOLD));
+		assert(r.dip       < LD2_THRESHOLD);
+		t.overshoot[n % 8] += r.overshoot;
+		t.dip[n % 8]       += r.dip;
+		}
+	if (sim_result(argc, argv, t))
+		return(0);
+
+  #ifdef UNTRACKED
+	printf("All tests passed.  (Anti-windup off only, testAntiWindup compares)\n");
+	return(0);
+  #else
+	// And with the anti-windup on, the hand-over should overshoot less and dip less then with it off.  (Single runs are as much down
+	// to the noise as anything, so it is the totals over all of them that are compared)
+	tTotals u = sim_other_build<tTotals>(argv[0], "Untracked");
+	double  over = 0, dip = 0, uOver = 0, uDip = 0;
+
+	for (int n = 0; n < 8; n++) {
+		printf("%-14s %-10s  mean overshoot %5.1f mV (%5.1f untracked)   dip %5.1f mV (%5.1f untracked)\n", cases[n / 2].name,
+		       (n & 1) ? "speed-up" : "plain", t.overshoot[n] * 1000 / SEEDS, u.overshoot[n] * 1000 / SEEDS,
+		       t.dip[n] * 1000 / SEEDS, u.dip[n] * 1000 / SEEDS);
+		over  += t.overshoot[n];
+		dip   += t.dip[n];
+		uOver += u.overshoot[n];
+		uDip  += u.dip[n];
+		}
+	assert(over < uOver);
+	assert(dip  < uDip);
+
+	printf("All tests passed.\n");
+	return 0;
+  #endif
+}
@@ -0,0 +1,205 @@
+// The real manage_ALT() (see SimPlant.h) on several alternator / battery combinations.  Each plant is first run through the
+// auto_tune_V relay test to find its gains, keeping the swing clear of the load-dump checks, and then both the Config.h default
+// gains and the tuned ones are put through the same target raise and house load drop, comparing overshoot, settling time and IAE.
+#include "SimPlant.h"
+
+#define TARGET_VOLTS        14.4
+#define START_VOLTS         14.25
+#define SETTLE_BAND         0.030               // 'Settled' once within (and staying within) 30mV of target
+
+typedef struct {
+	const char *name;
+	tPlantSpec  spec;                       // (Open circuit volts are set so the battery takes the 'acceptance' Amps at 14.4v)
+	double      loadHigh, loadLow;          // House load steps between these
+	} tCase;
+
+static const tCase cases[] = {
+	{ "60A on 100Ah",       { 0.30,  60.0, 0.08, 0.008, 0.010, 2.0, 14.13, 0.0, 0.0, 0.0 },  30.0,  5.0 },
+	{ "120A on 400Ah",      { 0.55, 120.0, 0.15, 0.003, 0.004, 4.0, 14.19, 0.0, 0.0, 0.0 },  70.0, 15.0 },
+	{ "250A on 600Ah",      { 1.10, 250.0, 0.25, 0.002, 0.003, 5.0, 14.15, 0.0, 0.0, 0.0 }, 150.0, 40.0 },
+	{ "300A on 200Ah LFP",  { 1.30, 300.0, 0.30, 0.004, 0.002, 3.0, 14.16, 0.0, 0.0, 0.0 }, 200.0, 30.0 },
+	};
+
+
+static void set_targets(double volts) {
+	targetBatVolts = volts;
+	targetAltAmps  = 500;                                                   // (Only the Volts loop in play)
+	targetAltWatts = 15000;
+}
+
+
+static void via_serial(const char *cmd) {
+	static char line[100];
+
+	snprintf(line, sizeof(line), "$%s\r\n", cmd);
+	Serial.clear();
+	Serial.in = line;
+	for (int i = 0; i < 100; i++) {
+		host_advance(10);
+		check_inbound();
+		}
+	Serial.in = NULL;
+}
+
+
+typedef struct {
+	bool   tuned;                           // Came out of auto_tune_V with new gains ..
+	bool   toSave;                          //  .. flagged for loop() to save
+	float  Kp, Kd;
+	double peak;                            // Highest Volts over target during the relay test
+	} tTune;
+
+// The relay test as $FRM:T starts it, at the target voltage.
+static tTune tune(int which) {
+	const tCase *c = &cases[which];
+	tTune   r;
+	tPlant  p;
+
+	set_targets(TARGET_VOLTS);
+	plant_balance(&p, &c->spec, TARGET_VOLTS, c->loadLow);
+	pidGains.KP_V = pidGains.KD_V = 0;
+	set_ALT_mode(auto_tune_V);
+
+	r.peak = 0;
+	for (long t = 0; (alternatorState == auto_tune_V) && (t < (long) (2 * AUTOTUNE_DURATION * 1000 / PLANT_TICK_US)); t++) {
+		plant_tick(&p);
+		r.peak = fmax(r.peak, p.volts - TARGET_VOLTS);
+		}
+	r.tuned  = (pidGains.KP_V != 0);
+	r.toSave = pidGainsTuned;
+	r.Kp    = pidGains.KP_V;
+	r.Kd    = pidGains.KD_V;
+	return(r);
+}
+
+
+typedef struct {
+	double overshoot;                       // Highest Volts over target after the target is raised
+	double settleStep;                      // Seconds to settle after the target is raised ..
+	double settleLoad;                      //  .. and after the house load drops
+	double iae;                             // Integral of |error| (V.S) after the load drop
+	double overVS;                          // Integral of Volts over the target (V.S) after the load drop
+	int    LDs;                             // Times a reading went over LD1
+	} tResult;
+
+typedef struct {
+	int    which;
+	float  Kp, Kd;
+	} tRun;
+
+
+// Hold START_VOLTS, raise the target to TARGET_VOLTS at 1S (e.g., Float --> Bulk), and then drop the house load by 1/4 of the
+// alternators capacity at 16S.
+#define RAISE_AT             1000L
+#define DROP_AT             16000L
+#define RUN_FOR             31000L
+
+static tResult run(tRun g) {
+	const tCase *c = &cases[g.which];
+	tResult r = { 0, 0, 0, 0, 0, 0 };
+	tPlant  p;
+	long    lastOut = 0;
+	bool    over    = false;
+	double  dt      = PLANT_TICK_US / 1000000.0;
+
+	pidGains.KP_V = g.Kp;
+	pidGains.KD_V = g.Kd;
+	set_targets(START_VOLTS);
+	plant_balance(&p, &c->spec, START_VOLTS, c->loadHigh);
+	set_ALT_mode(forced_float_charge);                                      // (Just hold the target voltage)
+
+	for (long t = 0; t < RUN_FOR * 1000L / (long) PLANT_TICK_US; t++) {
+		long ms = t * PLANT_TICK_US / 1000L;
+		if (ms >= RAISE_AT)
+			targetBatVolts = TARGET_VOLTS;
+		p.load = (ms >= DROP_AT) ? c->loadHigh - c->spec.maxAmps / 4 : c->loadHigh;
+		plant_tick(&p);
+
+		double v = p.volts;
+		if ((ms == RAISE_AT) || (ms == DROP_AT) || (fabs(v - targetBatVolts) > SETTLE_BAND))
+			lastOut = ms;
+		if ((ms >= RAISE_AT) && (ms < DROP_AT))
+			r.overshoot = fmax(r.overshoot, v - targetBatVolts);
+		if (ms >= DROP_AT) {
+			r.iae    += fabs(v - targetBatVolts) * dt;
+			r.overVS += fmax(v - targetBatVolts, 0) * dt;
+			}
+		if (ms < DROP_AT)
+			r.settleStep = (lastOut - RAISE_AT) / 1000.0;
+		r.settleLoad = (lastOut - DROP_AT) / 1000.0;
+
+		bool nowOver = (measuredBatVolts - targetBatVolts) > LD1_THRESHOLD;
+		r.LDs += (nowOver && !over);
+		over   = nowOver;
+		}
+	return(r);
+}
+
+
+int main() {
+	tRelayTune t;
+	float      Kp, Kd;
+
+	// Gains come out of a known oscillation as expected:  Ku = 4d/(pi a), Ziegler-Nichols PI (Kc derated to 0.35 Ku)
+	// with Kd as the P and Kp as the I
+	relay_tune_start(&t, 14.0, 0.01, 0.2, 100, 20, 0);
+	unsigned long ms = 0;
+	for (int c = 0; c <= RELAY_TUNE_CYCLES; c++) {
+		assert(!relay_tune_gains(&t, 100, &Kp, &Kd));
+		assert(relay_tune_step(&t, 14.1, ms) == 80);              // Over center+hyst:  relay goes low
+		ms += 500;
+		assert(relay_tune_step(&t, 13.9, ms) == 120);             // Under center-hyst: back high, one cycle done
+		ms += 500;
+		}
+	assert(relay_tune_gains(&t, 100, &Kp, &Kd));
+	float Ku = 4 * 20 / (3.14159f * 0.1f);                       // (0.2v peak-to-peak)
+	assert(fabs(Kd - 0.35f * Ku) < 0.01f);
+	assert(fabs(Kp - 0.35f * Ku * 100 / (1000 / 1.2f)) < 0.01f);
+
+	// A cycle swinging past the limit has the step halved and starts the count over, the gains then coming from the smaller step.
+	relay_tune_start(&t, 14.0, 0.01, 0.05, 100, 20, 0);
+	ms = 0;
+	assert(relay_tune_step(&t, 14.1,  ms) == 80);
+	assert(relay_tune_step(&t, 13.97, ms += 500) == 110);           // 100mV over:  step cut to 10
+	for (int c = 0; c <= RELAY_TUNE_CYCLES; c++) {
+		assert(!relay_tune_gains(&t, 100, &Kp, &Kd));
+		assert(relay_tune_step(&t, 14.04, ms += 500) == 90);
+		assert(relay_tune_step(&t, 13.96, ms += 500) == 110);
+		}
+	assert(relay_tune_gains(&t, 100, &Kp, &Kd));
+	assert(fabs(Kd - 0.35f * 4 * 10 / (3.14159f * 0.04f)) < 0.01f);
+
+
+	// $FRM:T is refused while the gains it finds could not be saved (write_PID_EEPROM() does nothing until the BT config is changed)
+	systemConfig.BT_CONFIG_CHANGED = false;
+	via_serial("FRM:T");
+	assert((alternatorState != auto_tune_V) && (Serial.outLen == 0));
+	systemConfig.BT_CONFIG_CHANGED = true;
+	via_serial("FRM:T");
+	assert((alternatorState == auto_tune_V) && (strstr(Serial.out, "AOK") != NULL));
+	set_ALT_mode(forced_float_charge);
+
+
+	// On each of the plant models the relay test should keep the battery clear of LD1, and leave the new gains for loop() to save.
+	// The tuned gains should then settle faster than the defaults when the target is raised, with no more overshoot, and after the
+	// load drop not go over LD1 more often nor take longer to get back to target (IAE).  (How soon the load drop 'settles' is shown but
+	// not held to:  a step of the PWM can be most of SETTLE_BAND, so either may sit just outside it for a while)
+	for (int i = 0; i < (int) (sizeof(cases) / sizeof(cases[0])); i++) {
+		tTune g = sim_fresh(tune, i);
+		assert(g.tuned && g.toSave);
+		assert(g.peak < LD1_THRESHOLD);
+		tResult d = sim_fresh(run, (tRun) { i, pidGains.KP_V, pidGains.KD_V });
+		tResult a = sim_fresh(run, (tRun) { i, g.Kp,          g.Kd });
+
+		printf("%-18s  Kp %5.1f Kd %5.1f  (tune peak %2.0f mV)   overshoot %2.0f / %2.0f mV   settle %4.1f / %4.1f S   load drop: settle %4.1f / %4.1f S  IAE %5.3f / %5.3f  over %5.3f / %5.3f V.S   over LD1 %2d / %2d\n",
+		       cases[i].name, g.Kp, g.Kd, g.peak * 1000, d.overshoot * 1000, a.overshoot * 1000, d.settleStep, a.settleStep, d.settleLoad, a.settleLoad, d.iae, a.iae, d.overVS, a.overVS, d.LDs, a.LDs);
+
+		assert(a.overshoot  <  LD1_THRESHOLD);
+		assert(a.overshoot  <= d.overshoot);
+		assert(a.settleStep <  d.settleStep);
+		assert(a.LDs        <= d.LDs);
+		assert(a.iae        <= d.iae);
+		}
+
+	return 0;
+}
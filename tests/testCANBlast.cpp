@@ -0,0 +1,123 @@
+// The CAN Terminal's receive side, run for real (see SimRegulator.h) with CAN_ASCII_FLOW_CONTROL on (as it is by default):  a sender
+// streaming commands faster than loop() works through them.  As the buffer nears full the sender is asked to pause (XOFF), and asked to
+// resume (XON) once it has drained.  Honoring those, and sending no more than 2 frames between loop() passes, not a character is lost.
+// The XON goes back to that same sender - even though the replies to its commands have long since cleared CAN_ASCII_source.
+#define SIM_SYSTEMCAN
+#include "SimRegulator.h"
+
+#define TICK_MS      10UL
+#define TERM_SOURCE  0x20
+
+
+static void tick(void) {
+	host_advance(TICK_MS);
+	check_CAN();
+	check_inbound();
+	send_CAN();
+	host_can_bus(100);
+}
+
+
+static void send_frame(const char *chars, int len) {
+	uint8_t me = NMEA2000.GetN2kSource();
+
+	assert(host_can_receive((7UL << 26) | ((0x17E00UL | me) << 8) | TERM_SOURCE, true, len, (const uint8_t *) chars) >= 0);
+}
+
+
+static void blast(const char *frame, int frames) {             // Back to back, with no loop() pass in between
+	for (int i = 0; i < frames; i++)
+		send_frame(frame, strlen(frame));
+}
+
+
+static int count_AOK(const char *s) {
+	int n = 0;
+
+	while ((s = strstr(s, "AOK;")) != NULL) {
+		n++;
+		s++;
+		}
+	return(n);
+}
+
+
+static int flow_chars(unsigned from, char c, int dest) {        // Count the 1 character XON / XOFF frames sent to 'dest'
+	int n = 0;
+
+	for (unsigned i = from; (i < hostCANSentCnt) && (i < HOST_CAN_SENT_MAX); i++) {
+		const tHostCANFrame &f = hostCANSent[i];
+		if ((((f.id >> 8) & 0x1FFFF) == (0x17E00UL | dest)) && (f.length == 1) && (f.data[0] == c))
+			n++;
+		}
+	return(n);
+}
+
+
+int main() {
+	alternatorState = bulk_charge;
+	initialize_CAN();
+	for (int i = 0; i < 300; i++)
+		tick();
+
+
+	// 60 commands, one after another, cut into 8 character frames wherever they fall.  The sender goes at 2 frames a loop() pass, more
+	// than the one command a pass check_inbound() takes, until told to pause.
+	static char stream[1000];
+	int  commands = 60;
+	int  len      = 0;
+	for (int i = 0; i < commands; i++)
+		len += snprintf(stream + len, sizeof(stream) - len, "$EBA:%d.5\r\n", i * 7);
+
+	unsigned from     = hostCANSentCnt = 0;                         // (Start the record of frames sent over, so it holds them all)
+	int      sent     = 0;
+	int      aoks     = 0;
+	int      xoffs    = 0, xons = 0;
+	bool     paused   = false;
+	for (int pass = 0; (pass < 1000) && (aoks < commands); pass++) {
+		for (int f = 0; (f < 2) && !paused && (sent < len); f++) {
+			int n = min(8, len - sent);
+			send_frame(stream + sent, n);
+			sent += n;
+			}
+
+		Serial.clear();
+		tick();
+		aoks += count_AOK(Serial.out);
+
+		int off = flow_chars(from, cASCII_XOFF, TERM_SOURCE);   // Has the regulator said anything to the sender?
+		int on  = flow_chars(from, cASCII_XON,  TERM_SOURCE);
+		if (off > xoffs) paused = true;
+		if (on  > xons)  paused = false;
+		xoffs = off;
+		xons  = on;
+		}
+	printf("Streamed %d chars:  %d commands answered, XOFF %d, XON %d, %u overrun\n", len, aoks, xoffs, xons, CAN_ASCII_rxOverruns);
+	assert(sent == len);
+	assert(aoks == commands);
+	assert(measuredBatAmps == (commands - 1) * 7 + 0.5f);
+	assert(CAN_ASCII_rxOverruns == 0);
+	assert(xoffs > 0);                                                      // (It did have to pause)
+	assert(xons == xoffs);
+	assert(CAN_ASCII_available() == 0);
+
+
+	// Now a blast of commands.  Each one's AOK reply is the end of it, and clears CAN_ASCII_source - but the XON still has to reach
+	// the sender, or it will wait for ever.
+	from = hostCANSentCnt;
+	blast("$EDB:0\r\n", 7);
+	check_CAN();
+	host_can_bus(100);
+	assert(CAN_ASCII_rxOverruns == 0);
+	assert(flow_chars(from, cASCII_XOFF, TERM_SOURCE) == 1);
+	for (int i = 0; i < 100; i++)
+		tick();
+	assert(CAN_ASCII_available() == 0);
+	assert(CAN_ASCII_source == 0);
+	printf("Blasted 7 commands:  XOFF %d, XON %d to the sender, %d to no one\n", flow_chars(from, cASCII_XOFF, TERM_SOURCE),
+	       flow_chars(from, cASCII_XON, TERM_SOURCE), flow_chars(from, cASCII_XON, 0));
+	assert(flow_chars(from, cASCII_XON, TERM_SOURCE) == 1);
+	assert(flow_chars(from, cASCII_XON, 0) == 0);
+
+	return 0;
+}
@@ -0,0 +1,127 @@
+// avr_can's sendFrame() against the TXOK interrupt, using the MOb model in HostCAN.h:  the bus finishes a frame (and the ISR runs, if
+// it can) just before each CAN register access sendFrame() makes in turn, and at each step of publishing the frame (CAN_TX_STEP()),
+// with the TX MObs and the queue in every state that matters.  However they interleave, no frame may be left queued with no TX MOb
+// armed to carry it, and they must still go out in order.  Then what sendFrame() costs the main line, now that it only starts the
+// TX MObs itself when none is busy, against the old way of checking them (interrupts held off) on every call.
+#define __AVR_ATmega64M1__
+#include "Arduino.h"
+#define private public                          // (To run the old tail of sendFrame(), which called tx_mobs_refill() every time)
+#include "avr_can.cpp"
+#undef private
+
+
+static CAN_FRAME frame(uint8_t priority, uint16_t seq) {
+	CAN_FRAME f;
+
+	memset(&f, 0, sizeof(f));
+	f.id       = ((uint32_t) priority << 26) | (0x1FF9DUL << 8) | 0x80;
+	f.extended = true;
+	f.length   = 8;
+	f.data.s0  = seq;
+	return(f);
+}
+
+
+static void old_tail(void) {                    // What the old sendFrame() did after publishing the frame, busy or not
+	uint8_t oldSREG = SREG;
+	cli();
+	Can0.tx_mobs_refill();
+	SREG = oldSREG;
+}
+
+
+typedef struct {
+	unsigned long touches, touchesOff, clis;
+	} tCost;
+
+static tCost cost_since(const tCost &from) {
+	tCost c = { hostCANTouches - from.touches, hostCANTouchesOff - from.touchesOff, hostCLIs - from.clis };
+	return(c);
+}
+
+static tCost cost_now(void) {
+	tCost c = { hostCANTouches, hostCANTouchesOff, hostCLIs };
+	return(c);
+}
+
+
+int main() {
+	unsigned runs = 0, preempted = 0;
+
+	for (uint8_t txMObs = 1; txMObs <= 3; txMObs++)
+		for (int before = 0; before < txMObs + 3; before++)             // Frames already in the MObs / queue
+			for (uint8_t pri = 2; pri <= 6; pri += 4)               // The new frame goes on the back, or passes the others
+				for (long at = 0; ; at++) {
+					host_can_reset();
+					Can0.begin(CAN_BPS_250K);
+					Can0.setNumTXBoxes(txMObs);
+
+					uint16_t seq = 0;
+					for (int i = 0; i < before; i++) {
+						CAN_FRAME f = frame(6, seq++);
+						assert(Can0.sendFrame(f));
+						}
+
+					hostCANPreemptAt = at;
+					CAN_FRAME f = frame(pri, 1000);
+					assert(Can0.sendFrame(f));
+					bool fired = (hostCANPreemptAt < 0);
+					hostCANPreemptAt = -1;
+
+					host_can_bus(100);
+					runs++;
+					assert(hostCANSentCnt == (unsigned) before + 1);          // Nothing stranded
+
+					uint16_t last = 0;
+					bool     sawNew = false;
+					for (unsigned n = 0; n < hostCANSentCnt; n++) {
+						uint16_t s = hostCANSent[n].data[0] | (hostCANSent[n].data[1] << 8);
+						if (s == 1000) { sawNew = true; continue; }
+						assert((n == 0) || (s >= last) || sawNew);        // The older ones in order
+						last = s;
+						}
+					assert(sawNew);
+
+					if (!fired)
+						break;                                    // Walked past the last register access
+					preempted++;
+					}
+
+	printf("%u runs, %u with the bus finishing a frame inside sendFrame()\n", runs, preempted);
+
+
+	// The cost to the main line:  register accesses, those with interrupts held off (which the ISR must wait out), and times they
+	// were held off.  With a TX MOb busy sendFrame() now does none of them;  the old one always held interrupts off to check the MObs.
+	printf("TX MObs  MObs idle: accesses/held off/cli   MObs busy: now   old\n");
+	for (uint8_t txMObs = 1; txMObs <= 3; txMObs++) {
+		host_can_reset();
+		Can0.begin(CAN_BPS_250K);
+		Can0.setNumTXBoxes(txMObs);
+
+		CAN_FRAME f = frame(6, 0);
+		tCost from = cost_now();
+		assert(Can0.sendFrame(f));                                      // Nothing sending, so it starts the MObs
+		tCost idle = cost_since(from);
+
+		f = frame(6, 1);
+		from = cost_now();
+		assert(Can0.sendFrame(f));                                      // One sending, so the ISR will pick this one up
+		tCost busy = cost_since(from);
+
+		from = cost_now();
+		old_tail();
+		tCost old = cost_since(from);
+
+		printf("  %u      %3lu / %3lu / %lu                  %lu/%lu/%lu   %lu/%lu/%lu\n", txMObs,
+			idle.touches, idle.touchesOff, idle.clis, busy.touches, busy.touchesOff, busy.clis,
+			busy.touches + old.touches, busy.touchesOff + old.touchesOff, busy.clis + old.clis);
+		assert((idle.clis == 1) && (idle.touchesOff > 0));
+		assert((busy.touches == 0) && (busy.clis == 0));
+		assert((old.clis == 1) && (old.touchesOff > 0));
+
+		host_can_bus(100);
+		assert(hostCANSentCnt == 2);
+		}
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+// avr_can's transmit side run against the MOb model in HostCAN.h:  the hardware sends whichever armed TX MOb has the lowest number,
+// so frames must still go out in the order they were given to sendFrame() (by priority, FIFO within a priority) however the bus
+// and the producer interleave - and none may be left stranded.
+#define __AVR_ATmega64M1__
+#include "Arduino.h"
+#include "avr_can.cpp"
+
+#define TX_MOBS  2
+
+
+static CAN_FRAME frame(uint8_t priority, uint16_t seq, uint8_t sa) {
+	CAN_FRAME f;
+
+	memset(&f, 0, sizeof(f));
+	f.id         = ((uint32_t) priority << 26) | (0x1FF9DUL << 8) | sa;
+	f.extended   = true;
+	f.length     = 8;
+	f.data.s0    = seq;
+	return(f);
+}
+
+static uint16_t seq_of(unsigned n)       { return(hostCANSent[n].data[0] | (hostCANSent[n].data[1] << 8)); }
+static uint8_t  priority_of(unsigned n)  { return((hostCANSent[n].id >> 26) & 7); }
+
+
+static void start(void) {
+	host_can_reset();
+	Can0.begin(CAN_BPS_250K);
+	Can0.setNumTXBoxes(TX_MOBS);
+}
+
+
+int main() {
+	srand(33);
+
+	// One priority, the bus and the producer taking turns at random:  strictly first in, first out.
+	for (int run = 0; run < 50; run++) {
+		start();
+		uint16_t seq = 0;
+
+		while (seq < 500) {
+			CAN_FRAME f = frame(6, seq, (seq % 3) ? 0x80 : 0x81);       // (Some the same ID back to back, as in a fast-packet)
+			if (Can0.sendFrame(f))
+				seq++;
+			else
+				host_can_bus(1);                                    // Queue full, let the bus catch up
+			if (rand() % 3 == 0)
+				host_can_bus(rand() % 3);
+			}
+		host_can_bus(1000);
+
+		assert(hostCANSentCnt == 500);                                      // Nothing stranded in the queue
+		for (unsigned n = 0; n < hostCANSentCnt; n++)
+			assert(seq_of(n) == n);
+		}
+
+
+	// A high priority frame passes everything queued, but not what is already in a MOb:  out within TX_MOBS frames.
+	for (int run = 0; run < 200; run++) {
+		start();
+		uint16_t seq = 0;
+		int      busy = 1 + rand() % 6;
+
+		for (int i = 0; i < busy; i++) {
+			CAN_FRAME f = frame(6, seq++, 0x80);
+			assert(Can0.sendFrame(f));
+			}
+		host_can_bus(rand() % 2);
+		unsigned sentBefore = hostCANSentCnt;
+		CAN_FRAME alert = frame(2, 999, 0x80);
+		assert(Can0.sendFrame(alert));
+		host_can_bus(1000);
+
+		unsigned n;
+		for (n = sentBefore; seq_of(n) != 999; n++)
+			assert(n < hostCANSentCnt);
+		assert(n - sentBefore <= TX_MOBS);
+		for (unsigned m = 0, last = 0; m < hostCANSentCnt; m++)         // The rest still in order
+			if (priority_of(m) == 6) {
+				assert((m == 0) || (seq_of(m) >= last));
+				last = seq_of(m);
+				}
+		}
+
+	printf("In order\n");
+	return 0;
+}
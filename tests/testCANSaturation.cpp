@@ -0,0 +1,67 @@
+// avr_can flat out against the MOb model in HostCAN.h, for each split of the 6 MObs between RX and TX:  frames a second with the TX
+// queue kept full, and how much of that time the bus sat idle waiting on the TXOK interrupt to load the next frame.  More TX MObs
+// armed back-to-back means fewer of those gaps - and every frame still goes out, in order.
+#define __AVR_ATmega64M1__
+#include "Arduino.h"
+#include "avr_can.cpp"
+
+#define FRAME_US     540UL                      // 29-bit ID, 8 bytes at 250Kbps (as CAN_FRAME_BUS_TIME)
+#define RELOAD_US    100UL                      // Interrupt response and the ISR loading a MOb, other interrupts in the way included
+#define FRAMES       2000
+
+
+static double run(uint8_t txMObs) {
+	CAN_FRAME     f;
+	uint16_t      seq   = 0;
+	unsigned long start;
+
+	host_can_reset();
+	hostCANFrameMicros  = FRAME_US;
+	hostCANReloadMicros = RELOAD_US;
+	Can0.begin(CAN_BPS_250K);
+	assert(Can0.setNumTXBoxes(txMObs) == txMObs);
+
+	memset(&f, 0, sizeof(f));
+	f.id       = (6UL << 26) | (0x1FF9DUL << 8) | 0x80;
+	f.extended = true;
+	f.length   = 8;
+	start      = micros();
+
+	while (hostCANSentCnt < FRAMES) {
+		while (seq < FRAMES) {                          // Keep the queue topped up ..
+			f.data.s0 = seq;
+			if (!Can0.sendFrame(f))
+				break;
+			seq++;
+			}
+		host_can_bus(1);                                // .. while the bus takes a frame at a time
+		}
+
+	double secs = (micros() - start) / 1e6;
+	double fps  = FRAMES / secs;
+	printf("%d TX MObs:  %5.0f frames/S, bus idle %4.1f%%\n", txMObs, fps, 100.0 * hostCANIdleMicros / (micros() - start));
+
+	for (unsigned n = 0; n < FRAMES; n++) {
+		assert((hostCANSent[n].data[0] | (hostCANSent[n].data[1] << 8)) == n);
+		assert((hostCANSent[n].mob >= HOST_CAN_MOBS - txMObs) && (hostCANSent[n].mob < HOST_CAN_MOBS));
+		}
+	assert(hostCANIdleMicros <= (FRAMES / txMObs + 1) * RELOAD_US);        // At most one wait per batch of MObs
+	return(fps);
+}
+
+
+int main() {
+	double fps[HOST_CAN_MOBS];
+
+	for (uint8_t tx = 1; tx < HOST_CAN_MOBS; tx++)          // (At least one MOb is left to receive)
+		fps[tx] = run(tx);
+
+	assert(fps[1] < 1e6 / (FRAME_US + RELOAD_US) * 1.01);   // One TX MOb:  a gap after every frame
+	for (uint8_t tx = 2; tx < HOST_CAN_MOBS; tx++) {
+		assert(fps[tx] > fps[tx - 1]);
+		assert(fps[tx] < 1e6 / FRAME_US);
+		}
+	assert(fps[2] > fps[1] * 1.07);
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+// avr_can's ring counters against the MOb model in HostCAN.h:  frames dropped when a ring is full are counted, the high-water marks
+// track the most frames waiting, and the ISR latency - read in CAN timer ticks at the CANTCON prescale init() sets - matches how long
+// interrupts were held off after a frame was captured.
+#define __AVR_ATmega64M1__
+#include "Arduino.h"
+#include "avr_can.cpp"
+
+
+static uint8_t  msg[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+
+static void start(void) {
+	host_can_reset();
+	Can0.begin(CAN_BPS_250K);
+	Can0.setNumTXBoxes(1);
+	for (uint8_t mb = 0; mb < HOST_CAN_MOBS - 1; mb++)
+		Can0.setRXFilter(mb, 0, 0, true);
+}
+
+
+int main() {
+	CAN_FRAME f;
+
+	// The prescale:  the CAN timer ticks every 8uS at 16MHz
+	start();
+	assert(CANTCON == CAN_TIMER_PRESCALE);
+	assert(CAN_TIMER_TICKS_TO_US(1) == 8);
+	assert(CAN_TIMER_TICKS_TO_MS(125) == 1);
+
+
+	// ISR latency:  a frame captured while interrupts are held off for a while.
+	static const unsigned long holdOff[] = { 0, 8, 100, 1000, 20000, 250000 };
+	uint16_t lastMax = 0;
+	for (unsigned i = 0; i < sizeof(holdOff) / sizeof(holdOff[0]); i++) {
+		uint8_t oldSREG = SREG;
+		cli();
+		assert(host_can_receive(0x18EEFF00 | i, true, 8, msg) >= 0);
+		hostMicros += holdOff[i];
+		SREG = oldSREG;                                                 // The ISR gets in now
+
+		uint16_t lat = Can0.get_isr_latency_max();
+		printf("Held off %6luuS:  latency %5u ticks, %6luuS\n", holdOff[i], lat, (unsigned long) CAN_TIMER_TICKS_TO_US(lat));
+		assert(lat >= lastMax);
+		assert(labs((long) CAN_TIMER_TICKS_TO_US(lat) - (long) holdOff[i]) < 8);
+		lastMax = lat;
+		assert(Can0.get_rx_buff(f) && (f.id == (0x18EEFF00 | i)));
+		}
+
+
+	// RX ring:  nobody reading, so it fills to SIZE_RX_BUFFER-1 frames and the rest are counted as they are dropped.
+	start();
+	for (unsigned i = 0; i < SIZE_RX_BUFFER + 5; i++) {
+		msg[0] = i;
+		assert(host_can_receive(0x18EEFF00, true, 8, msg) >= 0);     // (The ISR frees the MOb each time, only the ring fills)
+		}
+	assert(Can0.get_rx_high_water() == SIZE_RX_BUFFER - 1);
+	assert(Can0.get_rx_overflow_cnt() == 6);
+	for (unsigned i = 0; i < SIZE_RX_BUFFER - 1; i++)                   // The oldest are kept
+		assert(Can0.get_rx_buff(f) && (f.data.byte[0] == i));
+	assert(!Can0.get_rx_buff(f));
+
+
+	// TX ring:  with the bus stopped one frame sits in the MOb, SIZE_TX_BUFFER-1 wait in the ring and the rest are refused.
+	memset(&f, 0, sizeof(f));
+	f.id       = 0x18EEFF80;
+	f.extended = true;
+	f.length   = 8;
+	for (unsigned i = 0; i < SIZE_TX_BUFFER + 3; i++)
+		assert(Can0.sendFrame(f) == (i < SIZE_TX_BUFFER));
+	assert(Can0.get_tx_high_water() == SIZE_TX_BUFFER - 1);
+	assert(Can0.get_tx_overflow_cnt() == 3);
+	host_can_bus(100);
+	assert(hostCANSentCnt == SIZE_TX_BUFFER);
+
+
+	// And they all start again.
+	Can0.reset_buffer_stats();
+	assert((Can0.get_rx_overflow_cnt() == 0) && (Can0.get_tx_overflow_cnt() == 0) && (Can0.get_rx_high_water() == 0) &&
+	       (Can0.get_tx_high_water() == 0) && (Can0.get_isr_latency_max() == 0));
+
+	return 0;
+}
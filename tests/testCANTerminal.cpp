@@ -0,0 +1,123 @@
+// The CAN Terminal's transmit side, run for real (see SimRegulator.h):  long replies ($RAS: all the status strings) asked for over and
+// over.  The reply frames keep within their share of the bus, every character either goes out or is counted in CAN_ASCII_txDrops, and
+// none are dropped while the requests come no faster than the Terminal can send.  With the bus stalled the Terminal backs off, leaving
+// room in the NMEA2000 send buffer for the regular messages, and picks up where it left off once the bus is back.
+#define SIM_SYSTEMCAN
+#include "SimRegulator.h"
+
+#define TICK_MS      10UL
+#define TERM_SOURCE  0x20
+
+
+static bool busRunning = true;
+static int  worstTick;
+
+static unsigned frames_to_terminal(unsigned from) {
+	unsigned n = 0;
+
+	for (unsigned i = from; (i < hostCANSentCnt) && (i < HOST_CAN_SENT_MAX); i++)
+		n += (((hostCANSent[i].id >> 8) & 0x1FFFF) == (0x17E00 | TERM_SOURCE));
+	return(n);
+}
+
+static unsigned long chars_to_terminal(unsigned from) {
+	unsigned long n = 0;
+
+	for (unsigned i = from; (i < hostCANSentCnt) && (i < HOST_CAN_SENT_MAX); i++)
+		if (((hostCANSent[i].id >> 8) & 0x1FFFF) == (0x17E00 | TERM_SOURCE))
+			n += hostCANSent[i].length;
+	return(n);
+}
+
+
+static void tick(void) {
+	host_advance(TICK_MS);
+	check_CAN();
+	check_inbound();
+	send_CAN();
+	if (busRunning) {
+		unsigned from = hostCANSentCnt;
+		host_can_bus(100);
+		worstTick = max(worstTick, (int) frames_to_terminal(from));
+		}
+}
+
+
+static void ask(const char *cmd) {
+	char    line[20];
+	uint8_t me = NMEA2000.GetN2kSource();
+
+	snprintf(line, sizeof(line), "$%s\r\n", cmd);
+	assert(host_can_receive((7UL << 26) | ((0x17E00UL | me) << 8) | TERM_SOURCE, true, strlen(line), (uint8_t *) line) >= 0);
+}
+
+
+// Ask for all the status strings every 'everyMS' for 'secs' seconds, and see what came back.
+static void run(unsigned everyMS, int secs, unsigned long *generated, unsigned long *received, unsigned *dropped) {
+	unsigned      from      = hostCANSentCnt = 0;                  // (Start the record of frames sent over, so it holds them all)
+	unsigned long outBefore = Serial.outTotal;                      // (Every reply goes out the Serial port as well, in full)
+	uint16_t      drops     = CAN_ASCII_txDrops;
+
+	for (unsigned long t = 0; t < secs * 1000UL; t += TICK_MS) {
+		if (t % everyMS == 0)
+			ask("RAS:");
+		tick();
+		}
+	for (int i = 0; i < 200; i++)                                   // Let the last one finish going out
+		tick();
+
+	assert(hostCANSentCnt < HOST_CAN_SENT_MAX);
+	*generated = Serial.outTotal - outBefore;
+	*received  = chars_to_terminal(from);
+	*dropped   = CAN_ASCII_txDrops - drops;
+	printf("$RAS: every %4umS:  %6lu chars asked for, %6lu sent (%4lu/S), %5u dropped\n", everyMS, *generated, *received,
+	       *received * 1000UL / (secs * 1000UL + 200 * TICK_MS), *dropped);
+}
+
+
+int main() {
+	unsigned long generated, received;
+	unsigned      dropped;
+
+	alternatorState = bulk_charge;
+	initialize_CAN();
+	for (int i = 0; i < 300; i++)
+		tick();
+
+
+	// Requests the Terminal can keep up with (386 chars every 400mS is ~970/S):  nothing lost, and within the bus share.
+	worstTick = 0;
+	unsigned long start = millis();
+	run(400, 10, &generated, &received, &dropped);
+	assert(dropped == 0);
+	assert(received == generated);
+	assert(worstTick <= (int) cASCII_TX_FRAMES_MAX);                                // No more than its share in any one call,
+	assert(frames_to_terminal(0) * CAN_FRAME_BUS_TIME * 100UL <= (millis() - start) * 1000UL * cASCII_BUS_LOAD_MAX);   // or over time
+
+
+	// Far more than it can send:  some lost, but every one of them counted.
+	run(100, 10, &generated, &received, &dropped);
+	assert(dropped > 0);
+	assert(received + dropped == generated);
+
+
+	// The bus stalls in the middle of a reply:  the Terminal stops short of filling the NMEA2000 send buffer, so the regular
+	// messages can still be queued, and the rest of the reply goes once the bus is back.
+	Serial.clear();
+	unsigned from = hostCANSentCnt = 0;
+	busRunning = false;
+	ask("RAS:");
+	uint8_t leastFree = 0xFF;
+	for (int i = 0; i < 30; i++) {
+		tick();
+		leastFree = min(leastFree, NMEA2000.GetCANSendFrameBufFree());
+		}
+	printf("Bus stalled 300mS:  no less than %u frames free in the send buffer\n", leastFree);
+	assert(leastFree > 0);
+	busRunning = true;
+	for (int i = 0; i < 200; i++)
+		tick();
+	assert(chars_to_terminal(from) == strlen(Serial.out));
+
+	return 0;
+}
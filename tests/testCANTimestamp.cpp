@@ -0,0 +1,74 @@
+// Arrival times, run for real (see SimRegulator.h):  a Remote Battery Master's frames are replayed onto the bus at known times and
+// parsed late by varying amounts.  The time a handler sees (N2kMsg.MsgTime, here CAN_RBM_voltsRefreshed) must be when the frame came
+// off the bus, not when it was parsed - and once a frame could have waited longer than the CAN timer takes to wrap (~524mS), it must
+// never be taken as newer than it is.
+#define SIM_SYSTEMCAN
+#include "SimRegulator.h"
+
+#define TICK_MS      10UL
+#define RBM_SOURCE   0x30
+#define RBM_DEVPRI   200
+
+
+static void to_bus(tN2kMsg &msg) {
+	uint32_t id = ((uint32_t) msg.Priority << 26) | (msg.PGN << 8) | RBM_SOURCE;
+	assert(msg.DataLen <= 8);
+	assert(host_can_receive(id, true, msg.DataLen, msg.Data) >= 0);
+}
+
+static void from_RBM(uint32_t mV) {                             // DC Status 1 and 5 go out on the bus from the remote master
+	tN2kMsg msg;
+
+	SetRVCDCSourceStatus1(msg, batteryInstance, RBM_DEVPRI, 0, 0x77359400);
+	to_bus(msg);
+	SetRVCDCSourceStatus5(msg, batteryInstance, RBM_DEVPRI, mV, 32000);
+	to_bus(msg);
+}
+
+
+static void tick(void) {
+	host_advance(TICK_MS);
+	check_CAN();
+	send_CAN();
+	host_can_bus(50);
+}
+
+
+int main() {
+	alternatorState = bulk_charge;
+	measuredAltVolts = 13.2;
+	initialize_CAN();
+	for (int i = 0; i < 300; i++)                                   // Address claim
+		tick();
+	for (int i = 0; i < 120; i++) {                                 // Long enough to be trusted as the master
+		from_RBM(13250);
+		for (int t = 0; t < 10; t++)
+			tick();
+		}
+	assert(CAN_RBM_sourceID == RBM_SOURCE);
+
+
+	// Replay:  a pair of frames, then some time before they are parsed.  (Not so long the master is given up on, REMOTE_CAN_MASTER_TIMEOUT)
+	static const unsigned long parseDelay[] = { 0, 1, 7, 10, 50, 120, 200, 333, 400, 480, 510, 523, 530, 600, 650, 690 };
+	srand(37);
+	for (int pass = 0; pass < 20; pass++)
+		for (unsigned d = 0; d < sizeof(parseDelay) / sizeof(parseDelay[0]); d++) {
+			hostMicros += rand() % 1000;                            // (Arrivals anywhere within the mS)
+			unsigned long arrived = millis();
+			from_RBM(13000 + d);
+			hostMicros += parseDelay[d] * 1000UL;
+			check_CAN();
+			unsigned long seen = CAN_RBM_voltsRefreshed;
+
+			if (pass == 0)
+				printf("Parsed %4lumS late:  seen as %4ldmS old\n", parseDelay[d], (long) (millis() - seen));
+			assert(CAN_RBM_mVolts == 13000 + d);
+			assert((long) (seen - arrived) <= 1);                   // Never newer than it really is
+			if (parseDelay[d] + 1 < CAN_TIMER_WRAP_MS)
+				assert((long) (arrived - seen) <= 1);           // And, while the CAN timer can tell, just as old
+			for (int t = 0; t < 5; t++)
+				tick();
+			}
+
+	return 0;
+}
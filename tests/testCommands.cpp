@@ -0,0 +1,266 @@
+// check_inbound()'s table lookup against the if-chain it replaced.  old_check_inbound() below is that chain's tests on ibBuf[] as they
+// were, each calling the handler its code was moved into.  Every command (and some near misses) goes through both, with the system
+// unlocked and locked out, and in and out of pending_R;  both must leave the regulator in the same state and send back the same
+// characters.  Then each command once more wrapped in RV-C Terminal frames off the CAN bus, which must act the same as the Serial port.
+#define SIM_SYSTEMCAN
+#include "SimRegulator.h"
+
+#define TICK_MS      10UL                       // loop() comes around about this often
+#define TERM_SOURCE  0x20                       // CAN address of the 'Terminal' sending us the commands
+
+
+static const char *const commands[] = {
+	"CCN:0,2,3,1,1,1,1,0",  "CCR:",
+	"CPA:7,14.2,60,5,1.5",  "CPB:7,0.004,10,-10,50",  "CPE:7,15.0,10,60,5",  "CPF:7,13.5,-1,100,-20,-10,12.8",
+	"CPO:7,5,30,14.8,0",    "CPP:8,100,12.6,-10",     "CPR:7",
+	"EBA:12.5",             "EDB:1",                  "FRM:F",                "MSR:",
+	"RAS:",                 "RBT:",                   "RCP:1",
+	"SCA:0,95,1,0.75,0.5,-1,100,2000,2000,0,600",     "SCN:0,TESTNAME,4321",  "SCO:3,1.0,0,0",  "SCR:",  "SCT:12,3.0,-1,0"
+	};
+#define NUM_COMMANDS  (sizeof(commands) / sizeof(commands[0]))
+
+static const char *const nearMisses[] = {       // Close to a command, but not one (or one with bad arguments)
+	"CPX:7,14.2",  "CCX:",  "SCX:1",  "RBX:",  "RXX:",  "EBX:1",  "EDX:1",  "MSX:",  "FRX:F",  "XYZ:",  "ABC:",  "ZZZ:",
+	"cpa:7,14.2,60,5,1.5",  "CPA7,14.2,60,5,1.5",  "CP:7,14.2",  "CPA:9,14.2,60,5,1.5",  "CPA:1,14.2,60,5,1.5",
+	"CPA:7,99,60,5,1.5",    "RCP:0",  "RCP:9",  "RCP:",  "FRM:Z",  "FRM:",  "EBA:",  "SCO:9,1.0,0,0"
+	};
+#define NUM_NEAR_MISSES  (sizeof(nearMisses) / sizeof(nearMisses[0]))
+
+static const char *const laterCommands[] = {    // Added to the table since the if-chain went, so have no old form to compare with
+	"PGA", "PGL", "PGR", "PGT", "PGV", "PGW"        //   (See testPIDGains)
+	};
+#define NUM_LATER_COMMANDS  (sizeof(laterCommands) / sizeof(laterCommands[0]))
+
+
+typedef struct {                                // Everything a command might change
+	SCS      sc;
+	CCS      cc;
+	PIDS     pg;
+	uint8_t  eeprom[HOST_EEPROM_SIZE];
+	tModes   mode;
+	float    batAmps;
+	bool     extAmps;
+	bool     debug;
+	int      reboots;
+	} tState;
+
+static tState baseline;
+static char   canReply[HOST_SERIAL_SIZE + 1];
+
+
+static void snapshot(tState *s) {
+	memset(s, 0, sizeof(*s));
+	s->sc      = systemConfig;
+	s->cc      = canConfig;
+	s->pg      = pidGains;
+	memcpy(s->eeprom, hostEEPROM, sizeof(s->eeprom));
+	s->mode    = alternatorState;
+	s->batAmps = measuredBatAmps;
+	s->extAmps = usingEXTAmps;
+	s->debug   = sendDebugString;
+	s->reboots = hostReboots;
+}
+
+
+static void restore(const tState *s) {
+	systemConfig    = s->sc;
+	canConfig       = s->cc;
+	pidGains        = s->pg;
+	memcpy(hostEEPROM, s->eeprom, sizeof(hostEEPROM));
+	alternatorState = s->mode;
+	measuredBatAmps = s->batAmps;
+	usingEXTAmps    = s->extAmps;
+	sendDebugString = s->debug;
+	hostReboots     = s->reboots;
+}
+
+
+static bool same(const tState *a, const tState *b) {
+	return((memcmp(&a->sc, &b->sc, sizeof(a->sc)) == 0) && (memcmp(&a->cc, &b->cc, sizeof(a->cc)) == 0) &&
+	       (memcmp(&a->pg, &b->pg, sizeof(a->pg)) == 0) && (memcmp(a->eeprom, b->eeprom, sizeof(a->eeprom)) == 0) &&
+	       (a->mode == b->mode) && (a->batAmps == b->batAmps) && (a->extAmps == b->extAmps) &&
+	       (a->debug == b->debug) && (a->reboots == b->reboots));
+}
+
+
+static void old_check_inbound(void) {           // check_inbound() as it was, dispatching by an if-chain on the mnemonic
+	if (fill_ib_buffer() == true) {
+		if (ibBuf[3] != ':')    return;
+
+		if (alternatorState == pending_R)
+			set_ALT_mode(pending_R);
+
+		if (ibBuf[0] == 'R') {
+			if ((ibBuf[1] == 'B') && (ibBuf[2] == 'T'))  cmd_RBT();
+			if ((ibBuf[1] == 'C') && (ibBuf[2] == 'P')) { cmd_RCP(); return; }
+			if ((ibBuf[1] == 'A') && (ibBuf[2] == 'S')) { cmd_RAS(); return; }
+			}
+
+		if ((ibBuf[0] == 'C') && (ibBuf[1] == 'P')) { cmd_CP(); return; }     // (The old switch on ibBuf[2] now lives in cmd_CP(), and
+		if ((ibBuf[0] == 'S') && (ibBuf[1] == 'C')) { cmd_SC(); return; }     //  cmd_SC() / cmd_CC() - its default was to do nothing)
+		#ifdef SYSTEMCAN
+		if ((ibBuf[0] == 'C') && (ibBuf[1] == 'C')) { cmd_CC(); return; }
+		#endif
+
+		if ((ibBuf[0] == 'E') && (ibBuf[1] == 'B') && (ibBuf[2] == 'A')) { cmd_EBA(); return; }
+		if ((ibBuf[0] == 'E') && (ibBuf[1] == 'D') && (ibBuf[2] == 'B'))   cmd_EDB();
+		if ((ibBuf[0] == 'M') && (ibBuf[1] == 'S') && (ibBuf[2] == 'R'))   cmd_MSR();
+		if ((ibBuf[0] == 'F') && (ibBuf[1] == 'R') && (ibBuf[2] == 'M')) { cmd_FRM(); return; }
+		}
+}
+
+
+static void tick(void (*dispatch)(void)) {      // The CAN and command parts of one loop() pass, and the bus sends what it can.
+	host_advance(TICK_MS);
+	check_CAN();
+	dispatch();
+	send_CAN();
+	host_can_bus(50);
+}
+
+
+static void collect_replies(unsigned from) {    // Pull the characters out of any Terminal frames sent back to TERM_SOURCE
+	unsigned n = 0;
+
+	for (unsigned i = from; (i < hostCANSentCnt) && (i < HOST_CAN_SENT_MAX); i++) {
+		const tHostCANFrame &f = hostCANSent[i];
+		if (((f.id >> 8) & 0x1FFFF) != (0x17E00 | TERM_SOURCE))
+			continue;
+		for (int j = 0; (j < f.length) && (n < HOST_SERIAL_SIZE); j++)
+			canReply[n++] = f.data[j];
+		}
+	canReply[n] = 0;
+}
+
+
+static void via_serial(const char *cmd, void (*dispatch)(void) = check_inbound) {
+	static char line[100];
+
+	snprintf(line, sizeof(line), "$%s\r\n", cmd);
+	Serial.clear();
+	Serial.in = line;
+	for (int i = 0; i < 100; i++)
+		tick(dispatch);
+	Serial.in = NULL;
+}
+
+
+static void via_CAN(const char *cmd) {
+	char     line[100];
+	uint8_t  me = NMEA2000.GetN2kSource();
+	uint32_t id = (7UL << 26) | ((0x17E00UL | me) << 8) | TERM_SOURCE;
+	unsigned from = hostCANSentCnt = 0;               // (Start the record of frames sent over, so it holds them all)
+
+	snprintf(line, sizeof(line), "$%s\r\n", cmd);
+	Serial.clear();
+	for (size_t i = 0; i < strlen(line); i += 8) {   // 8 characters to a frame, a frame each pass
+		uint8_t len = min(strlen(line) - i, (size_t) 8);
+		assert(host_can_receive(id, true, len, (const uint8_t *) line + i) >= 0);
+		tick(check_inbound);
+		}
+	for (int i = 0; i < 100; i++)                   // Give the reply time to go out
+		tick(check_inbound);
+	collect_replies(from);
+}
+
+
+static void compare(const char *cmd, bool mustChange) {       // The old chain and the table, from the same starting state
+	tState   afterOld, afterTable;
+	char     oldReply[HOST_SERIAL_SIZE + 1];
+
+	snapshot(&baseline);
+	via_serial(cmd, old_check_inbound);
+	snapshot(&afterOld);
+	strcpy(oldReply, Serial.out);
+	restore(&baseline);
+
+	via_serial(cmd, check_inbound);
+	snapshot(&afterTable);
+	restore(&baseline);
+
+	assert(same(&afterOld, &afterTable));
+	assert(strcmp(oldReply, Serial.out) == 0);
+	if (mustChange)
+		assert(!same(&afterTable, &baseline) || (strlen(Serial.out) > 0));
+}
+
+
+int main() {
+	tState   afterSerial, afterCAN;
+	char     serialReply[HOST_SERIAL_SIZE + 1];
+
+	for (unsigned i = 1; i < NUM_INBOUND_COMMANDS; i++)            // The binary search needs the table sorted
+		assert(strcmp(inboundCommands[i-1].cmd, inboundCommands[i].cmd) < 0);
+
+	for (unsigned c = 0; c < NUM_INBOUND_COMMANDS; c++) {          // And each one in it is tested below (or is new)
+		bool found = false;
+
+		for (unsigned i = 0; i < NUM_COMMANDS; i++)
+			found |= (strncmp(inboundCommands[c].cmd, commands[i], 3) == 0);
+		for (unsigned i = 0; i < NUM_LATER_COMMANDS; i++)
+			found |= (strncmp(inboundCommands[c].cmd, laterCommands[i], 3) == 0);
+		assert(found);
+		}
+
+	alternatorState = bulk_charge;
+	initialize_CAN();
+	for (int i = 0; i < 300; i++)                                   // Let the address claim finish
+		tick(check_inbound);
+
+	via_serial("CCN:5,3,90,0,1,1,1,0");                             // Something saved for the restore commands to take away
+	via_serial("CPA:7,14.6,120,4,0.5");
+	via_serial("SCO:2,1.5,0,0");
+	snapshot(&baseline);
+	tState saved = baseline;
+
+
+	for (int lockout = 0; lockout <= 2; lockout++)                  // Old chain vs table
+		for (int pending = 0; pending <= 1; pending++) {
+			restore(&saved);
+			systemConfig.CONFIG_LOCKOUT = lockout;
+			alternatorState = pending ? pending_R : bulk_charge;
+
+			for (unsigned c = 0; c < NUM_COMMANDS; c++)
+				compare(commands[c], (lockout == 0));
+			for (unsigned c = 0; c < NUM_NEAR_MISSES; c++)
+				compare(nearMisses[c], false);
+			}
+	restore(&saved);
+	baseline = saved;
+	printf("%u commands and %u near misses act the same through the table as the old if-chain\n",
+		(unsigned) NUM_COMMANDS, (unsigned) NUM_NEAR_MISSES);
+
+
+	for (unsigned c = 0; c < NUM_COMMANDS; c++) {                  // Serial vs CAN Terminal
+		const char *cmd = commands[c];
+
+		via_serial(cmd);
+		snapshot(&afterSerial);
+		strcpy(serialReply, Serial.out);
+		restore(&baseline);
+
+		via_CAN(cmd);
+		snapshot(&afterCAN);
+		restore(&baseline);
+
+		printf("%-44s  %3u chars back\n", cmd, (unsigned) strlen(serialReply));
+		assert(same(&afterSerial, &afterCAN));
+		assert(strcmp(serialReply, canReply) == 0);
+		assert((strlen(serialReply) > 0) || (strncmp(cmd, "RBT", 3) == 0));            // (Everything but a reboot says something back)
+		if ((strncmp(cmd, "RAS", 3) != 0) && (strncmp(cmd, "RCP", 3) != 0))     // (Those two only send something back)
+			assert(!same(&afterSerial, &baseline));
+		}
+
+	via_serial("CPA:7,14.2,60,5,1.5");                              // A space after the Charge Profile index works as well as a comma
+	snapshot(&afterSerial);
+	restore(&baseline);
+	via_serial("CPA:7 14.2,60,5,1.5");
+	snapshot(&afterCAN);
+	restore(&baseline);
+	assert(same(&afterSerial, &afterCAN));
+	via_CAN("CPA:7 14.2,60,5,1.5");
+	snapshot(&afterCAN);
+	assert(same(&afterSerial, &afterCAN));
+
+	return 0;
+}
@@ -0,0 +1,157 @@
+// The real manage_ALT() (see SimPlant.h) with FIELD_FEED_FORWARD, in an Amps limited Bulk charge while the engine speed changes.
+// The feed-forward map is learned while driving around at a few speeds, and then the engine is throttled back and brought up
+// again.  With the map the Amps should get back to target sooner after the throttle back, and with no more overshoot either way,
+// than with the PID alone.  (Which is what the regulator does when it cannot see the RPMs)  The map only takes the Field to
+// FF_SEED_MARGIN short of where it puts it, so it is the PID that closes in on the target.  Once in Acceptance, with the Volts loop
+// in control, the map is left alone:  the Field only comes up PWM_CHANGE_CAP at a time.
+#define FIELD_FEED_FORWARD
+#include "SimPlant.h"
+
+#define TARGET_AMPS         80.0
+
+typedef struct {
+	tPlantSpec spec;                        // A large, well down, battery:  never gets near the target voltage here
+	double     cutIn, kRPMs;                // Alternator Amps per Field step:  ampsPerStep * (1 - e^-((rpm - cutIn) / kRPMs))
+	} tCase;
+
+static const tCase cases[] = {
+	{ { 1.00, 130.0, 0.15, 0.003, 0.0, 1.0, 12.9, 0.0, 0.0, 0.0 }, 500, 800 },
+	{ { 0.70, 100.0, 0.15, 0.002, 0.0, 1.0, 12.7, 0.0, 0.0, 0.0 }, 400, 600 },
+	};
+
+
+typedef struct {                                // Engine speed schedule: move to rpm over rampMS, and hold there until atMS
+	long atMS;
+	int  rpm;
+	long rampMS;
+	} tLeg;
+
+static const tLeg drive[] = {                   // Drive around for a while to learn the map ..
+	{  60000, 1500, 1000 },
+	{ 100000, 2000, 1000 },
+	{ 140000,  900, 1500 },
+	{ 180000, 2500, 2000 },
+	{ 220000, 1200, 1500 },
+	{ 260000, 2000, 1000 },
+	{ 300000,  900,  700 },                 // .. then throttle back (the one we look at) ..
+	{ 340000, 2000,  700 },                 // .. and bring it back up.
+	};
+#define THROTTLE_BACK_AT   260000L
+#define BRING_UP_AT        300000L
+#define RUN_FOR            340000L
+#define ACCEPT_AT          240000L              // (Into Acceptance, a little under the Volts the battery is at, for the 'accept' runs)
+
+
+static double plant_speed(const tCase *c, double rpm) {
+	return((rpm <= c->cutIn) ? 0 : 1 - exp(-(rpm - c->cutIn) / c->kRPMs));
+}
+
+
+static double rpm_at(long ms) {
+	double from = 1500;
+	long   start = 0;
+	for (unsigned i = 0; i < sizeof(drive) / sizeof(drive[0]); i++) {
+		if (ms < drive[i].atMS) {
+			double f = (double) (ms - start) / drive[i].rampMS;
+			return((f >= 1.0) ? drive[i].rpm : from + (drive[i].rpm - from) * f);
+			}
+		from  = drive[i].rpm;
+		start = drive[i].atMS;
+		}
+	return(from);
+}
+
+
+typedef struct {
+	double recover;                         // Seconds after the throttle back to get within 5% of TARGET_AMPS (and stay)
+	double overDown, overUp;                // Highest Amps over target after the throttle back, and after bringing it back up
+	int    jump;                            // Biggest move up of the Field in one go, after the throttle back
+	} tResult;
+
+
+typedef struct {
+	int  which;
+	bool feedForward;                       // Let the regulator see the RPMs
+	bool accept;                            // Go into Acceptance before the throttle back
+	} tRun;
+
+static tResult run(tRun g) {
+	const tCase *c = &cases[g.which];
+	tResult r = { 0, 0, 0, 0 };
+	tPlant  p;
+	long    lastOut = THROTTLE_BACK_AT;
+	int     priorPWM;
+
+	targetBatVolts = 14.4;
+	targetAltAmps  = TARGET_AMPS;
+	targetAltWatts = 15000;
+	workingParms.EXIT_ACPT_DURATION = 0;                                    // (Stay in Acceptance)
+	workingParms.EXIT_ACPT_AMPS     = 0;
+	workingParms.EXIT_ACPT_DIDT     = 0;
+	plant_start(&p, &c->spec, 0);
+	set_ALT_mode(bulk_charge);
+
+	for (long t = 0; t < RUN_FOR * 1000L / (long) PLANT_TICK_US; t++) {
+		long ms = t * PLANT_TICK_US / 1000L;
+		double rpm   = rpm_at(ms);
+		measuredRPMs = g.feedForward ? (int) rpm : 0;
+		p.speed      = plant_speed(c, rpm);
+		if (g.accept && (ms == ACCEPT_AT) && (alternatorState == bulk_charge)) {
+			targetBatVolts = p.volts - 0.1;
+			set_ALT_mode(acceptance_charge);
+			}
+		priorPWM = fieldPWMvalue;
+		plant_tick(&p);
+		if (ms >= THROTTLE_BACK_AT)
+			r.jump = max(r.jump, fieldPWMvalue - priorPWM);
+
+		if ((ms >= THROTTLE_BACK_AT) && (ms < BRING_UP_AT)) {
+			if (fabs(p.amps - TARGET_AMPS) > TARGET_AMPS * 0.05)
+				lastOut = ms;
+			r.overDown = fmax(r.overDown, p.amps - TARGET_AMPS);
+			}
+		if (ms >= BRING_UP_AT)
+			r.overUp = fmax(r.overUp, p.amps - TARGET_AMPS);
+		}
+
+	r.recover = (lastOut - THROTTLE_BACK_AT) / 1000.0;
+	return(r);
+}
+
+
+int main() {
+	tFFMap m = { { 0 } };
+
+	// Map basics:  nothing until learned, 1st reading taken as is, then blended in 1/FF_LEARN_WEIGHT at a time.
+	assert(ff_pwm(&m, 1000, 50) == -1);
+	ff_learn(&m, 1000, 50, 100);                                    // 0.5A per step at 1000-1249 RPM
+	assert(ff_pwm(&m, 1100, 50) == 100);
+	assert(ff_pwm(&m, 1300, 50) == -1);                              // Next range up is not known yet
+	ff_learn(&m, 1200, 90, 100);                                    // 0.9A per step
+	assert(fabs(m.ampsPerStep[4] - (0.5f + 0.4f / FF_LEARN_WEIGHT)) < 0.0001f);
+	ff_learn(&m, 9000, 120, 100);                                   // Way up there goes into the last range
+	assert(m.ampsPerStep[FF_RPM_BINS - 1] == 1.2f);
+	assert(ff_pwm(&m, 5000, 60) == 50);
+	ff_learn(&m, 0, 50, 100);                                       // No RPMs, no Field, or no Amps:  nothing learned
+	ff_learn(&m, 500, 50, 0);
+	ff_learn(&m, 500, 0, 100);
+	assert(m.ampsPerStep[2] == 0);
+
+
+	for (int i = 0; i < (int) (sizeof(cases) / sizeof(cases[0])); i++) {
+		tResult b = sim_fresh(run, (tRun) { i, false, false });
+		tResult f = sim_fresh(run, (tRun) { i, true,  false });
+		tResult a = sim_fresh(run, (tRun) { i, true,  true  });
+
+		printf("Plant %d:  throttle back, back on target in %4.1f / %4.1f S  overshoot %4.1f / %4.1f A   bring up overshoot %4.1f / %4.1f A\n",
+		       i + 1, b.recover, f.recover, b.overDown, f.overDown, b.overUp, f.overUp);
+
+		assert(f.recover  < b.recover * 0.6);
+		assert(f.overDown <= b.overDown);
+		assert(f.overUp   <= b.overUp);
+		assert(f.jump     >  PWM_CHANGE_CAP);                           // (The map was used in Bulk ..
+		assert(a.jump     <= PWM_CHANGE_CAP);                           //  .. but not in Acceptance)
+		}
+
+	return 0;
+}
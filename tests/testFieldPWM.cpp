@@ -0,0 +1,124 @@
+// The real manage_ALT() (see SimPlant.h) with FIELD_PWM_FINE, holding a large alternator on a battery at the target voltage while the
+// house load wanders.  One whole PWM step is ~24mV of battery voltage here, so with 1/4 steps the voltage should stay well within that -
+// and ripple less than the same run in whole steps, which the README also builds as testFieldPWMWhole (-DWHOLE_STEPS).
+// And the Field should only ever be in 1/4 steps when the PID is driving it:  the load-dump pull-back keeps the fraction, and turning
+// the alternator off clears it.
+#ifndef WHOLE_STEPS
+#define FIELD_PWM_FINE
+#endif
+#include "SimPlant.h"
+
+static const tPlantSpec plant = {                 // A large alternator (~1.2A per step) on a battery + house load seen as a simple
+	300.0 / FIELD_PWM_MAX, 300.0, 0.3,        //  Thevenin source
+	0.02, 0.0, 1.0, 14.1, 0.0,
+	0.0025, 0.5 };
+
+#define TARGET_VOLTS        14.4
+#define LOAD_AMPS           20.0                //  House loads wander slowly, so the loop has to keep following them
+#define LOAD_SWING          10.0
+#define LOAD_PERIOD         60.0                //  (S)
+#define SETTLE_S             100
+#define RUN_S                300
+
+
+static void run_for(tPlant *p, long ms) {
+	for (long t = 0; t < ms * 1000L / (long) PLANT_TICK_US; t++)
+		plant_tick(p);
+}
+
+
+typedef struct {
+	double rms, pp, mean;                   // Volts off target (RMS), peak-to-peak and mean, once settled
+	long   fractions, n;                    // Plant ticks spent in a 1/4 step, of n
+	} tRipple;
+
+static tRipple steady(tPlant *p) {
+	tRipple r;
+	double vMin = 100, vMax = 0, vSum = 0, vSq = 0;
+	long   n = 0, fractions = 0;
+
+	targetBatVolts = TARGET_VOLTS;
+	targetAltAmps  = 500;
+	targetAltWatts = 15000;
+	set_ALT_mode(forced_float_charge);                                      // (Just hold the target voltage)
+	plant_start(p, &plant, LOAD_AMPS);
+
+	for (long t = 0; t < RUN_S * 1000000L / (long) PLANT_TICK_US; t++) {
+		double secs = t * PLANT_TICK_US / 1000000.0;
+		p->load = LOAD_AMPS + LOAD_SWING * sin(secs * 2 * M_PI / LOAD_PERIOD);
+		plant_tick(p);
+		if (secs >= SETTLE_S) {
+			vMin = fmin(vMin, p->volts);
+			vMax = fmax(vMax, p->volts);
+			vSum += p->volts;
+			vSq  += (p->volts - TARGET_VOLTS) * (p->volts - TARGET_VOLTS);
+			n++;
+			fractions += (fieldPWMfraction != 0);
+			}
+		}
+
+	r.rms       = sqrt(vSq / n);
+	r.pp        = vMax - vMin;
+	r.mean      = vSum / n;
+	r.fractions = fractions;
+	r.n         = n;
+	return(r);
+}
+
+
+int main(int argc, char *argv[]) {
+	tPlant p;
+
+	srand(41);
+	tRipple r = steady(&p);
+	if (sim_result(argc, argv, r))
+		return(0);
+
+	double step = plant.ampsPerStep * plant.r0;
+	printf("steady-state, %s:  %.1f mV RMS off target, %.1f mV peak-to-peak (one whole PWM step is %.1f mV), mean %.4fV, in a 1/4 step %ld%% of the time\n",
+	       (FIELD_PWM_STEPS > 1) ? "1/4 steps" : "whole steps", r.rms * 1000, r.pp * 1000, step * 1000, r.mean, r.fractions * 100 / r.n);
+  #ifndef FIELD_PWM_FINE
+	printf("All tests passed.  (Whole steps only, testFieldPWM compares)\n");
+	return(0);
+  #else
+	tRipple w = sim_other_build<tRipple>(argv[0], "Whole");
+	printf("steady-state, whole steps:  %.1f mV RMS off target, %.1f mV peak-to-peak\n", w.rms * 1000, w.pp * 1000);
+	assert(w.fractions == 0);
+	assert(r.rms < step / 2);
+	assert(fabs(r.mean - TARGET_VOLTS) < step / 4);
+	assert(r.rms < w.rms / 2);                                              // 1/4 steps:  ripple well down on whole steps
+	assert(r.pp  < w.pp);
+	assert(fabs(r.mean - TARGET_VOLTS) < fabs(w.mean - TARGET_VOLTS));
+	assert(r.fractions > r.n / 4);
+
+
+	// Load dump:  LD1 cuts the Field in 1/4 steps too.  (Just changed, so the PID itself leaves it be this time)
+	set_ALT_PWM(100, 3);
+	updatingVAs      = false;
+	measuredAltVolts = measuredBatVolts = TARGET_VOLTS + LD1_THRESHOLD + 0.010;
+	manage_ALT();
+	assert(((long) fieldPWMvalue * FIELD_PWM_STEPS + fieldPWMfraction) == (long) (403 * LD1_PULLBACK));
+	measuredAltVolts = measuredBatVolts = TARGET_VOLTS;
+	run_for(&p, 20000);
+
+
+	// Turning off the alternator leaves no 1/4 step behind, in each of the ways it is forced off.
+	static const tModes offModes[] = { post_float, disabled, unknown, pending_R };
+	for (unsigned i = 0; i < sizeof(offModes) / sizeof(offModes[0]); i++) {
+		set_ALT_mode(forced_float_charge);
+		for (int t = 0; (t < 100000) && (fieldPWMfraction == 0); t++)
+			plant_tick(&p);
+		assert(fieldPWMfraction != 0);
+
+		set_ALT_mode(offModes[i]);
+		workingParms.EXIT_PF_DURATION = 0;                              // (Stay in Post-Float)
+		workingParms.PF_TO_BULK_VOLTS = 0;
+		run_for(&p, 1000);
+		printf("Forced off (mode %d):  Field %d + %d/%d\n", offModes[i], fieldPWMvalue, fieldPWMfraction, FIELD_PWM_STEPS);
+		assert((fieldPWMvalue == FIELD_PWM_MIN) && (fieldPWMfraction == 0));
+		assert(plant_field() == FIELD_PWM_MIN);                          // (What is going out to the Field)
+		}
+
+	printf("All tests passed.\n");
+  #endif
+}
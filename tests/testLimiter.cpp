@@ -0,0 +1,159 @@
+// Which limit is holding the Field back:  the real calculate_ALT_targets() and manage_ALT() (see SimPlant.h) run through a set of
+// charging situations that should each be held by a different one of its Volts, Amps, Watts and Alt temperature loops, the Ramp, full
+// Field, or a de-rating (of the Field cap at idle RPMs, or of the Amps in Small Alt mode).  limiter_of() should pick the right one,
+// limiter_count() should account for all the time, and the LST; string carry the totals out.
+#include "SimPlant.h"
+
+#define AMBIENT             30.0                // Alternator temperature:  rises 0.8 deg per Amp over this,
+#define TEMP_TAU            30.0                //  with this time constant (S)  (Squeezed down, so the test does not take all day)
+
+typedef struct {
+	const char *name;
+	double      ocv;                        // Battery (and house loads) seen as a simple voltage source
+	float       acptV;                      // The targets, as calculate_ALT_targets() works them out from the Acceptance volts,
+	int         altCap;                     //  the Alternator size (altCapAmps, 0 = no Amps limit),
+	int         wattsLimit;                 //  ALT_WATTS_LIMIT (0 = none),
+	bool        small;                      //  Small Alt mode,
+	int         rpms, pullback;             //  and the idle pull-back:  measuredRPMs and ALT_PULLBACK_FACTOR (-1 = none) with ALT_IDLE_RPM 800
+	int         tempSetpoint;
+	double      speed;                      // Alternator output per PWM step, as a fraction of the full speed one
+	long        seconds;
+	tModes      mode;
+	uint8_t     expect;
+	} tScenario;
+
+static const tScenario scenarios[] = {
+	{ "Volts  (Acceptance)", 14.20, 14.4,   0,   0, false,    0, -1, 130, 1.0,  120, acceptance_charge, LIM_VOLTS     },
+	{ "Amps   (Bulk)",       12.60, 14.4,  60,   0, false,    0, -1, 130, 1.0,  120, bulk_charge,       LIM_AMPS      },
+	{ "Watts  (engine)",     12.60, 14.4,   0, 700, false,    0, -1, 130, 1.0,  120, bulk_charge,       LIM_WATTS     },
+	{ "Alt temp",            12.60, 14.4,   0,   0, false,    0, -1,  90, 1.0,  900, bulk_charge,       LIM_ALT_TEMP  },
+	{ "Ramp",                12.60, 14.4,   0,   0, false,    0, -1, 130, 1.0,   12, ramping,           LIM_RAMP      },
+	{ "Full Field",          12.60, 14.4,   0,   0, false,    0, -1, 130, 0.4,  120, bulk_charge,       LIM_FIELD_MAX },
+	{ "De-rate (idle RPMs)", 12.60, 14.4,   0,   0, false, 1000, 10, 130, 0.4,  120, bulk_charge,       LIM_DERATE    },
+	{ "De-rate (Small Alt)", 12.60, 14.4, 100,   0, true,     0, -1, 130, 1.0,  120, bulk_charge,       LIM_DERATE    },
+	};
+
+typedef struct {
+	double        share;                    // Of the watched part of the run the expected limiter was in control
+	unsigned long times[LIMITERS];          // limiterTime[] at the end
+	} tResult;
+
+
+// Runs one scenario from a cold start, working out the targets each time round the way loop() does.  Watches the 2nd half of the run
+// (the 1st half for the ramp, which is over by the end, so the run stops there).
+static tResult run(int which) {
+	const tScenario *sc = &scenarios[which];
+	static const tPlantSpec plant = { 0.55, 130.0, 0.15, 0.003, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0 };
+	tPlantSpec spec = plant;
+	tResult r;
+	tPlant  p;
+	unsigned long before[LIMITERS];
+	double  temp  = AMBIENT;
+	long    ticks = sc->seconds * 1000000L / (long) PLANT_TICK_US;
+	long    watch = (sc->expect == LIM_RAMP) ? 0 : ticks / 2;
+
+	spec.ocv       = sc->ocv;
+	workingParms.ACPT_BAT_V_SETPOINT = sc->acptV;
+	altCapAmps     = sc->altCap;
+	smallAltMode   = sc->small;
+	systemConfig.ALT_WATTS_LIMIT     = sc->wattsLimit;
+	systemConfig.ALT_PULLBACK_FACTOR = sc->pullback;
+	systemConfig.ALT_IDLE_RPM        = 800;
+	systemConfig.ALT_TEMP_SETPOINT   = sc->tempSetpoint;
+	workingParms.EXIT_ACPT_DURATION = 0;                                    // (Stay in Acceptance)
+	workingParms.EXIT_ACPT_AMPS     = 0;
+	plant_start(&p, &spec, 0);
+	p.speed = sc->speed;
+	set_ALT_mode(sc->mode);
+
+	for (long t = 0; t < ticks; t++) {
+		if (t == watch)
+			memcpy(before, limiterTime, sizeof(before));
+		if ((sc->expect == LIM_RAMP) && (t == ticks / 2))
+			break;
+
+		temp           += (AMBIENT + 0.8 * p.amps - temp) * (PLANT_TICK_US / 1000000.0) / TEMP_TAU;
+		measuredAltTemp = (int) temp;
+		measuredRPMs    = sc->rpms;
+		calculate_ALT_targets();
+		plant_tick(&p);
+		}
+
+	unsigned long all = 0;
+	for (int i = 0; i < LIMITERS; i++)
+		all += limiterTime[i] - before[i];
+	r.share = (double) (limiterTime[sc->expect] - before[sc->expect]) / all;
+	memcpy(r.times, limiterTime, sizeof(r.times));
+	return(r);
+}
+
+
+static char captured[128];
+static int  capturedLen;
+static void capture(char c) { captured[capturedLen++] = c;  captured[capturedLen] = '\0'; }
+
+
+int main() {
+	unsigned long times[LIMITERS];
+
+	// limiter_of():  smallest ask wins (1st on a tie), the Field cap only when the winner still wanted to go up, nothing if all want the
+	// full cap, and a de-rating if the winner (or the Field cap) had been de-rated.
+	int a1[] = { 1, -3,  0,  2,  2 };   assert(limiter_of(a1, 5, 2, false, 0) == LIM_AMPS);
+	int a2[] = { 0,  5,  0,  2,  2 };   assert(limiter_of(a2, 5, 2, false, 0) == LIM_VOLTS);
+	int a3[] = { 9,  5,  4,  0,  2 };   assert(limiter_of(a3, 5, 2, false, 0) == LIM_ALT_TEMP);
+	int a4[] = { 9,  5,  1,  2,  2 };   assert(limiter_of(a4, 5, 2, true,  0) == LIM_FIELD_MAX);
+	                                    assert(limiter_of(a4, 5, 2, false, 0) == LIM_WATTS);
+	int a5[] = { 0,  5,  4,  2,  2 };   assert(limiter_of(a5, 5, 2, true,  0) == LIM_VOLTS);       // At the cap, but Volts is holding it there anyway
+	int a6[] = { 7,  5,  4,  2,  2 };   assert(limiter_of(a6, 5, 2, false, 0) == LIM_NONE);
+	int a7[] = { 7,  5,  4,  2,  1 };   assert(limiter_of(a7, 5, 2, false, 0) == LIM_RAMP);
+	                                    assert(limiter_of(a1, 5, 2, false, 1 << LIM_AMPS)      == LIM_DERATE);
+	                                    assert(limiter_of(a1, 5, 2, false, 1 << LIM_WATTS)     == LIM_AMPS);
+	                                    assert(limiter_of(a4, 5, 2, true,  1 << LIM_FIELD_MAX) == LIM_DERATE);
+	                                    assert(limiter_of(a6, 5, 2, false, 1 << LIM_FIELD_MAX) == LIM_NONE);
+
+	// limiter_count():  adds up, and stops at the top of a 32 bit count instead of wrapping.
+	memset(times, 0, sizeof(times));
+	limiter_count(times, LIM_AMPS, 100);
+	limiter_count(times, LIM_AMPS, 150);
+	assert(times[LIM_AMPS] == 250);
+	times[LIM_WATTS] = 0xFFFFFFFFUL - 50;
+	limiter_count(times, LIM_WATTS, 100);
+	assert(times[LIM_WATTS] == 0xFFFFFFFFUL);
+	limiter_count(times, LIM_WATTS, 100);
+	assert(times[LIM_WATTS] == 0xFFFFFFFFUL);
+
+
+	// Each situation should be put down to the right limiter for just about all of the time once things settle, and every adjustment
+	// should be counted against someone.  (Give or take the 1st and last adjustments)
+	for (int i = 0; i < (int) (sizeof(scenarios) / sizeof(scenarios[0])); i++) {
+		const tScenario *sc = &scenarios[i];
+		unsigned long total = 0;
+
+		tResult r = sim_fresh(run, i);
+		for (int l = 0; l < LIMITERS; l++)
+			total += r.times[l];
+
+		printf("%-20s  %5.1f%% of the time   (V %lu  A %lu  W %lu  TA %lu  Rmp %lu  Fld %lu  Drt %lu  none %lu  S)\n", sc->name, r.share * 100,
+		       r.times[LIM_VOLTS] / 1000, r.times[LIM_AMPS] / 1000, r.times[LIM_WATTS] / 1000, r.times[LIM_ALT_TEMP] / 1000,
+		       r.times[LIM_RAMP] / 1000, r.times[LIM_FIELD_MAX] / 1000, r.times[LIM_DERATE] / 1000, r.times[LIM_NONE] / 1000);
+
+		unsigned long ran = (sc->expect == LIM_RAMP) ? sc->seconds * 500UL : sc->seconds * 1000UL;
+		assert(r.share >= 0.90);
+		assert((total <= ran + 2 * PWM_CHANGE_RATE) && (total + 2 * PWM_CHANGE_RATE >= ran));
+		}
+
+
+	// And out they go as LST;  (Limiter in control now, then minutes for each)
+	limiterInControl = LIM_AMPS;
+	memset(limiterTime, 0, sizeof(limiterTime[0]) * LIMITERS);
+	limiterTime[LIM_VOLTS]     = 125UL * 60000UL;
+	limiterTime[LIM_AMPS]      =  42UL * 60000UL + 59999UL;             // Whole minutes only
+	limiterTime[LIM_ALT_TEMP]  =   7UL * 60000UL;
+	limiterTime[LIM_RAMP]      =   3UL * 60000UL;
+	limiterTime[LIM_DERATE]    =  18UL * 60000UL;
+	limiterTime[LIM_NONE]      =  59999UL;
+	prep_LST(capture);
+	assert(strcmp(captured, "LST;,1, ,125,42,0,7,3,0,18,0\r\n") == 0);
+
+	return 0;
+}
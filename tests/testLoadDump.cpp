@@ -0,0 +1,106 @@
+// The real manage_ALT() (see SimPlant.h) with INA226_FAST_LOAD_DUMP, holding the target voltage on a 250A alternator carrying a 150A
+// house load.  Once settled, the INA226's single conversions are noisy enough that now and then one goes over LD1 on its own, which
+// should not trip the load-dump checks.  Then the load suddenly drops off:  fed by the short average of the latest conversions, the
+// checks should see the battery go over LD1 and pull the Field back within a few conversions - not after waiting out a 35mS 16x
+// averaged one.  The README also builds the test without INA226_FAST_LOAD_DUMP, as testLoadDumpTriggered (-DTRIGGERED_SAMPLING),
+// to run the same load drop with the triggered 16x sampling and compare.
+#ifndef TRIGGERED_SAMPLING
+#define INA226_FAST_LOAD_DUMP
+#endif
+#include "SimPlant.h"
+
+static const tPlantSpec plant = {                 // Battery:  open circuit volts, series resistance, and an RC 'surface charge' branch
+	250.0 / FIELD_PWM_MAX, 250.0, 0.10,
+	0.002, 0.006, 0.05, 13.9, 0.0,
+	0.015, 1.0 };
+
+#define TARGET_VOLTS        14.4
+#define LOAD_BEFORE        150.0
+#define DROP_AT           30000L                // mS
+#define SETTLE_AT         15000L                // (manage_ALT()'s 1st adjustment has no prior Volts for the D term, so it kicks the Field down)
+
+
+typedef struct {
+	double peak;                            // Highest battery volts after the drop
+	long   crossed, pulledBack;             // When (uS) it went over LD1, and when the Field was pulled back after that
+	long   singlesOver, cuts;               // Before the drop:  single conversions over LD1, and times the Field was cut
+	} tDrop;
+
+static tDrop load_drop(void) {
+	tPlant p;
+	tDrop  d = { 0, -1, -1, 0, 0 };
+	double fieldAtCross = 0, priorField;
+
+	srand(42);
+	targetBatVolts = TARGET_VOLTS;
+	targetAltAmps  = 500;
+	targetAltWatts = 15000;
+	plant_balance(&p, &plant, TARGET_VOLTS, LOAD_BEFORE);
+	set_ALT_mode(forced_float_charge);                                      // (Just hold the target voltage)
+  #ifdef INA226_FAST_LOAD_DUMP
+	assert(hostINA226[CONFIG_REG] == INA226_CONFIG_FAST);
+  #endif
+	priorField = plant_field();
+
+	for (long t = 0; t < (DROP_AT + 10000L) * 1000L / (long) PLANT_TICK_US; t++) {
+		long us = t * PLANT_TICK_US;
+		if (us >= DROP_AT * 1000L)
+			p.load = 0;
+		plant_tick(&p);
+
+		if (us < DROP_AT * 1000L) {
+			if (us < SETTLE_AT * 1000L) {
+				priorField = plant_field();
+				continue;
+				}
+			if (!p.converting)                                      // (A conversion just came in)
+				d.singlesOver += ((hostINA226[VOLTAGE_REG] * 0.00125 * VALT_SCALER * ADCCal.VBatGainError) - TARGET_VOLTS > LD1_THRESHOLD);
+			d.cuts    += (plant_field() < priorField * (1.0 - (1.0 - LD1_PULLBACK) / 2));   // (The PID alone moves it a step or so at a time)
+			priorField = plant_field();
+			continue;
+			}
+		d.peak = fmax(d.peak, p.volts);
+		if ((d.crossed < 0) && (p.volts > TARGET_VOLTS + LD1_THRESHOLD)) {
+			d.crossed    = us;
+			fieldAtCross = plant_field();
+			}
+		if ((d.crossed >= 0) && (d.pulledBack < 0) && (plant_field() <= fieldAtCross * LD1_PULLBACK + 1))
+			d.pulledBack = us;
+		}
+	return(d);
+}
+
+
+static void report(const char *how, const tDrop &d) {
+	printf("150A load drop, %s:  over LD1 %.1f mS after the drop, Field pulled back %.1f mS later, peak overshoot %.0f mV\n",
+	       how, (d.crossed - DROP_AT * 1000L) / 1000.0, (d.pulledBack - d.crossed) / 1000.0, (d.peak - TARGET_VOLTS) * 1000);
+	assert((d.crossed >= 0) && (d.pulledBack >= 0));
+}
+
+
+int main(int argc, char *argv[]) {
+	tDrop d = load_drop();
+	if (sim_result(argc, argv, d))
+		return(0);
+
+  #ifndef INA226_FAST_LOAD_DUMP
+	report("triggered 16x sampling", d);
+	printf("All tests passed.  (Triggered sampling only, testLoadDump compares)\n");
+	return(0);
+  #else
+	printf("Steady:  %ld single conversions over LD1, Field cut %ld times\n", d.singlesOver, d.cuts);
+	assert(d.singlesOver > 0);
+	assert(d.cuts == 0);
+
+	tDrop trig = sim_other_build<tDrop>(argv[0], "Triggered");
+	report("triggered 16x sampling", trig);
+	report("fast conversions", d);
+	assert((unsigned long) (d.pulledBack - d.crossed) <= (INA226_LD_AVERAGE + 2) * INA226_FAST_US);
+	assert(d.pulledBack - d.crossed < trig.pulledBack - trig.crossed);
+	assert(d.peak - TARGET_VOLTS < LOAD_BEFORE * plant.r0 + (trig.peak - TARGET_VOLTS - LOAD_BEFORE * plant.r0) * 0.7);
+										// (The jump across the battery's series R is there whatever the regulator
+										//  does, the rest is down to how soon the Field comes back)
+
+	printf("All tests passed.\n");
+  #endif
+}
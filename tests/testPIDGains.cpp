@@ -0,0 +1,189 @@
+// The run-time tunable PID gains, run for real (see SimPlant.h).  With Config.h's defaults pid_term() on pidScaled must work out
+// exactly what the fixed-gain engine did, I accumulation included, for each system voltage.  The $PGx: commands, through
+// check_inbound(), must change just their own gains (held within limits) and save them to the EEPROM, and change nothing if
+// incomplete or the config is locked out.  And a $PGA: must take effect on manage_ALT()'s very next PWM adjustment.
+#include "SimPlant.h"
+
+static float rnd(float lo, float hi) { return lo + (hi - lo) * (rand() / (float) RAND_MAX); }
+
+
+// The PID terms as manage_ALT() worked them out before the gains were made run-time tunable (Config.h constants baked in).
+static void reference(float errorV, float errorA, float errorW, float VdErr, float AdErr, float WdErr, float mult,
+		      float *ViErr, float *AiErr, float *WiErr, int out[3]) {
+	*ViErr += (errorV * (float) KiPWM_V / mult);
+	*AiErr += (errorA * (float) KiPWM_A);
+	*WiErr += (errorW * (float) KiPWM_W / mult);
+
+	*ViErr = constrain(*ViErr, 0, (float) PID_I_WINDUP_CAP);
+	*AiErr = constrain(*AiErr, 0, (float) PID_I_WINDUP_CAP);
+	*WiErr = constrain(*WiErr, 0, (float) PID_I_WINDUP_CAP);
+
+	out[0] = (int) (((errorV * (float) -KpPWM_V / mult) - *ViErr - (VdErr * (float) KdPWM_V / mult)) * FIELD_PWM_STEPS);
+	out[1] = (int) (((errorA * (float) -KpPWM_A)        - *AiErr - (AdErr * (float) KdPWM_A))        * FIELD_PWM_STEPS);
+	out[2] = (int) (((errorW * (float) -KpPWM_W / mult) - *WiErr - (WdErr * (float) KdPWM_W / mult)) * FIELD_PWM_STEPS);
+}
+
+
+// Same calls as manage_ALT() now makes.
+static void tunable(float errorV, float errorA, float errorW, float VdErr, float AdErr, float WdErr,
+		    float *ViErr, float *AiErr, float *WiErr, int out[3]) {
+	out[0] = (int) (pid_term(errorV, VdErr, ViErr, pidScaled.KP_V, pidScaled.KI_V, pidScaled.KD_V, pidScaled.I_WINDUP_CAP) * FIELD_PWM_STEPS);
+	out[1] = (int) (pid_term(errorA, AdErr, AiErr, pidScaled.KP_A, pidScaled.KI_A, pidScaled.KD_A, pidScaled.I_WINDUP_CAP) * FIELD_PWM_STEPS);
+	out[2] = (int) (pid_term(errorW, WdErr, WiErr, pidScaled.KP_W, pidScaled.KI_W, pidScaled.KD_W, pidScaled.I_WINDUP_CAP) * FIELD_PWM_STEPS);
+}
+
+
+static void via_serial(const char *cmd) {
+	static char line[100];
+
+	snprintf(line, sizeof(line), "$%s\r\n", cmd);
+	Serial.clear();
+	Serial.in = line;
+	for (int i = 0; i < 100; i++) {
+		host_advance(10);
+		check_inbound();
+		}
+	Serial.in = NULL;
+}
+
+
+// One command:  if it is taken, AOK is sent back, the gains from slot first (PIDS as 4 byte slots:  V 0-2, A 3-5, W 6-8, TA 9-10,
+// Loop 11-12) on may change but no others, they are saved, and pidScaled follows.  Else nothing changes.
+static void command(const char *cmd, bool taken, int first = 0, int n = 0) {
+	PIDS before = pidGains, saved;
+	uint8_t eeprom[HOST_EEPROM_SIZE];
+
+	memcpy(eeprom, hostEEPROM, sizeof(eeprom));
+	via_serial(cmd);
+	if (!taken) {
+		assert(memcmp(&pidGains, &before, sizeof(before)) == 0);
+		assert(memcmp(hostEEPROM, eeprom, sizeof(eeprom)) == 0);
+		assert(Serial.outLen == 0);
+		return;
+		}
+	assert(strstr(Serial.out, "AOK") != NULL);
+	for (int k = 0; k < (int) (sizeof(PIDS) / 4); k++)
+		if ((k < first) || (k >= first + n))
+			assert(memcmp((uint8_t *) &pidGains + 4 * k, (uint8_t *) &before + 4 * k, 4) == 0);
+	assert(read_PID_EEPROM(&saved) && (memcmp(&saved, &pidGains, sizeof(saved)) == 0));
+	assert((pidScaled.KP_V == pidGains.KP_V / systemVoltMult) && (pidScaled.KP_A == pidGains.KP_A));
+}
+
+
+// One manage_ALT() PWM adjustment with the Amps loop over its target and in control, after the command 'cmd' (if any).  Run in a
+// child (sim_fresh()), so each starts from the same I and prior readings.  Returns the Field change in 1/FIELD_PWM_STEPS.
+static int amps_adjustment(const char *cmd) {
+	updatingVAs = false;
+	set_ALT_mode(bulk_charge);
+	targetBatVolts   = 14.4;
+	targetAltAmps    = 50;
+	targetAltWatts   = 15000;
+	fieldPWMLimit    = FIELD_PWM_MAX;
+	measuredBatVolts = measuredAltVolts = 13.0;                     // (Volts well under, so that loop wants the Field up)
+	measuredAltAmps  = 60;                                          // Amps 10A over
+	measuredAltWatts = 800;
+	set_ALT_PWM(100);
+	host_advance(1000);
+	manage_ALT();                                                   // (1st adjustment:  sets the prior readings the D terms work from)
+
+	if (cmd != NULL)
+		via_serial(cmd);
+	set_ALT_PWM(100);
+	host_advance(pidGains.CHANGE_RATE + 1);
+	manage_ALT();
+	return(((int) fieldPWMvalue - 100) * FIELD_PWM_STEPS + fieldPWMfraction);
+}
+
+
+int main() {
+	float refI[3], tuneI[3];
+	int   refOut[3], tuneOut[3];
+
+	srand(43);
+
+	// Defaults must reproduce the old fixed-gain engine exactly, I accumulation included.
+	for (int m = 0; m < 4; m++) {                                   // 12v .. 96v systems
+		systemVoltMult = (float) (1 << m);
+		scale_PID_gains();
+		memset(refI, 0, sizeof(refI));
+		memset(tuneI, 0, sizeof(tuneI));
+
+		for (int i = 0; i < 50000; i++) {
+			float eV = rnd(-0.5f, 0.5f) * systemVoltMult,  eA = rnd(-40, 40), eW = rnd(-500, 500);
+			float dV = rnd(-0.05f, 0.05f) * systemVoltMult, dA = rnd(-5, 5),  dW = rnd(-50, 50);
+
+			reference(eV, eA, eW, dV, dA, dW, systemVoltMult, &refI[0], &refI[1], &refI[2], refOut);
+			tunable(eV, eA, eW, dV, dA, dW, &tuneI[0], &tuneI[1], &tuneI[2], tuneOut);
+
+			for (int k = 0; k < 3; k++) {
+				assert(refOut[k] == tuneOut[k]);
+				assert(refI[k]   == tuneI[k]);
+				assert(tuneI[k] >= 0 && tuneI[k] <= (float) PID_I_WINDUP_CAP);
+			}
+		}
+	}
+	systemVoltMult = 2;
+	scale_PID_gains();
+
+
+	// The $PGx: commands, each through check_inbound().
+	PIDS was = pidGains;
+	systemConfig.BT_CONFIG_CHANGED = true;                          // (Else nothing is saved, see write_PID_EEPROM())
+	command("PGV:10,5,40", true, 0, 3);
+	assert((pidGains.KP_V == 10.0f) && (pidGains.KI_V == 5.0f) && (pidGains.KD_V == 40.0f));
+	command("PGA:1.2,0.5,0.4", true, 3, 3);
+	assert((pidGains.KP_A == 1.2f) && (pidGains.KI_A == 0.5f) && (pidGains.KD_A == 0.4f));
+	command("PGW:0.1,0.01,0.03", true, 6, 3);
+	assert((pidGains.KP_W == 0.1f) && (pidGains.KI_W == 0.01f) && (pidGains.KD_W == 0.03f));
+	command("PGT:1.5,2.0", true, 9, 2);
+	assert((pidGains.KP_TA == 1.5f) && (pidGains.KD_TA == 2.0f));
+	command("PGL:0.5,150", true, 11, 2);
+	assert((pidGains.I_WINDUP_CAP == 0.5f) && (pidGains.CHANGE_RATE == 150));
+	assert((pidScaled.KI_V == 2.5f) && (pidScaled.KD_W == 0.015f) && (pidScaled.KD_TA == 2.0f) && (pidScaled.CHANGE_RATE == 150));
+
+	command("PGV:300,5,40",   true, 0, 3);                               // Out of range values are held to the limits
+	assert(pidGains.KP_V == 200.0f);
+	command("PGL:0.5,5",      true, 11, 2);
+	assert(pidGains.CHANGE_RATE == 20);
+	command("PGA:1.2,0.5",    false);                               // Missing one
+	command("PGX:1,1,1",      false);                               // No such gains
+
+	systemConfig.CONFIG_LOCKOUT = 1;                                // Locked out
+	command("PGV:15,5,40",    false);
+	systemConfig.CONFIG_LOCKOUT = 0;
+
+	// Saved apart from the charge profiles:  saving one of those leaves the gains as they were.
+	PIDS pg;
+	via_serial("CPA:7,14.6,120,4,2.5");
+	assert(strstr(Serial.out, "AOK") != NULL);
+	assert(read_PID_EEPROM(&pg) && (memcmp(&pg, &pidGains, sizeof(pg)) == 0));
+	memset(hostEEPROM + CPX_FLASH_LOCAITON, 0xFF, sizeof(CPX));                     // Nor does the CPX block after them, as a build from
+	assert(read_PID_EEPROM(&pg) && (memcmp(&pg, &pidGains, sizeof(pg)) == 0));       //  before CPX would have left it.
+
+	// $PGR: forgets the saved gains (the defaults come back after the next $RBT), those in use stay until then.
+	PIDS inUse = pidGains;
+	via_serial("PGR:");
+	assert(strstr(Serial.out, "AOK") != NULL);
+	assert(!read_PID_EEPROM(&pg));
+	assert(memcmp(&pidGains, &inUse, sizeof(inUse)) == 0);
+	pidGains = was;
+	scale_PID_gains();
+
+
+	// A changed Amps gain is used on manage_ALT()'s very next adjustment.  (10A over, the I at its cap from the 1st adjustment)
+	int dflt  = sim_fresh(amps_adjustment, (const char *) NULL);
+	int tuned = sim_fresh(amps_adjustment, "PGA:1.8,0.3,0.7");
+	printf("Amps 10A over:  Field change %d with the default Amps gains, %d after $PGA:1.8,0.3,0.7  (1/%d steps)\n", dflt, tuned, FIELD_PWM_STEPS);
+	assert(dflt  == (int) ((10.0f * (float) -KpPWM_A - (float) PID_I_WINDUP_CAP) * FIELD_PWM_STEPS));
+	assert(tuned == (int) ((10.0f * -1.8f            - (float) PID_I_WINDUP_CAP) * FIELD_PWM_STEPS));
+
+
+	// A lower windup cap limits how far 'I' can pull the PWM back.
+	float Ii = 0;
+	for (int i = 0; i < 10; i++)
+		pid_term(0.5f, 0, &Ii, 20.0f, 10.0f, 50.0f, 0.25f);
+	assert(Ii == 0.25f);
+
+	printf("All tests passed.\n");
+	return 0;
+}
@@ -0,0 +1,149 @@
+// persistentBatAmps / persistentBatVolts smoothing:  the old float filters (AMPS_PERSISTENCE_FACTOR 512, VOLTS_PERSISTENCE_FACTOR 300)
+// against the fixed point persist_filter() that replaced them.  Traces shaped like logged charge cycles are handed to the real
+// manage_ALT() (see SimRegulator.h), and the charge mode changes that hang off these values should happen at (just about) the same
+// time as the old filters would have made them.
+#include "SimRegulator.h"
+
+#define STEP_MS      (PWM_CHANGE_RATE + 1)      // A reading just past each PWM_CHANGE_RATE, so every one is taken in
+#define STEPS_PER_S  (1000.0 / STEP_MS)
+
+#define OLD_AMPS_FACTOR          512L
+#define OLD_VOLTS_FACTOR         300
+
+#define ACPT_EXIT_AMPS           5
+#define PF_BULK_VOLTS           12.8
+
+
+static float rnd(float lo, float hi) { return lo + (hi - lo) * (rand() / (float) RAND_MAX); }
+
+
+static float oldAmps, oldVolts;                 // The float filters, as manage_ALT() had them
+
+
+// One reading into manage_ALT(), and into the old filters.
+static void reading(float amps, float volts) {
+	if (amps >= oldAmps)
+		oldAmps = amps;
+	else if (amps > 0.0)
+		oldAmps = (((oldAmps * (float)(OLD_AMPS_FACTOR-1L)) + amps) / OLD_AMPS_FACTOR);
+
+	if (volts >= oldVolts)
+		oldVolts = volts;
+	else
+		oldVolts = (((oldVolts * (float)(OLD_VOLTS_FACTOR-1)) + volts) / OLD_VOLTS_FACTOR);
+
+	measuredBatAmps   = measuredAltAmps  = amps;
+	measuredBatVolts  = measuredAltVolts = volts;
+	measuredAltWatts  = volts * amps;
+	shuntAmpsMeasured = true;
+	updatingVAs       = false;
+	host_advance(STEP_MS);
+	manage_ALT();
+}
+
+
+// Ramping takes the readings as they are, starting both the old and new filters from there.  Then on into 'mode'.
+static void start(tModes mode, float amps, float volts) {
+	oldAmps  = amps;
+	oldVolts = volts;
+	set_ALT_mode(ramping);
+	reading(amps, volts);
+	assert((persistentBatAmps == amps) && (persistentBatVolts == volts));
+	set_ALT_mode(mode);
+}
+
+
+int main() {
+	int32_t  acc;
+
+	// The helper itself:  jumps up, decays by 1/2^shift of the difference, and settles on a steady input exactly.
+	persist_set(&acc, 1000, 4);
+	assert(persist_filter(&acc, 2000, 4) == 2000);
+	assert(persist_filter(&acc, 400, 4)  == 2000 - 100);             // (2000*15 + 400) / 16
+	for (int i = 0; i < 1000; i++)
+		persist_filter(&acc, 400, 4);
+	assert(persist_filter(&acc, 400, 4)  == 400);
+	persist_set(&acc, -300, 4);                                      // Negative values (discharging) work too
+	assert(persist_filter(&acc, -300, 4) == -300);
+	assert(persist_filter(&acc, -200, 4) == -200);
+	persist_set(&acc, 0, 0);                                         // Shift of 0 = no smoothing at all
+	assert(persist_filter(&acc, 123, 0)  == 123);
+	assert(persist_filter(&acc, -45, 0)  == -45);
+
+
+	srand(46);
+	workingParms.EXIT_ACPT_DURATION  = 10 * 3600000UL;              // Only the Amps and Volts move us on
+	workingParms.EXIT_ACPT_AMPS      = ACPT_EXIT_AMPS;
+	workingParms.EXIT_ACPT_DIDT      = 0;
+	workingParms.LIMIT_OC_AMPS       = 0;
+	workingParms.EXIT_FLOAT_DURATION = 0;
+	workingParms.FLOAT_TO_BULK_AMPS  = 0;
+	workingParms.FLOAT_TO_BULK_AHS   = 0;
+	workingParms.FLOAT_TO_BULK_VOLTS = 0;
+	workingParms.EXIT_PF_DURATION    = 0;
+	workingParms.PF_TO_BULK_AHS      = 0;
+	workingParms.PF_TO_BULK_VOLTS    = PF_BULK_VOLTS;
+	targetAltAmps  = 500;
+	targetAltWatts = 15000;
+
+
+	// Acceptance:  Amps tail off from 80A with noise and now and then a load spike (pump, windlass) for a few seconds.  manage_ALT()
+	// should go on to Float when persistentBatAmps reaches EXIT_ACPT_AMPS.
+	long oldExit = -1, newExit = -1;
+	float maxAmpsDiff = 0;
+	targetBatVolts = 14.4;
+	start(acceptance_charge, 80.0, 14.4);
+	for (long t = 0; t < 6L * 3600L * STEPS_PER_S; t++) {            // 6 hours
+		float amps = 2.0 + 78.0 * exp(-t / (2400.0 * STEPS_PER_S)) + rnd(-1.5, 1.5);
+		if (fmod(t / STEPS_PER_S, 600.0) < 5.0)                     // 5S of an extra 20A every 10 minutes
+			amps += 20.0;
+		reading(amps, 14.4 + rnd(-0.01, 0.01));
+		if (newExit < 0)
+			maxAmpsDiff = fmax(maxAmpsDiff, fabs(oldAmps - persistentBatAmps));
+		if ((oldExit < 0) && (oldAmps <= ACPT_EXIT_AMPS))                    oldExit = t;
+		if ((newExit < 0) && (alternatorState != acceptance_charge))         newExit = t;
+		}
+	printf("Acceptance exit at %.1f / %.1f minutes,  largest difference %.3fA\n",
+		oldExit / STEPS_PER_S / 60, newExit / STEPS_PER_S / 60, maxAmpsDiff);
+	assert((oldExit > 0) && (newExit > 0));
+	assert(alternatorState == float_charge);
+	assert(labs(oldExit - newExit) <= 15 * STEPS_PER_S);             // Within 15 seconds  (Near the exit the Amps fall ~0.04A a minute,
+	                                                                //  so the 1/PERSISTENCE_AMPS_SCALE fixed point alone is worth ~6 seconds)
+	assert(maxAmpsDiff < 0.05);
+
+
+	// Float, then discharging:  Amps go negative, which neither version lets drag persistentBatAmps down.
+	targetBatVolts = 13.4;
+	start(float_charge, 3.0, 13.4);
+	for (long t = 0; t < 3600L * STEPS_PER_S; t++)
+		reading(-15.0 + rnd(-2, 2), 13.4);
+	assert((oldAmps == 3.0f) && (persistentBatAmps == 3.0f));
+	assert(alternatorState == float_charge);
+
+
+	// Post-float:  battery resting at 13.3v drifts down under a house load, with noise, and with a 2 second engine start dip to
+	// 10.5v along the way.  manage_ALT() should go back to Bulk (via ramping) when persistentBatVolts falls under PF_TO_BULK_VOLTS -
+	// not on the dip, but on the drift.
+	oldExit = newExit = -1;
+	float maxVoltsDiff = 0;
+	long  dip = 1800L * STEPS_PER_S;
+	targetBatVolts = 14.4;                                          // (Well above, so the load-dump checks stay out of it)
+	start(post_float, 0.0, 13.3);
+	for (long t = 0; t < 4L * 3600L * STEPS_PER_S; t++) {            // 4 hours
+		float volts = 13.3 - 0.25 * t / (3600.0 * STEPS_PER_S) + rnd(-0.02, 0.02);
+		if ((t >= dip) && (t < dip + 2 * STEPS_PER_S))
+			volts = 10.5;
+		reading(0.0, volts);
+		if ((newExit < 0) && ((t < dip) || (t > dip + 200 * STEPS_PER_S)))     // (Differences right after the dip are expected: 300 vs 256 samples)
+			maxVoltsDiff = fmax(maxVoltsDiff, fabs(oldVolts - persistentBatVolts));
+		if ((oldExit < 0) && (oldVolts < PF_BULK_VOLTS))                  oldExit = t;
+		if ((newExit < 0) && (alternatorState != post_float))               newExit = t;
+		}
+	printf("Post-float to Bulk at %.1f / %.1f minutes,  largest difference %.4fv\n",
+		oldExit / STEPS_PER_S / 60, newExit / STEPS_PER_S / 60, maxVoltsDiff);
+	assert((oldExit > dip + 200 * STEPS_PER_S) && (newExit > dip + 200 * STEPS_PER_S));   // Dip did not do it
+	assert(labs(oldExit - newExit) <= 60 * STEPS_PER_S);             // Within a minute of a 2 hour drift
+	assert(maxVoltsDiff < 0.005);
+
+	return 0;
+}
@@ -0,0 +1,114 @@
+// The Remote Battery Master's Amps and desired Volts / Amps, run for real (see SimRegulator.h):  RVCDCStatus1_handler() and
+// RVCDCStatus4_handler() now keep them as mA / mV, and the RBM part of calculate_ALT_targets() works on those.  Over the operating
+// range the targets must come out the same as the float expressions they replaced, to within the 1mV / 1mA LSB (and the 1% steps the
+// no-shunt field pull-back is now done in).  (float, as double == float on the AVR)
+#define SIM_SYSTEMCAN
+#include "SimRegulator.h"
+
+#define RBM_SOURCE  0x30
+#define RBM_DEVPRI  200                                 // Smarter then us, so we will take directions from it
+
+
+static void from_RBM(uint32_t Adc, uint16_t desVolt, uint16_t desAmp) {     // DC Status 1 (Amps), 4 (Desired) and 5 (Volts) arrive from the remote master
+	tN2kMsg msg;
+
+	SetRVCDCSourceStatus1(msg, batteryInstance, RBM_DEVPRI, 0, Adc);
+	msg.Source  = RBM_SOURCE;
+	msg.MsgTime = millis();
+	RVCDCStatus1_handler(msg);
+
+	SetRVCDCSourceStatus4(msg, batteryInstance, RBM_DEVPRI, RVCDCbcm_Bulk, desVolt, desAmp, RVCDCbt_Flooded);
+	msg.Source  = RBM_SOURCE;
+	msg.MsgTime = millis();
+	RVCDCStatus4_handler(msg);
+
+	SetRVCDCSourceStatus5(msg, batteryInstance, RBM_DEVPRI, 13250, 32000);
+	msg.Source  = RBM_SOURCE;
+	msg.MsgTime = millis();
+	RVCDCStatus5_handler(msg);
+}
+
+
+static int pullbackBase;                                // What the no-shunt pull-back was taken from
+
+static void old_RBM_targets(uint32_t Adc, uint16_t desVolt, uint16_t desAmp) {     // The RBM part of calculate_ALT_targets() as it was
+	float amps         = (float)((int32_t)Adc - 0x77359400) * 0.001;
+	float desiredVolts = (float) desVolt * 0.050;
+	float desiredAmps  = (float)(desAmp - 0x7D00) * 0.050;
+
+	set_VAWL(desiredVolts / systemVoltMult);
+	pullbackBase = min(fieldPWMLimit, fieldPWMvalue);
+	if ((millis() - CAN_LPCS_lastReceived) > REMOTE_CAN_LPCS_TIMEOUT) {
+		if (amps > desiredAmps) {
+			if (shuntAmpsMeasured) {
+				if ((millis() - CAN_EPCS_lastReceived) > REMOTE_CAN_LPCS_TIMEOUT)
+				     targetAltAmps = measuredAltAmps - (amps - desiredAmps)/2;
+				else targetAltAmps = measuredAltAmps - (amps - desiredAmps);
+				}
+			else
+				fieldPWMLimit = min(fieldPWMLimit, fieldPWMvalue) * ((amps - desiredAmps) / amps);
+			}
+		if ((amps < desiredAmps) && shuntAmpsMeasured)
+			targetAltAmps = measuredAltAmps + (desiredAmps - amps);
+		}
+
+	if (fieldPWMLimit < FIELD_PWM_MIN)  fieldPWMLimit = FIELD_PWM_MIN;
+	if (targetAltAmps < 0.0)            targetAltAmps = 0.0;
+}
+
+
+int main() {
+	alternatorState = bulk_charge;
+	for (int i = 0; i < 120; i++) {                 // Talk long enough for it to be trusted
+		host_advance(100);
+		from_RBM(0x77359400 + 20000, 14400 / 50, 0x7D00 + 40000 / 50);
+		}
+	assert(CAN_RBM_sourceID == RBM_SOURCE);
+	assert(CAN_RBM_desiredChargeState == RVCDCbcm_Bulk);
+
+	static const float mults[] = { 1.0, 1.5, 2.0, 3.0, 4.0 };
+	float  maxVolts = 0, maxAmps = 0;
+	int    maxPWM   = 0, differ = 0;
+	long   n        = 0;
+
+	srand(31);
+	for (int i = 0; i < 200000; i++) {
+		long     mA      = (rand() % 1000001) - 500000;                 // -500A .. 500A at the battery
+		uint16_t desVolt = 10000 / 50 + rand() % ((60000 - 10000) / 50 + 1);
+		uint16_t desAmp  = 0x7D00 + rand() % (300000 / 50 + 1);        //   0A .. 300A wanted
+		uint32_t Adc     = 0x77359400 + mA;
+
+		systemVoltMult     = mults[rand() % 5];
+		shuntAmpsMeasured  = rand() & 1;
+		measuredAltAmps    = (rand() % 30000) / 100.0f;
+		fieldPWMvalue      = FIELD_PWM_MIN + rand() % (FIELD_PWM_MAX - FIELD_PWM_MIN + 1);
+		tachMode           = false;
+
+		host_advance(10);
+		from_RBM(Adc, desVolt, desAmp);
+		CAN_LPCS_lastReceived   = millis() - REMOTE_CAN_LPCS_TIMEOUT - 1;             // We are the lowest priority source,
+		CAN_EPCS_lastReceived   = (rand() & 1) ? millis() : millis() - REMOTE_CAN_LPCS_TIMEOUT - 1;    //  with or without a peer to share with
+		CAN_HPUUCS_lastReceived = millis() - REMOTE_CAN_HPUUCS_TIMEOUT - 1;
+		average_EPC_utilization = 0;
+
+		calculate_ALT_targets();
+		float newVolts = targetBatVolts;
+		float newAmps  = targetAltAmps;
+		int   newPWM   = fieldPWMLimit;
+
+		old_RBM_targets(Adc, desVolt, desAmp);
+		maxVolts = max(maxVolts, fabsf(newVolts - targetBatVolts));
+		maxAmps  = max(maxAmps,  fabsf(newAmps  - targetAltAmps));
+		maxPWM   = max(maxPWM,   abs(newPWM - fieldPWMLimit));
+		differ  += (newPWM != fieldPWMLimit);
+		n++;
+
+		assert(fabsf(newVolts - targetBatVolts) <= 0.001f);
+		assert(fabsf(newAmps  - targetAltAmps)  <= 0.001f);
+		assert(abs(newPWM - fieldPWMLimit) <= pullbackBase / 100 + 1);
+		}
+
+	printf("%ld frames:  targetBatVolts within %.6fV, targetAltAmps within %.6fA, fieldPWMLimit within %d (%d differ)\n",
+		n, maxVolts, maxAmps, maxPWM, differ);
+	return 0;
+}
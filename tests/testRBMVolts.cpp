@@ -0,0 +1,80 @@
+// The Remote Battery Master's volts, run for real (see SimRegulator.h):  the offset saved by RVCDCStatus5_handler() and the range
+// check in resolve_BAT_VoltAmpTemp() are now done in integer mV, and must come out the same as the float expressions they replaced.
+// (float, as double == float on the AVR)
+#define SIM_SYSTEMCAN
+#include "SimRegulator.h"
+
+#define RBM_SOURCE  0x30
+#define RBM_DEVPRI  200                                 // Smarter then us, so we will take directions from it
+
+
+static void from_RBM(uint32_t mV) {                     // DC Status 1 (0A) and 5 arrive from the remote master
+	tN2kMsg msg;
+
+	SetRVCDCSourceStatus1(msg, batteryInstance, RBM_DEVPRI, 0, 0x77359400);
+	msg.Source  = RBM_SOURCE;
+	msg.MsgTime = millis();
+	RVCDCStatus1_handler(msg);
+
+	SetRVCDCSourceStatus5(msg, batteryInstance, RBM_DEVPRI, mV, 32000);
+	msg.Source  = RBM_SOURCE;
+	msg.MsgTime = millis();
+	RVCDCStatus5_handler(msg);
+}
+
+
+static bool old_in_range(long mV) {
+	return((mV <= (float) (FAULT_BAT_VOLTS_EQUALIZE * (float) systemVoltMult * 1000.0f)) &&
+	       (mV >= (float) (FAULT_BAT_VOLTS_LOW      * (float) systemVoltMult * 1000.0f)));
+}
+
+
+int main() {
+	measuredAltVolts = 13.2;
+	for (int i = 0; i < 120; i++) {                 // Talk long enough for it to be trusted
+		host_advance(100);
+		from_RBM(13250);
+		}
+	assert(CAN_RBM_sourceID == RBM_SOURCE);
+
+
+	// The offset:  within the 1mV LSB of (long)(measuredAltVolts * 1000.0)
+	int differ = 0;
+	srand(31);
+	for (int i = 0; i < 200000; i++) {
+		measuredAltVolts = (rand() % 6000000) / 100000.0f + 5.0f;
+		uint32_t mV = 5000 + rand() % 60000;
+
+		host_advance(1);
+		from_RBM(mV);
+		long old = (long) mV - (long) (measuredAltVolts * 1000.0f);
+		assert(labs(CAN_RBM_mVoltsOffset - old) <= 1);
+		differ += (CAN_RBM_mVoltsOffset != old);
+		}
+	printf("Offset:  %d of 200000 differ by 1mV\n", differ);
+
+
+	// The range check:  the same answer either side of each limit, for each battery size.
+	static const float mults[] = { 1.0, 1.5, 2.0, 3.0, 4.0, 1.1, 2.2 };
+	for (unsigned m = 0; m < sizeof(mults) / sizeof(mults[0]); m++) {
+		systemVoltMult = mults[m];
+		long limits[2] = { (long) (FAULT_BAT_VOLTS_LOW * 1000 * mults[m]), (long) (FAULT_BAT_VOLTS_EQUALIZE * 1000 * mults[m]) };
+
+		for (int l = 0; l < 2; l++)
+			for (long mV = limits[l] - 5; mV <= limits[l] + 5; mV++) {
+				CAN_RBM_lastReceived   = millis();
+				CAN_RBM_voltsRefreshed = millis();
+				CAN_RBM_mVolts         = mV;
+				CAN_RBM_mVoltsOffset   = 50;
+				CAN_RBM_voPWMvalue     = fieldPWMvalue;
+				ignoringRBM            = false;
+				measuredAltVolts       = mV * 0.001f;
+
+				resolve_BAT_VoltAmpTemp();
+				bool used = (measuredBatVolts != measuredAltVolts);
+				assert(used == old_in_range(mV));
+				}
+		}
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+// The real manage_ALT()'s (see SimPlant.h) Ramping phase on a well down battery, so the PID is asking for all it can get.  The ramp rate
+// (PWM_CHANGE_CAP every PWM_RAMP_RATE) is spread over every adjustment by slew_allow(), rather then raising the Field a full PWM_CHANGE_CAP
+// at a time now and then.  Looks at the largest single step up in the Field, and how long the ramp takes to reach FIELD_PWM_MAX against
+// what PWM_RAMP_RATE * FIELD_PWM_MAX / PWM_CHANGE_CAP says it should.
+#include "SimPlant.h"
+
+#define RAMP_TIME          (PWM_RAMP_RATE * FIELD_PWM_MAX / PWM_CHANGE_CAP)
+
+static const tPlantSpec plant = {                 // Small alternator, large flat battery:  never near the Volts, Amps or Watts targets
+	0.2, 60.0, 0.15,
+	0.01, 0.0, 1.0, 12.0, 0.0,
+	0.0, 0.0 };
+
+
+typedef struct {
+	double maxStep;                         // Largest single rise of the Field (in PWM steps)
+	double reachedAt;                       // Seconds into the ramp it moved on to Bulk
+	int    atExit;                          // Field PWM when Ramping ended
+	bool   monotonic;
+	} tResult;
+
+
+// If 'pause' is set, the alternator sits at its temperature set point for 10 seconds part way along, so the PID asks for nothing more
+// for a while - the ramp should then pick up again at the same rate, not make up for lost time.
+static tResult ramp(bool pause) {
+	tResult r = { 0, 0, 0, true };
+	tPlant  p;
+	double  prior = 0;
+
+	targetBatVolts = 14.4;
+	targetAltAmps  = 500;
+	targetAltWatts = 15000;
+	plant_start(&p, &plant, 0);
+	set_ALT_mode(ramping);
+
+	for (long t = 0; alternatorState == ramping; t++) {
+		long ms = t * PLANT_TICK_US / 1000L;
+		measuredAltTemp = (pause && (ms > 20000) && (ms < 30000)) ? systemConfig.ALT_TEMP_SETPOINT : -99;
+		plant_tick(&p);
+
+		double field = plant_field();
+		if (alternatorState == ramping) {                               // (The move on to Bulk makes the first full PID adjustment)
+			r.maxStep   = fmax(r.maxStep, field - prior);
+			r.monotonic = r.monotonic && (field >= prior);
+			r.atExit    = fieldPWMvalue;
+			}
+		prior       = field;
+		r.reachedAt = ms / 1000.0;
+		}
+	return(r);
+}
+
+
+int main() {
+	unsigned long acc = 0;
+
+	// slew_allow():  0.5 steps per 100mS comes out as 0,1,0,1..  and odd times add up right.
+	assert(slew_allow(&acc, 100, 2, 400) == 0);
+	assert(slew_allow(&acc, 100, 2, 400) == 1);
+	assert(slew_allow(&acc, 100, 2, 400) == 0);
+	assert(slew_allow(&acc, 100, 2, 400) == 1);
+	int total = 0;
+	acc = 0;
+	for (int i = 0; i < 100; i++)
+		total += slew_allow(&acc, 140, 8, 400);                      // 100 x 140mS = 14 S = 35 periods
+	assert(total == 35 * 8);
+	acc = 0;
+	assert(slew_allow(&acc, 60000UL, 2, 400) == 2);                  // A long gap counts as one period
+	assert(slew_allow(&acc, 0, 2, 400) == 0);
+
+
+	// Spread out, no single rise should be more then half of PWM_CHANGE_CAP, the Field should only ever go up, and it should be at
+	// (or within a step of) FIELD_PWM_MAX at the configured ramp time.  (Adjustments only come with new readings, so 'longer then
+	// PWM_RAMP_RATE' alone would work out to every 400mS + part of a reading, and fall behind)
+	tResult n = sim_fresh(ramp, false);
+	tResult p = sim_fresh(ramp, true);
+
+	printf("Largest rise %4.2f   ramp %4.1f S (configured %4.1f)  Field at exit %3d   (with a pause: rise %4.2f, ramp %4.1f S, Field at exit %3d)\n",
+	       n.maxStep, n.reachedAt, RAMP_TIME / 1000.0, n.atExit, p.maxStep, p.reachedAt, p.atExit);
+
+	assert(n.monotonic && p.monotonic);
+	assert(n.maxStep <= PWM_CHANGE_CAP / 2);
+	assert(n.atExit >= FIELD_PWM_MAX - 1);
+	assert(fabs(n.reachedAt - RAMP_TIME / 1000.0) <= 2 * (PWM_CHANGE_RATE + INA226_AVERAGED_US / 1000) / 1000.0);
+	assert(p.maxStep <= n.maxStep);                                     // No catching up after the pause
+	assert(p.atExit  <= n.atExit - (int) (10000 * PWM_CHANGE_CAP / PWM_RAMP_RATE) + PWM_CHANGE_CAP);
+
+	return 0;
+}
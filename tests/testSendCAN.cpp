@@ -0,0 +1,92 @@
+// send_CAN() run for real (see SimRegulator.h):  each pass stays inside its frame budget counting the frames actually sent (a Terminal
+// reply is several), CAN_busTimeUsed matches what went out on the bus, the regular messages keep to their periods even while a long
+// Terminal reply is going out, and the worst latency and Terminal drops / overruns show up in the CDB;
+// debug string.
+#define SIM_SYSTEMCAN
+#include "SimRegulator.h"
+
+#define TICK_MS      10UL                       // loop() comes around about this often
+#define TERM_SOURCE  0x20
+
+
+static unsigned long frames_of(uint32_t pgn, unsigned from) {  // How many frames of this PGN went out on the bus since 'from'
+	unsigned long n = 0;
+
+	for (unsigned i = from; (i < hostCANSentCnt) && (i < HOST_CAN_SENT_MAX); i++)
+		n += (((hostCANSent[i].id >> 8) & 0x1FFFF) == pgn);
+	return(n);
+}
+
+
+static uint8_t worstPass;
+
+static void tick(void) {
+	host_advance(TICK_MS);
+	check_CAN();
+	check_inbound();
+	send_CAN();
+	worstPass = max(worstPass, CAN_lastPassFrames);
+	host_can_bus(50);                           // (The bus keeps up)
+}
+
+
+int main() {
+	alternatorState = bulk_charge;
+	initialize_CAN();
+	for (int i = 0; i < 300; i++)
+		tick();
+
+
+	// A minute of the regular messages.
+	unsigned      from     = hostCANSentCnt;
+	unsigned long sentFrom = CAN_framesSent;
+	unsigned long busFrom  = CAN_busTimeUsed;
+	worstPass = 0;
+	for (int i = 0; i < 6000; i++)
+		tick();
+
+	unsigned long onBus = hostCANSentCnt - from;
+	printf("Regular:  %lu frames, %lu mS of bus, worst pass %d frames\n", onBus, (CAN_busTimeUsed - busFrom) / 1000UL, worstPass);
+	assert(CAN_framesSent - sentFrom == onBus);                                     // Every frame counted, and only those
+	assert(CAN_busTimeUsed - busFrom == onBus * CAN_FRAME_BUS_TIME);
+	assert(worstPass <= CAN_SEND_FRAME_BUDGET);
+	assert(frames_of(0x1FF9D, from) >= 119 && frames_of(0x1FF9D, from) <= 121);     // Charger Status 2, every 500mS
+	assert(frames_of(0x1F212, from) >= 178 && frames_of(0x1F212, from) <= 182);     // NMEA2000 DC Status, every 667mS in 2 frames (fast-packet)
+	assert(frames_of(0x1FECA, from) >= 11  && frames_of(0x1FECA, from) <= 13);      // ISO Diagnostics, every 5 S
+
+
+	// Now a long Terminal reply ($RAS: all the status strings) going out at the same time.
+	char     line[] = "$RAS:\r\n";
+	uint8_t  me     = NMEA2000.GetN2kSource();
+
+	for (int i = 0; CANHandlers[i].PGN != 0; i++)
+		CANHandlers[i].maxLatency = 0;
+	from      = hostCANSentCnt;
+	worstPass = 0;
+	assert(host_can_receive((7UL << 26) | ((0x17E00UL | me) << 8) | TERM_SOURCE, true, strlen(line), (uint8_t *) line) >= 0);
+	for (int i = 0; i < 1000; i++)
+		tick();
+
+	unsigned long terminal = frames_of(0x17E00 | TERM_SOURCE, from);
+	printf("Terminal:  %lu frames, worst pass %d frames\n", terminal, worstPass);
+	assert(terminal > 40);
+	assert(worstPass <= CAN_SEND_FRAME_BUDGET - 1 + cASCII_TX_FRAMES_MAX);          // (The Terminal can start its frames with the budget nearly used)
+	assert(frames_of(0x1FF9D, from) >= 19 && frames_of(0x1FF9D, from) <= 21);
+	for (int i = 0; CANHandlers[i].PGN != 0; i++)
+		assert(CANHandlers[i].maxLatency <= 2 * TICK_MS);                         // Nothing kept waiting more than a pass or so
+
+
+	// And the worst latency (and Terminal characters dropped and overrun) is there in the debug output.
+	CANHandlers[3].maxLatency = 1234;
+	CAN_ASCII_txDrops         = 56;
+	CAN_ASCII_rxOverruns      = 78;
+	Serial.clear();
+	send_CAN_debug();
+	printf("%s", Serial.out);
+	char expect[40];
+	snprintf(expect, sizeof(expect), ",1234,%lX,56,78\r\n", CANHandlers[3].PGN);
+	assert(strncmp(Serial.out, "CDB;,", 5) == 0);
+	assert(strstr(Serial.out, expect) != NULL);
+
+	return 0;
+}
@@ -0,0 +1,145 @@
+// send_outbound() run for real (see SimRegulator.h):  how many bytes a second go out the 9600 baud Bluetooth link when things are quiet
+// and when the Amps are noisy, and how long a change takes to go out - in the fast AST values, the slower AST values, and in one of the
+// not-so-critical strings (looked at over more then 256 turns, so across the point UMCounter used to roll over).  Compared with the
+// fixed rotation it replaced:  AST every second, and each of the other strings once every 60 turns.
+#include "SimRegulator.h"
+
+#define TICK_MS      10UL                       // loop() comes around about this often
+#define OLD_STATUS_RATE  1000UL                 // The fixed rotation, as it was  (UPDATE_STATUS_RATE, UPDATE_MAJOR_SENSITIVITY)
+#define OLD_MAJOR_TURNS    60
+
+static unsigned long sent[NUM_STATUS_STRINGS];  // Times each string was sent, and bytes (all strings) since last cleared
+static unsigned long bytes;
+
+
+static int sent_now(void) {                     // Bit-map of the strings sent by this call of send_outbound()
+	static const char *const tags[NUM_STATUS_STRINGS] = { "AST;", "SST;", "CST;", "CPE;", "SCV;", "NPC;", "LST;" };
+	int map = 0;
+
+	for (int i = 0; i < NUM_STATUS_STRINGS; i++)
+		if (strstr(Serial.out, tags[i])) {
+			map |= 1 << i;
+			sent[i]++;
+			}
+	bytes += Serial.outLen;
+	Serial.clear();
+	return(map);
+}
+
+
+static int tick(void) {
+	host_advance(TICK_MS);
+	send_outbound(false);
+	return(sent_now());
+}
+
+
+static void run_for(unsigned long ms) {
+	for (unsigned long t = 0; t < ms; t += TICK_MS)
+		tick();
+}
+
+
+static unsigned long latency(int string) {      // mS until the string next goes out
+	for (unsigned long t = TICK_MS; ; t += TICK_MS)
+		if (tick() & (1 << string))
+			return(t);
+}
+
+
+static void clear_counts(void) {
+	memset(sent, 0, sizeof(sent));
+	bytes = 0;
+}
+
+
+static unsigned long oldBytes;
+static void count_old(char c) { oldBytes++; }
+
+static double old_bytes_per_sec(void) {         // What the fixed rotation sends, from the same strings, over one full round of it
+	oldBytes = 0;
+	for (int turn = 0; turn < OLD_MAJOR_TURNS; turn++) {
+		prep_status(0, count_old);
+		for (int i = 1; i < NUM_STATUS_STRINGS; i++)
+			if (turn == (i * OLD_MAJOR_TURNS / (NUM_STATUS_STRINGS - 1)) - 1)
+				prep_status(i, count_old);
+		}
+	return(oldBytes / (OLD_MAJOR_TURNS * OLD_STATUS_RATE / 1000.0));
+}
+
+
+int main() {
+	measuredBatVolts = 13.20;
+	measuredAltAmps  = 40.0;
+	fieldPWMvalue    = 100;
+	alternatorState  = float_charge;
+	run_for(120000UL);                                              // Everything sent at least once, the hashes settled
+
+
+	// Quiet:  AST every UPDATE_STATUS_RATE, the rest once a minute.  Well under what the fixed rotation sent.
+	clear_counts();
+	run_for(600000UL);
+	double oldRate = old_bytes_per_sec();
+	printf("Quiet:  %5.1f bytes/S (fixed rotation %5.1f)   AST %lu  SST %lu  LST %lu  in 10 minutes\n", bytes / 600.0, oldRate,
+	       sent[0], sent[1], sent[6]);
+	assert((sent[0] >= 600000UL / UPDATE_STATUS_RATE - 1) && (sent[0] <= 600000UL / UPDATE_STATUS_RATE));
+	for (int i = 1; i < NUM_STATUS_STRINGS; i++)
+		assert(((sent[i] >= 9) && (sent[i] <= 10)) || ((i == 2) && (sent[i] == 0)));     // (No CST on the standalone regulator)
+	assert(bytes / 600.0 < oldRate / 2);                            // Less then half the fixed rotation ..
+	assert(bytes / 600.0 < 960 / 20);                               // .. and less then 1/20th of the link
+
+
+	// Noisy Amps (+/- 2A each reading):  AST more often then once a second, but no more often then STATUS_CHECK_RATE allows.
+	clear_counts();
+	for (unsigned long t = 0; t < 60000UL; t += TICK_MS) {
+		measuredAltAmps = 40.0 + (rand() % 401 - 200) / 100.0;
+		tick();
+		}
+	measuredAltAmps = 40.0;
+	printf("Noisy:  %5.1f bytes/S   AST %lu in a minute\n", bytes / 60.0, sent[0]);
+	assert(sent[0] <= 60000UL / STATUS_CHECK_RATE);
+	assert(sent[0] >  60000UL / UPDATE_STATUS_RATE * 2);
+	assert(bytes / 60.0 < 960 / 2);
+
+
+	// Latency:  against up to OLD_STATUS_RATE for any AST value, and a full round of the fixed rotation for the others.
+	unsigned long worstFast = 0, worstSlow = 0, worstMajor = 0;
+	for (int i = 0; i < 400; i++) {
+		run_for(TICK_MS * (1 + i % 37));                                // Changes land at all points in the check cycle
+
+		measuredAltAmps += (i % 2) ? AST_AMPS_DEADBAND : -AST_AMPS_DEADBAND;
+		worstFast = fmax(worstFast, latency(0));
+
+		run_for(TICK_MS * (1 + i % 13));
+		switch (i % 4) {                                                // The slower moving AST values
+			case 0:  measuredBatTemp  += (i % 8) ? 1 : -1;                        break;
+			case 1:  measuredRPMs     += (i % 8 == 1) ? AST_RPM_DEADBAND : -AST_RPM_DEADBAND; break;
+			case 2:  measuredBatAmps  += (i % 8 == 2) ? AST_AMPS_DEADBAND : -AST_AMPS_DEADBAND; break;
+			case 3:  targetAltAmps    += (i % 8 == 3) ? 1 : -1;                   break;
+			}
+		worstSlow = fmax(worstSlow, latency(0));
+
+		run_for(TICK_MS * (1 + i % 29));
+		altCapAmps += (i % 2) ? 1 : -1;                                 // In the SST
+		worstMajor = fmax(worstMajor, latency(1));
+		}
+	printf("Latency:  fast AST %lu mS   slow AST %lu mS   SST %lu mS   (fixed rotation %lu / %lu / %lu mS)\n", worstFast, worstSlow, worstMajor,
+	       OLD_STATUS_RATE, OLD_STATUS_RATE, OLD_MAJOR_TURNS * OLD_STATUS_RATE);
+	assert(worstFast  <= STATUS_CHECK_RATE + TICK_MS);
+	assert(worstSlow  <= STATUS_CHECK_RATE + TICK_MS);
+	assert(worstFast  <  OLD_STATUS_RATE);
+	assert(worstSlow  <  OLD_STATUS_RATE);
+	assert(worstMajor <  OLD_MAJOR_TURNS * OLD_STATUS_RATE / 10);
+	assert(worstMajor <= (NUM_STATUS_STRINGS - 1) * STATUS_CHECK_RATE + TICK_MS);
+
+
+	// The turns go evenly round, for as long as it runs.
+	for (int i = 0; i < 1000; i++) {
+		uint8_t turn = UMCounter;
+		host_advance(STATUS_CHECK_RATE);
+		send_outbound(false);
+		assert(UMCounter == (turn + 1) % (NUM_STATUS_STRINGS - 1));
+		}
+
+	return 0;
+}
@@ -0,0 +1,123 @@
+// The real AST; and CPE; strings, streamed by prep_AST() / prep_CPE() from ASTFields / CPEFields, against what the snprintf_P()
+// versions they replaced sent for the same values.  (The one intended change:  the 4th CPE field, once a hard coded 0 place holder,
+// is now EXIT_ACPT_DIDT with one decimal)  Then the throughput and stack use of the two ways.
+#include "SimRegulator.h"
+
+#include <time.h>
+
+// Capture streamed output, and track how deep the stack gets below the caller
+static char  captured[512];
+static int   capturedLen;
+static char *stackTop;
+static long  stackPeak;
+
+static void capture(char c) {
+	char here;
+	if (stackTop - &here > stackPeak) stackPeak = stackTop - &here;
+	captured[capturedLen++] = c;
+	captured[capturedLen] = '\0';
+}
+
+static void streamAST(void) {
+	char top;
+	stackTop = &top;
+	capturedLen = 0;
+	prep_AST(capture);
+}
+
+
+// floatString() hands out one of 6 static buffers, so each is copied out before the next call (the old CPE; used 8 in one go)
+#define F(n, v, d)  char n[FIXED_STRING_SIZE + 2];  strcpy(n, floatString(v, d))
+
+static void oldAST(char *buf) {                 // As prep_AST() was, before the field tables
+	F(bv, measuredBatVolts, 2);  F(aa, measuredAltAmps, 1);  F(ba, measuredBatAmps, 1);
+	F(tv, targetBatVolts, 2);    F(av, measuredAltVolts, 2);
+	snprintf(buf, OUTBOUND_BUFF_SIZE, "AST;,%d.%02d, ,%s,%s,%s,%d, ,%s,%d,%d,%d, ,%d,%d, ,%d, ,%s,%d,%d,%d\r\n",
+		(int)  (generatorLrRunTime / (3600UL * 1000UL)),
+		(int) ((generatorLrRunTime / (3600UL * 10UL  )) % 100),
+		bv, aa, ba, measuredAltWatts,
+		tv, (int) targetAltAmps, targetAltWatts, alternatorState,
+		measuredBatTemp, max(measuredAltTemp, measuredAlt2Temp),
+		measuredRPMs,
+		av, measuredFETTemp, measuredFieldAmps, ((100*fieldPWMvalue) / FIELD_PWM_MAX));
+}
+
+static void oldCPE(char *buf, CPS *cpsPtr, int index) {        // As prep_CPE() was, with EXIT_ACPT_DIDT in the old place holder
+	F(acpt, cpsPtr->ACPT_BAT_V_SETPOINT, 2);  F(didt, cpsPtr->EXIT_ACPT_DIDT, 1);      F(ocv, cpsPtr->EXIT_OC_VOLTS, 2);
+	F(flt,  cpsPtr->FLOAT_BAT_V_SETPOINT, 2); F(f2b,  cpsPtr->FLOAT_TO_BULK_VOLTS, 2); F(pf2b, cpsPtr->PF_TO_BULK_VOLTS, 2);
+	F(eq,   cpsPtr->EQUAL_BAT_V_SETPOINT, 2); F(comp, cpsPtr->BAT_TEMP_1C_COMP, 3);
+	snprintf(buf, OUTBOUND_BUFF_SIZE, "CPE;,%d,%s,%d,%d,%s, ,%d,%d,%s,%d, ,%s,%d,%d,%d,%d,%s, ,%d,%s,%d, ,%s,%d,%d,%d, ,%s,%d,%d,%d\r\n",
+		(index + 1), acpt, (unsigned int) (cpsPtr->EXIT_ACPT_DURATION/60000UL), cpsPtr->EXIT_ACPT_AMPS, didt,
+		cpsPtr->LIMIT_OC_AMPS, (unsigned int) (cpsPtr->EXIT_OC_DURATION/60000UL), ocv, 0,
+		flt, cpsPtr->LIMIT_FLOAT_AMPS, (unsigned int) (cpsPtr->EXIT_FLOAT_DURATION/60000UL), cpsPtr->FLOAT_TO_BULK_AMPS, cpsPtr->FLOAT_TO_BULK_AHS, f2b,
+		(unsigned int) (cpsPtr->EXIT_PF_DURATION/60000UL), pf2b, cpsPtr->PF_TO_BULK_AHS,
+		eq, cpsPtr->LIMIT_EQUAL_AMPS, (unsigned int) (cpsPtr->EXIT_EQUAL_DURATION/60000UL), cpsPtr->EXIT_EQUAL_AMPS,
+		comp, cpsPtr->MIN_TEMP_COMP_LIMIT, cpsPtr->BAT_MIN_CHARGE_TEMP, cpsPtr->BAT_MAX_CHARGE_TEMP);
+}
+
+
+int main(int argc, char *argv[]) {
+	char expected[OUTBOUND_BUFF_SIZE + 1];
+
+	// AST;  over a spread of values, including negative Amps and temps
+	for (long i = 0; i < 50000; i += 7) {
+		generatorLrRunTime = i * 3777UL;
+		measuredBatVolts   = 11.0f + i / 4000.0f;
+		measuredAltAmps    = i / 211.0f - 100.0f;
+		measuredBatAmps    = 50.0f - i / 307.0f;
+		measuredAltWatts   = i / 3 - 2000;
+		targetBatVolts     = 14.4f - i / 10000.0f;
+		targetAltAmps      = i / 331.0f;
+		targetAltWatts     = i / 5;
+		alternatorState    = (tModes) (i % 15);
+		measuredBatTemp    = (i % 140) - 40;
+		measuredAltTemp    = (i % 120) - 20;
+		measuredAlt2Temp   = (i % 97) - 20;
+		measuredRPMs       = i / 5;
+		measuredAltVolts   = 12.0f + i / 5000.0f;
+		measuredFETTemp    = (i % 80) - 10;
+		measuredFieldAmps  = i % 13;
+		fieldPWMvalue      = i % (FIELD_PWM_MAX + 1);
+
+		streamAST();
+		oldAST(expected);
+		assert(strcmp(captured, expected) == 0);
+	}
+
+	// CPE;  every default profile, and the same again with the values moved about
+	for (int pass = 0; pass < 2; pass++)
+		for (int n = 0; n < MAX_CPES; n++) {
+			CPS cp;
+			transfer_default_CPS(n, &cp);
+			if (pass) {
+				cp.ACPT_BAT_V_SETPOINT += 0.37f;   cp.EXIT_ACPT_DURATION += 59999UL;  cp.EXIT_ACPT_AMPS = -1;
+				cp.EXIT_ACPT_DIDT       = 2.5f;    cp.LIMIT_OC_AMPS      = 7;         cp.EXIT_OC_VOLTS  = 15.45f;
+				cp.FLOAT_TO_BULK_AHS    = 20 * n;  cp.PF_TO_BULK_VOLTS   = 12.65f;    cp.BAT_TEMP_1C_COMP = -0.024f;
+				}
+			capturedLen = 0;
+			prep_CPE(capture, &cp, n);
+			oldCPE(expected, &cp, n);
+			assert(strcmp(captured, expected) == 0);
+			}
+
+	// throughput and stack use
+	long   bytes = 0;
+	clock_t start = clock();
+	for (long i = 0; i < 200000; i++) {
+		measuredAltAmps = i / 211.0f;
+		streamAST();
+		bytes += capturedLen;
+	}
+	double streamSecs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	start = clock();
+	for (long i = 0; i < 200000; i++) {
+		measuredAltAmps = i / 211.0f;
+		oldAST(expected);
+	}
+	double snprintfSecs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("streamed: %.0f bytes/s, snprintf: %.0f bytes/s\n", bytes / streamSecs, bytes / snprintfSecs);
+	printf("streamed peak stack below caller: %ld bytes (snprintf path needs a %d byte buffer alone)\n", stackPeak, OUTBOUND_BUFF_SIZE);
+	printf("All tests passed.\n");
+}
@@ -0,0 +1,93 @@
+#include "../SmartRegulator/Types.h"
+#include "../SmartRegulator/Types.cpp"
+
+#include <cassert>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Feed the argument string through the tokenizer, as fill_ib_buffer() would
+static void tokenize(tTokens *t, char *buf, const char *args) {
+	token_reset(t);
+	for (uint8_t i = 0; args[i]; i++) {
+		buf[i]     = token_add(t, i, args[i]);
+		buf[i + 1] = '\0';
+	}
+}
+
+// Check the tokenizer against what strtok() / atoi() / atof() make of the same argument string.
+static void check(const char *args) {
+	char    buf[64], ref[64];
+	tTokens t;
+	uint8_t n = 0;
+	long    v;
+	float   f;
+
+	tokenize(&t, buf, args);
+
+	strcpy(ref, args);
+	for (char *cp = strtok(ref, ","); (cp != NULL) && (n < MAX_TOKENS); cp = strtok(NULL, ","), n++) {
+		assert(n < t.count);
+		assert(token_scaled(&t, n, 0, &v) && (v == atoi(cp)));
+		assert(token_float(&t, n, &f));
+		float expect = (float)atof(cp);
+		assert(fabsf(f - expect) <= 1e-6f * fmaxf(1.0f, fabsf(expect)));
+		assert(strcmp(buf + t.start[n], cp) == 0);
+	}
+	assert(n == t.count);
+	assert(!token_scaled(&t, n, 0, &v));
+}
+
+int main(int argc, char *argv[]) {
+	char    buf[64];
+	tTokens t;
+	long    v;
+
+	// the commands as sent by the HUI programs
+	check("7,14.4,180,15,0");
+	check("0,50,0.05,0.3,0.3,4,-1,-1,3333,0,1100");
+	check("1,My Regulator,MyPassword");
+	check("-12.5");
+	check(",,1,,2,");
+	check(" +3. ,-.25,  x9,5-3,--1,1.2.3");
+
+	// scaled fetches truncate or pad the same way for whole and fractional parts
+	tokenize(&t, buf, "14.456,-0.5,12");
+	assert(token_scaled(&t, 0, 2, &v) && (v == 1445));
+	assert(token_scaled(&t, 1, 3, &v) && (v == -500));
+	assert(token_scaled(&t, 2, 1, &v) && (v == 120));
+	assert(token_scaled(&t, 1, 0, &v) && (v == 0));
+
+	// random and partial command streams
+	const char alphabet[] = "0123456789012345678901234567890123456789.,,,,-+ ab\r";
+	char args[48];
+	srand(1);
+	for (long run = 0; run < 200000; run++) {
+		int len = rand() % (sizeof(args) - 1);
+		int since = 0;
+		for (int i = 0; i < len; i++) {
+			args[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+			since = (args[i] == ',') ? 0 : since + 1;
+			if (since > 8)                  // Keep each field short enough that atoi() cannot overflow
+				args[i] = ',', since = 0;
+		}
+		args[len] = '\0';
+		check(args);
+		args[rand() % (len + 1)] = '\0';        // And a command cut off part way
+		check(args);
+	}
+
+	// Every character costs the same bounded work, there is no re-scanning
+	const char *sca = "0,50,0.05,0.3,0.3,4,-1,-1,3333,0,1100";
+	long    chars = 0;
+	clock_t start = clock();
+	for (long i = 0; i < 1000000; i++) {
+		tokenize(&t, buf, sca);
+		chars += strlen(sca);
+	}
+	double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+	printf("tokenizer: %.1f ns per character\n", secs * 1e9 / chars);
+
+	printf("All tests passed.\n");
+}
@@ -4,6 +4,34 @@
 #include <cassert>
 #include <string.h>
 
+// The original snprintf() based formatter, kept here as the reference for byte-identical output.
+static char *legacyFloatString(float v, unsigned char decimals) {
+	static char outputBuffers[6][14];
+	static int callCount = 0;
+
+	char *pos = outputBuffers[++callCount % 6];
+	char *opos = pos;
+	if (v < 0) {
+		*(opos++) = '-';
+		v = -v;
+	}
+	int mult = 1;
+	int multleft = decimals;
+	while(multleft--) {
+		mult *= 10;
+	}
+	char format[9];
+	snprintf(format, 9, "%%d.%%0%dd", decimals);
+	snprintf(opos, 13, format, (int)v, (int)((v - (int)v) * mult));
+	return pos;
+}
+
+// Build an AST style line (the float fields of prep_AST/SST/CPE) with the passed formatter.
+static void prepLine(char *buf, char *(*fmt)(float, unsigned char), float bv, float aa, float ba, float tv, float av) {
+	snprintf(buf, 200, "AST;,%d.%02d, ,%s,%s,%s,%d, ,%s,%d, ,%s,%s\r\n",
+		3, 7, fmt(bv, 2), fmt(aa, 1), fmt(ba, 1), 1234, fmt(tv, 2), 8, fmt(av, 2), fmt(av / 1000.0f, 3));
+}
+
 int main(int argc, char *argv[]) {
 	struct {
 		float value;
@@ -22,6 +50,41 @@ int main(int argc, char *argv[]) {
 		assert(strcmp(floatString(tests[t].value, tests[t].precision), tests[t].expected) == 0);
 	}
 
+	// fixed point formatter works from scaled integers
+	struct {
+		long value;
+		unsigned char precision;
+		const char *expected;
+	} fixed[] = {
+		{14123, 3, "14.123"},
+		{-5, 2, "-0.05"},
+		{0, 1, "0.0"},
+		{1000, 3, "1.000"},
+		{42, 0, "42"},
+		{-2147483647L, 2, "-21474836.47"}
+	};
+	char buf[FIXED_STRING_SIZE];
+	for ( int t = 0; t < sizeof(fixed)/sizeof(fixed[0]); t++) {
+		assert(strcmp(fixedString(buf, fixed[t].value, fixed[t].precision), fixed[t].expected) == 0);
+	}
+
+	// new formatter is byte-identical to the old one over the ranges we send
+	for (long i = -60000; i <= 60000; i += 7) {
+		float v = i / 997.0f;
+		for (unsigned char d = 1; d <= 3; d++) {
+			assert(strcmp(floatString(v, d), legacyFloatString(v, d)) == 0);
+		}
+	}
+
+	// and so are whole status lines
+	char newLine[200], oldLine[200];
+	for (long i = 0; i < 20000; i += 13) {
+		float bv = 10.0f + i / 1000.0f, aa = i / 77.0f - 50.0f, tv = 14.4f - i / 9000.0f;
+		prepLine(newLine, floatString, bv, aa, -aa, tv, bv + 0.123f);
+		prepLine(oldLine, legacyFloatString, bv, aa, -aa, tv, bv + 0.123f);
+		assert(strcmp(newLine, oldLine) == 0);
+	}
+
 	// we don't return the same pointer over and over again
 	// so the data is in a different buffer each time
 	assert(floatString(1.1, 1) != floatString(1.1, 1));